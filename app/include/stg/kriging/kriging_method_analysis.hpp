@@ -4,6 +4,7 @@
 #include <iostream>
 #include <statistics/space_covariation.hpp>
 #include <velocity_field/velocity_samples.hpp>
+#include <velocity_field/vertex_major_samples.hpp>
 #include "data_loader.hpp"
 
 namespace stg::kriging {
@@ -42,14 +43,14 @@ using namespace stg::statistics;
       const auto lin_center_index = real_space_mesh_->center_lin_index();
 
       try {
-        for (const size_t ivert: rv::iota(0ull, real_space_mesh_->n_vertices())) {
-          auto vertex_velocity_sample_x = velocity_samples_.vx_component_for_vertex(ivert);
-          auto vertex_velocity_sample_y = velocity_samples_.vy_component_for_vertex(ivert);
-          auto vertex_velocity_sample_z = velocity_samples_.vz_component_for_vertex(ivert);
+        const auto center_velocity_sample_x = velocity_samples_.vx_component_for_vertex(lin_center_index);
+        const auto center_velocity_sample_y = velocity_samples_.vy_component_for_vertex(lin_center_index);
+        const auto center_velocity_sample_z = velocity_samples_.vz_component_for_vertex(lin_center_index);
 
-          auto center_velocity_sample_x = velocity_samples_.vx_component_for_vertex(lin_center_index);
-          auto center_velocity_sample_y = velocity_samples_.vy_component_for_vertex(lin_center_index);
-          auto center_velocity_sample_z = velocity_samples_.vz_component_for_vertex(lin_center_index);
+        for (const size_t ivert: rv::iota(0ull, real_space_mesh_->n_vertices())) {
+          const auto vertex_velocity_sample_x = velocity_samples_.vx_component_for_vertex(ivert);
+          const auto vertex_velocity_sample_y = velocity_samples_.vy_component_for_vertex(ivert);
+          const auto vertex_velocity_sample_z = velocity_samples_.vz_component_for_vertex(ivert);
 
           // Assumes that fluctuations has zero mean
           auto &&covariance = SpaceCovariance::covariance_tensor(center_velocity_sample_x, vertex_velocity_sample_x,
@@ -72,7 +73,8 @@ using namespace stg::statistics;
     const std::shared_ptr<CubeFiniteElementsMesh<value_type>> fourier_space_mesh_;
     const std::vector<Tensor<value_type>> covariations_;
     const std::vector<Tensor<value_type>> fert_values_;
-    VelocitySamples<value_type> velocity_samples_;
+    // Unit stride ensembles of the vertices, transposed once on loading
+    const VertexMajorSamples<value_type> velocity_samples_;
 
     std::vector<Tensor<value_type>> calc_covariations_;
     std::vector<Tensor<value_type>> calc_fert_values_;
@@ -1,7 +1,10 @@
 #ifndef STG_SPECTRAL_METHOD_COMMON_HPP
 #define STG_SPECTRAL_METHOD_COMMON_HPP
 
+#include "spectral_method/async_field_writer.hpp"
+#include "spectral_method/distributed_ensemble.hpp"
 #include "spectral_method/i_spectral_method.hpp"
+#include "spectral_method/inflow_plane.hpp"
 #include "spectral_method/kraichnan_method_impl.hpp"
 #include "spectral_method/spectral_method_impl.hpp"
 
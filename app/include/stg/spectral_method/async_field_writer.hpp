@@ -0,0 +1,219 @@
+#ifndef STG_SPECTRAL_METHOD_ASYNC_FIELD_WRITER_HPP
+#define STG_SPECTRAL_METHOD_ASYNC_FIELD_WRITER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <memory>
+#include <mesh_builders.hpp>
+#include <mutex>
+#include <rtable/cube_vtk_saver.hpp>
+#include <rtable/vtr_saver.hpp>
+#include <stdexcept>
+#include <stg_thread_pool.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <velocity_field/velocity_field.hpp>
+
+namespace stg::spectral {
+    using namespace stg::mesh;
+    using namespace stg::field;
+
+    // Backend saving a velocity field to a file, called from the writer thread
+    template<std::floating_point T>
+    class IFieldFormat {
+    public:
+        virtual ~IFieldFormat() = default;
+
+        virtual void write(const VelocityField<T>& field, const std::filesystem::path& path, std::string_view table_name) const = 0;
+    };
+
+    // Legacy rectilinear grid, ASCII or big endian binary
+    template<std::floating_point T>
+    class VtkFieldFormat final : public IFieldFormat<T> {
+    public:
+        VtkFieldFormat(std::shared_ptr<CubeRelationTable<T>> rtable, VtkFormat format = VtkFormat::ascii)
+            : rtable_{std::move(rtable)}, format_{format} {}
+
+        void write(const VelocityField<T>& field, const std::filesystem::path& path, std::string_view table_name) const override {
+            VtkRectilinearGridSaver saver{path.string(), format_};
+            saver.template save_mesh<T>(rtable_);
+            saver.save_vector_data(field.values_view(), table_name);
+        }
+
+    private:
+        std::shared_ptr<CubeRelationTable<T>> rtable_;
+        VtkFormat format_;
+    };
+
+    // XML rectilinear grid with the raw appended arrays
+    template<std::floating_point T>
+    class VtrFieldFormat final : public IFieldFormat<T> {
+    public:
+        explicit VtrFieldFormat(std::shared_ptr<CubeRelationTable<T>> rtable)
+            : rtable_{std::move(rtable)} {}
+
+        void write(const VelocityField<T>& field, const std::filesystem::path& path, std::string_view table_name) const override {
+            VtrRectilinearGridSaver saver{path.string()};
+            saver.template save_mesh<T>(rtable_);
+            saver.save_velocity_data(field.values_view(), table_name);
+            saver.close();
+        }
+
+    private:
+        std::shared_ptr<CubeRelationTable<T>> rtable_;
+    };
+
+    // The component arrays vx, vy, vz one after another in the machine byte order, no header
+    template<std::floating_point T>
+    class RawFieldFormat final : public IFieldFormat<T> {
+    public:
+        void write(const VelocityField<T>& field, const std::filesystem::path& path, std::string_view) const override {
+            std::ofstream file{path, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary};
+            for (std::size_t axis = 0; axis < 3; ++axis) {
+                const auto component = field.component(axis);
+                file.write(reinterpret_cast<const char*>(component.data()), static_cast<std::streamsize>(component.size_bytes()));
+            }
+            if (!file) {
+                throw std::runtime_error(fmt::format("Field isn't written to {}", path.string()));
+            }
+        }
+    };
+
+    /*
+     * Saves the fields on its own I/O thread through a ring of preallocated field buffers:
+     * the producer acquires a free buffer, fills it and submits it, the thread writes the
+     * submitted buffers in order with the format and frees them. So the generation of the
+     * next field overlaps the write of the previous one, and with every buffer waiting for
+     * the disk acquire blocks (backpressure) instead of allocating more.
+     * A failed write is rethrown by the next acquire or flush, the later writes go on
+     */
+    template<std::floating_point T>
+    class AsyncFieldWriter final {
+    public:
+        using value_type = T;
+
+        struct Frame {
+            VelocityField<value_type> field;
+            std::filesystem::path path;
+            std::string table_name;
+        };
+
+        AsyncFieldWriter(std::shared_ptr<const IFieldFormat<value_type>> format, std::size_t vertices, std::size_t buffers = 2)
+            : format_{std::move(format)}, frames_(std::max<std::size_t>(1, buffers)),
+              free_{frames_.size()}, submitted_{frames_.size()}, origin_{std::chrono::steady_clock::now()} {
+            for (std::size_t index = 0; index < frames_.size(); ++index) {
+                frames_[index].field.resize(vertices);
+                free_.push(index);
+            }
+            thread_ = std::thread{[this] { write_submitted(); }};
+        }
+
+        AsyncFieldWriter(const AsyncFieldWriter&) = delete;
+        AsyncFieldWriter& operator=(const AsyncFieldWriter&) = delete;
+
+        // Writes the frames submitted, the errors are lost
+        ~AsyncFieldWriter() {
+            submitted_.close();
+            thread_.join();
+        }
+
+        // Free buffer to fill, waits while all of them are submitted
+        Frame& acquire() {
+            rethrow();
+            auto index = free_.try_pop();
+            if (!index) {
+                ++stalls_;
+                index = free_.pop();
+            }
+            return frames_[*index];
+        }
+
+        // Queues the acquired buffer for the write to path
+        void submit(Frame& frame, std::filesystem::path path, std::string table_name) {
+            frame.path = std::move(path);
+            frame.table_name = std::move(table_name);
+            ++submits_;
+            submitted_.push(static_cast<std::size_t>(&frame - frames_.data()));
+        }
+
+        // Waits for the writes of the frames submitted
+        void flush() {
+            for (std::size_t written = written_.load(std::memory_order_acquire); written != submits_;
+                 written = written_.load(std::memory_order_acquire)) {
+                written_.wait(written, std::memory_order_acquire);
+            }
+            rethrow();
+        }
+
+        // Number of acquire calls that waited for the disk
+        [[nodiscard]] std::size_t stalls() const noexcept { return stalls_; }
+
+        [[nodiscard]] std::chrono::steady_clock::time_point origin() const noexcept { return origin_; }
+
+        // Timings of the writes from origin, in the order of submit
+        [[nodiscard]] std::vector<utility::StageTiming> timings() const {
+            std::lock_guard lock{mutex_};
+            return timings_;
+        }
+
+    private:
+        std::shared_ptr<const IFieldFormat<value_type>> format_;
+        std::vector<Frame> frames_;
+        utility::BoundedQueue<std::size_t> free_;
+        utility::BoundedQueue<std::size_t> submitted_;
+        const std::chrono::steady_clock::time_point origin_;
+        std::size_t submits_ = 0;
+        std::size_t stalls_ = 0;
+        std::atomic<std::size_t> written_{0};
+        mutable std::mutex mutex_;
+        std::exception_ptr exception_;
+        std::vector<utility::StageTiming> timings_;
+        std::thread thread_;
+
+        void write_submitted() {
+            while (const auto index = submitted_.pop()) {
+                Frame& frame = frames_[*index];
+                const auto start = std::chrono::steady_clock::now();
+                try {
+                    format_->write(frame.field, frame.path, frame.table_name);
+                } catch (...) {
+                    std::lock_guard lock{mutex_};
+                    if (!exception_) { exception_ = std::current_exception(); }
+                }
+                const auto end = std::chrono::steady_clock::now();
+                {
+                    std::lock_guard lock{mutex_};
+                    timings_.push_back({.name = fmt::format("write {}", frame.path.string()),
+                                        .start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin_),
+                                        .duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)});
+                }
+                free_.push(*index);
+                written_.fetch_add(1, std::memory_order_acq_rel);
+                written_.notify_all();
+            }
+        }
+
+        void rethrow() {
+            std::exception_ptr exception;
+            {
+                std::lock_guard lock{mutex_};
+                exception = std::exchange(exception_, nullptr);
+            }
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+    };
+}// namespace stg::spectral
+
+#endif//STG_SPECTRAL_METHOD_ASYNC_FIELD_WRITER_HPP
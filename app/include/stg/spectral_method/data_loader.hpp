@@ -4,10 +4,14 @@
 #include "geometry/geometry.hpp"
 #include <filesystem>
 #include <fmt/core.h>
+#include <optional>
 #include <mesh_builders.hpp>
+#include <rtable/vtk_data_type.hpp>
 #include <statistics.hpp>
 #include <string_view>
 #include <utility>
+#include <vector>
+#include <velocity_field/sample_store.hpp>
 #include <velocity_field/velocity_field.hpp>
 #include <velocity_field/velocity_samples.hpp>
 #include <velocity_field/velocity_samples_1d.hpp>
@@ -40,8 +44,9 @@ namespace stg::spectral {
         VelocityField<T> load_velocity_field(std::string_view filename) const {
             const std::string full_filename = fmt::format("{}{}", work_dir_.string(), filename);
             RectilinearGridParser parser{full_filename};
-            auto&& velocities_vector = parser.vector_data<T>("VECTORS VelocityField double");
-            return VelocityField<T>{std::move(velocities_vector)};
+            const std::string header = fmt::format("VECTORS VelocityField {}", mesh::vtk_data_type<T>());
+            auto [vx, vy, vz] = parser.vector_components<T>(header);
+            return VelocityField<T>{std::move(vx), std::move(vy), std::move(vz)};
         }
 
         template<std::floating_point T>
@@ -86,21 +91,53 @@ namespace stg::spectral {
                 const bool is_velocity_field_file = entry.path().filename().string().starts_with("sg3");
                 if (is_velocity_field_file) {
                     RectilinearGridParser parser{entry.path().string()};
-                    const auto file_field = parser.vector_data<T>();
-                    std::vector<T> vx, vy, vz;
-                    for (const auto [vx_v, vy_v, vz_v]: rv::transform(file_field, [](const auto& val) {
-                             return std::make_tuple(val.template get<0>(), val.template get<1>(), val.template get<2>());
-                         })) {
-                        vx.emplace_back(vx_v);
-                        vy.emplace_back(vy_v);
-                        vz.emplace_back(vz_v);
-                    }
+                    auto [vx, vy, vz] = parser.vector_components<T>();
                     samples.emplace_back(std::move(vx), std::move(vy), std::move(vz));
                 }
             }
             return VelocitySamples<T>{std::move(samples)};
         }
 
+        /*
+         * Parses the sg3 files once into a sample store in the directory, in the order of
+         * the file names, the later runs read only the bytes they need from the store
+         */
+        template<std::floating_point T>
+        std::size_t pack_velocity_samples(std::string_view store_filename,
+                                          SamplePrecision precision = SamplePrecision::float64) const {
+            std::vector<fs::path> files;
+            for (const auto& entry: fs::directory_iterator(work_dir_)) {
+                if (entry.path().filename().string().starts_with("sg3")) {
+                    files.push_back(entry.path());
+                }
+            }
+            std::sort(files.begin(), files.end());
+
+            std::optional<SampleStoreWriter<T>> writer;
+            for (const auto& file: files) {
+                RectilinearGridParser parser{file.string()};
+                if (!writer) {
+                    const auto grid = parser.mesh<T>();
+                    writer.emplace(work_dir_ / store_filename, grid->vertices().size(), 2 * std::fabs(grid->vertices().front()), precision);
+                }
+                const auto [vx, vy, vz] = parser.vector_components<T>();
+                writer->append(vx, vy, vz);
+            }
+            return files.size();
+        }
+
+        // All the samples of a store copied to memory, the vertex ranges are read from open_sample_store
+        template<std::floating_point T>
+        VelocitySamples<T> load_velocity_samples(std::string_view store_filename) const {
+            return open_sample_store<T>(store_filename).samples();
+        }
+
+        // Store of pack_velocity_samples, its (sample, vertex range) blocks are read on demand
+        template<std::floating_point T>
+        SampleStore<T> open_sample_store(std::string_view store_filename) const {
+            return SampleStore<T>{work_dir_ / store_filename};
+        }
+
         template<std::floating_point T>
         VelocitySamples1D<T> load_velocity_samples_1sg() const {
             std::vector<VelocityField1D<T>> samples;
@@ -0,0 +1,150 @@
+#ifndef STG_SPECTRAL_METHOD_DISTRIBUTED_ENSEMBLE_HPP
+#define STG_SPECTRAL_METHOD_DISTRIBUTED_ENSEMBLE_HPP
+
+#include "sample_realization.hpp"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <fem.hpp>
+#include <mesh_builders.hpp>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <statistics.hpp>
+#include <stg_distributed.hpp>
+#include <stg_tensor/tensor.hpp>
+#include <stg_thread_pool.hpp>
+#include <vector>
+
+namespace stg::spectral {
+    using namespace stg::mesh;
+    using namespace stg::statistics;
+
+    /*
+     * Ensemble statistics over the ranks of a distributed run without keeping the samples:
+     * the samples are split into blocks of samples_block, a block gives the per vertex
+     * moments of its samples and the blocks are merged over the fixed tree of
+     * utility::tree_reduce. A sample is the realization of SpectralMethodApplicationImpl
+     * with the same seed (its own counter based streams), so a rank only draws from the
+     * streams of its samples and the moments are bit for bit the same for any number of
+     * ranks and threads
+     */
+    template<std::floating_point T, std::size_t seed = 42>
+    class DistributedEnsemble final {
+    public:
+        using value_type = T;
+
+        DistributedEnsemble(std::shared_ptr<const CubeFiniteElementsMesh<T>> mesh,
+                            SpectralGeneratorConfig<T> config,
+                            std::size_t samples_amount,
+                            std::size_t samples_block = 8)
+            : fe_mesh_{std::move(mesh)}, generator_config_{std::move(config)},
+              samples_amount_{samples_amount}, samples_block_{samples_block} {
+            if (samples_amount_ == 0 || samples_block_ == 0) {
+                throw std::invalid_argument("Ensemble needs samples");
+            }
+        }
+
+        // Per vertex moments of the ensemble on the rank 0, none on the other ranks
+        std::optional<std::vector<SampleMoments>> moments(utility::ICommunicator& communicator, value_type time,
+                                                          utility::ThreadPool& pool) const {
+            return utility::tree_reduce<SampleMoments>(
+                    communicator, blocks(), fe_mesh_->n_vertices(),
+                    [&](std::size_t block) { return block_moments(block, time, pool); },
+                    merge);
+        }
+
+        std::vector<SampleMoments> moments(value_type time, utility::ThreadPool& pool = utility::ThreadPool::global()) const {
+            return utility::tree_reduce<SampleMoments>(
+                    blocks(), [&](std::size_t block) { return block_moments(block, time, pool); }, merge);
+        }
+
+        static std::vector<std::array<double, 3>> means(const std::vector<SampleMoments>& moments) {
+            std::vector<std::array<double, 3>> result(moments.size());
+            std::ranges::transform(moments, result.begin(), mean);
+            return result;
+        }
+
+        static std::vector<Tensor<value_type>> covariance_tensors(const std::vector<SampleMoments>& moments) {
+            std::vector<Tensor<value_type>> result;
+            result.reserve(moments.size());
+            for (const auto& vertex: moments) {
+                result.push_back(Moments::covariance_tensor<value_type>(vertex, mean(vertex)));
+            }
+            return result;
+        }
+
+        static std::vector<Tensor<value_type>> correlation_tensors(const std::vector<SampleMoments>& moments) {
+            std::vector<Tensor<value_type>> result;
+            result.reserve(moments.size());
+            for (const auto& vertex: moments) {
+                const auto means = mean(vertex);
+                const std::array<double, 3> stds{vertex.std(0, means[0]), vertex.std(1, means[1]), vertex.std(2, means[2])};
+                result.push_back(Moments::correlation_tensor<value_type>(vertex, means, stds));
+            }
+            return result;
+        }
+
+        [[nodiscard]] std::size_t blocks() const noexcept {
+            return (samples_amount_ + samples_block_ - 1) / samples_block_;
+        }
+
+        [[nodiscard]] std::size_t samples_amount() const noexcept { return samples_amount_; }
+
+    private:
+        static constexpr std::size_t vertices_chunk = SampleRealization<T, seed>::vertices_chunk;
+
+        const std::shared_ptr<const CubeFiniteElementsMesh<value_type>> fe_mesh_;
+        const SpectralGeneratorConfig<value_type> generator_config_;
+        const std::size_t samples_amount_;
+        const std::size_t samples_block_;
+
+        static void merge(std::vector<SampleMoments>& left, const std::vector<SampleMoments>& right) {
+            for (std::size_t ivert = 0; ivert < left.size(); ++ivert) {
+                left[ivert] += right[ivert];
+            }
+        }
+
+        static std::array<double, 3> mean(const SampleMoments& moments) {
+            return {moments.mean(0), moments.mean(1), moments.mean(2)};
+        }
+
+        /*
+         * Moments of the samples of a block, the vertices chunks are spread over the pool
+         * and every vertex adds the samples in their order
+         */
+        std::vector<SampleMoments> block_moments(std::size_t block, value_type time, utility::ThreadPool& pool) const {
+            const std::size_t first_sample = block * samples_block_;
+            const std::size_t last_sample = std::min(first_sample + samples_block_, samples_amount_);
+            const std::size_t n_vertices = fe_mesh_->n_vertices();
+            const std::size_t chunks = (n_vertices + vertices_chunk - 1) / vertices_chunk;
+
+            std::vector<SampleMoments> result(n_vertices);
+            utility::parallel_for(pool, 0, chunks, 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t ichunk = begin; ichunk < end; ++ichunk) {
+                    const std::size_t first_vertex = ichunk * vertices_chunk;
+                    const std::size_t last_vertex = std::min(first_vertex + vertices_chunk, n_vertices);
+                    std::vector<Point<value_type>> vertices(last_vertex - first_vertex);
+                    std::vector<Vector<value_type>> velocities(last_vertex - first_vertex);
+                    for (std::size_t ivert = first_vertex; ivert < last_vertex; ++ivert) {
+                        vertices[ivert - first_vertex] = fe_mesh_->relation_table()->vertex(ivert);
+                    }
+                    for (std::size_t isample = first_sample; isample < last_sample; ++isample) {
+                        const SampleRealization<value_type, seed> realization{generator_config_, isample, ichunk, chunks};
+                        realization.generator().evaluate(vertices, time, velocities);
+                        for (std::size_t ivert = first_vertex; ivert < last_vertex; ++ivert) {
+                            const auto& v = velocities[ivert - first_vertex];
+                            result[ivert].add({static_cast<double>(v.template get<0>()),
+                                               static_cast<double>(v.template get<1>()),
+                                               static_cast<double>(v.template get<2>())});
+                        }
+                    }
+                }
+            });
+            return result;
+        }
+    };
+}// namespace stg::spectral
+
+#endif
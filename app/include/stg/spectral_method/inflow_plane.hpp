@@ -0,0 +1,177 @@
+#ifndef STG_INFLOW_PLANE_HPP
+#define STG_INFLOW_PLANE_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <exception>
+#include <geometry/geometry.hpp>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <stg_generators.hpp>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace stg::spectral {
+    using namespace stg::generators;
+
+    /*
+     * Inflow boundary condition for a solver: velocities on an arbitrary list of face
+     * points at the times time, time + time_step, ... for an unbounded number of steps.
+     * The generator state stays hot in a PhasorTimeStepper, a dedicated worker thread
+     * computes the step n + 1 into the second buffer while the solver uses the step n,
+     * so next() only waits when the solver is faster than the generator.
+     * Every step costs the same (no allocations, a fixed amount of work per point),
+     * wait and compute times of the steps are reported by latency()
+     */
+    template<std::floating_point T>
+    class InflowPlaneGenerator final {
+    public:
+        using value_type = T;
+        using clock = std::chrono::steady_clock;
+
+        struct Frame final {
+            std::span<const Vector<value_type>> velocities;
+            value_type time;
+            std::size_t step;
+        };
+
+        struct Latency final {
+            clock::duration last_wait{};
+            clock::duration max_wait{};
+            clock::duration last_compute{};
+            clock::duration max_compute{};
+        };
+
+        explicit InflowPlaneGenerator(PhasorTimeStepper<value_type> stepper)
+            : stepper_{std::move(stepper)} {
+            for (auto& buffer: buffers_) {
+                buffer.resize(stepper_.size());
+            }
+            worker_ = std::jthread{[this](std::stop_token stop) { run(stop); }};
+        }
+
+        /*
+         * Spectral generator of the parameters and the spectrum, the cube related
+         * parameters (edge_points, cube_edge_len, save_data_dir_path) are not used
+         */
+        InflowPlaneGenerator(const SpectralParameters<value_type>& parameters,
+                             std::shared_ptr<ISpectra<value_type>> spectra,
+                             std::vector<Point<value_type>> points,
+                             value_type time, value_type time_step,
+                             std::size_t memory_budget = PhasorTimeStepper<value_type>::default_memory_budget)
+            : InflowPlaneGenerator{make_stepper(parameters, std::move(spectra), std::move(points),
+                                                time, time_step, memory_budget)} {}
+
+        InflowPlaneGenerator(const InflowPlaneGenerator&) = delete;
+        InflowPlaneGenerator& operator=(const InflowPlaneGenerator&) = delete;
+
+        ~InflowPlaneGenerator() {
+            worker_.request_stop();
+            free_.notify_all();
+        }
+
+        std::size_t size() const noexcept { return stepper_.size(); }
+
+        /*
+         * Velocities of the next step. The frame is valid until the following call,
+         * errors of the worker are rethrown here
+         */
+        Frame next() {
+            const auto wait_start = clock::now();
+            std::unique_lock lock{mutex_};
+            ready_.wait(lock, [this] { return computed_ > consumed_ || error_; });
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+            const std::size_t step = consumed_++;
+            latency_.last_wait = clock::now() - wait_start;
+            latency_.max_wait = std::max(latency_.max_wait, latency_.last_wait);
+            lock.unlock();
+            free_.notify_one();
+
+            const std::size_t slot = step % buffers_.size();
+            return {buffers_[slot], times_[slot], step};
+        }
+
+        Latency latency() const {
+            std::scoped_lock lock{mutex_};
+            return latency_;
+        }
+
+    private:
+        PhasorTimeStepper<value_type> stepper_;
+        std::array<std::vector<Vector<value_type>>, 2> buffers_;
+        std::array<value_type, 2> times_{};
+
+        mutable std::mutex mutex_;
+        std::condition_variable ready_;
+        std::condition_variable_any free_;
+        // The step s is written to buffers_[s % 2] once s <= consumed_,
+        // i.e. when the buffer of the step s - 2 is released by the solver
+        std::size_t computed_ = 0;
+        std::size_t consumed_ = 0;
+        std::exception_ptr error_;
+        Latency latency_;
+
+        std::jthread worker_;
+
+        void run(std::stop_token stop) {
+            while (true) {
+                std::size_t slot;
+                {
+                    std::unique_lock lock{mutex_};
+                    if (!free_.wait(lock, stop, [this] { return computed_ <= consumed_; })) {
+                        return;
+                    }
+                    slot = computed_ % buffers_.size();
+                }
+
+                const auto compute_start = clock::now();
+                try {
+                    times_[slot] = stepper_.time();
+                    stepper_.step(buffers_[slot]);
+                } catch (...) {
+                    {
+                        std::scoped_lock lock{mutex_};
+                        error_ = std::current_exception();
+                    }
+                    ready_.notify_one();
+                    return;
+                }
+                const auto compute_time = clock::now() - compute_start;
+
+                {
+                    std::scoped_lock lock{mutex_};
+                    ++computed_;
+                    latency_.last_compute = compute_time;
+                    latency_.max_compute = std::max(latency_.max_compute, compute_time);
+                }
+                ready_.notify_one();
+            }
+        }
+
+        static PhasorTimeStepper<value_type> make_stepper(const SpectralParameters<value_type>& parameters,
+                                                          std::shared_ptr<ISpectra<value_type>> spectra,
+                                                          std::vector<Point<value_type>> points,
+                                                          value_type time, value_type time_step,
+                                                          std::size_t memory_budget) {
+            if (points.empty()) {
+                throw std::invalid_argument("Inflow plane has no points");
+            }
+            SpectralGeneratorV2<value_type> generator{parameters};
+            generator.initialize_spectra(std::move(spectra));
+            generator.initialize_wave_vector_amplitudes(parameters.k_min, parameters.k_max, parameters.n_spectra);
+            generator.initialize_random_coefficients();
+            generator.initialize_inner_generators();
+            return generator.time_stepper(std::move(points), time, time_step, memory_budget);
+        }
+    };
+}// namespace stg::spectral
+
+#endif//STG_INFLOW_PLANE_HPP
@@ -17,6 +17,7 @@
 #include <stg_generators/kraichnan_spectral_generator.hpp>
 #include <stg_thread_pool.hpp>
 #include <string_view>
+#include <vector>
 
 namespace stg::spectral {
 
@@ -55,12 +56,11 @@ namespace stg::spectral {
     template<std::floating_point T>
     void KraichanMethodImpl<T>::generate_sample(value_type time) {
         const std::size_t nvert = fe_mesh_->n_vertices();
+        const std::vector<value_type>& axis = fe_mesh_->relation_table()->vertices();
 
-        for (const std::size_t ivert: std::views::iota(0ull, nvert)) {
-            const auto vertex = fe_mesh_->relation_table()->vertex(ivert);
-            auto fluct = generator_(vertex, time);
-            velocity_field_.set_value(std::move(fluct), ivert);
-        }
+        std::vector<Vector<value_type>> fluctuations(nvert);
+        generator_.evaluate_on_grid({axis, axis, axis}, 0, axis.size(), time, fluctuations);
+        velocity_field_.set_values(0, fluctuations);
     }
 
 }// namespace stg::spectral
@@ -0,0 +1,60 @@
+#ifndef STG_SPECTRAL_METHOD_SAMPLE_REALIZATION_HPP
+#define STG_SPECTRAL_METHOD_SAMPLE_REALIZATION_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stg_generators.hpp>
+#include <stg_random/counter_based_engine.hpp>
+
+namespace stg::spectral {
+    using namespace stg::generators;
+
+    /*
+     * Generator of the sample isample seeded with its own counter based streams:
+     * the wave vectors and frequencies are drawn from the streams of the sample,
+     * the amplitudes, drawn anew on every evaluation, from the stream of the sample
+     * and the vertices chunk. So a realization is made per tile, on any thread or process
+     */
+    template<std::floating_point T, std::size_t seed>
+    class SampleRealization final {
+        using Engine = random::Philox4x32;
+        using Distribution = std::normal_distribution<T>;
+        using Generator = RNGenerator<Engine, Distribution>;
+
+    public:
+        // Vertices of a sample evaluated with one amplitudes stream
+        static constexpr std::size_t vertices_chunk = 4096;
+
+        SampleRealization(const SpectralGeneratorConfig<T>& config,
+                          std::size_t isample, std::size_t ichunk, std::size_t chunks)
+            : wave_vector_engine_{seed, stream(isample, 0, chunks)},
+              frequencies_engine_{seed, stream(isample, 1, chunks)},
+              amplitude_engine_{seed, stream(isample, 2 + ichunk, chunks)},
+              generator_{std::make_shared<Generator>(amplitude_engine_, Distribution{config.amplitudes_generator_mean_, config.amplitudes_generator_std_}),
+                         std::make_shared<Generator>(frequencies_engine_, Distribution{config.frequencies_generator_mean_, config.frequencies_generator_std_}),
+                         std::make_shared<Generator>(wave_vector_engine_, Distribution{config.wave_vectors_generator_mean_, config.wave_vectors_generator_std_}),
+                         config} {}
+
+        SampleRealization(const SampleRealization&) = delete;
+        SampleRealization& operator=(const SampleRealization&) = delete;
+
+        const SpectralGenerator<T, seed>& generator() const noexcept { return generator_; }
+
+    private:
+        // The generators keep references to the engines
+        Engine wave_vector_engine_;
+        Engine frequencies_engine_;
+        Engine amplitude_engine_;
+        const SpectralGenerator<T, seed> generator_;
+
+        // Streams of a sample: wave vectors, frequencies and one amplitudes stream per chunk
+        static std::uint64_t stream(std::size_t isample, std::size_t sample_stream, std::size_t chunks) noexcept {
+            return static_cast<std::uint64_t>(isample) * (chunks + 2) + sample_stream;
+        }
+    };
+}// namespace stg::spectral
+
+#endif
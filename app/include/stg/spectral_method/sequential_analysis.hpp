@@ -5,30 +5,99 @@
 #include "statistics/space_correlation.hpp"
 #include "stg/spectral_method/data_loader.hpp"
 #include "stg_tensor/tensor.hpp"
+#include "velocity_field/sample_store.hpp"
 #include "velocity_field/velocity_field.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <bits/ranges_base.h>
 #include <concepts>
 #include <cstddef>
+#include <exception>
+#include <fmt/format.h>
 #include <functional>
+#include <mutex>
+#include <stdexcept>
 #include <range/v3/view/transform.hpp>
+#include <span>
+#include <stg_thread_pool.hpp>
 #include <string_view>
+#include <thread>
 #include <vector>
 namespace stg::spectral {
 
+    /*
+     * Correlations with the center of the mesh averaged over the time ensemble of the files
+     * velocity_field_{i}.vtk. The files are read and parsed by the reader threads ahead of
+     * the accumulation into a bounded queue, the accumulator threads take the fields from it
+     * and add the outer products to their own partial sums, merged at the end. So the
+     * parsing, the accumulation and the disk overlap, the queue bounds the fields in memory
+     * to (prefetch_depth + 1) * readers + accumulators.
+     * A partial sum is 9 values per vertex, the accumulators trade memory for throughput
+     */
     template<std::floating_point T>
     class SequentialCorrelations final {
     public:
         using value_type = T;
-        SequentialCorrelations(DataLoader loader, std::string_view filename)
+
+        SequentialCorrelations(DataLoader loader, std::string_view filename,
+                               std::size_t readers = default_threads(),
+                               std::size_t accumulators = default_threads())
             : loader_{std::move(loader)},
-              velocity_mesh_{loader.load_mesh<value_type>(filename)},
-              correlations_{covariance_mesh_->n_vertices()} {}
+              velocity_mesh_{loader_.load_mesh<value_type>(filename)},
+              correlations_{covariance_mesh_->n_vertices()},
+              readers_{std::max<std::size_t>(1, readers)},
+              accumulators_{std::max<std::size_t>(1, accumulators)} {}
 
 
         void calc_covariations_for_amount(std::size_t take_n_fields) {
             run_along_files(take_n_fields);
         }
 
+        /*
+         * Correlations over the samples of a store (DataLoader::pack_velocity_samples). The
+         * vertex blocks are spread over the pool and a block reads its (sample, vertex range)
+         * slices from the memory map, so the ensemble is never loaded as a whole
+         */
+        void calc_covariations_from_store(std::string_view store_filename) {
+            const SampleStore<value_type> store = loader_.open_sample_store<value_type>(store_filename);
+            const std::size_t samples = store.size();
+            const std::size_t n_vertices = correlations_.size();
+            if (samples == 0) {
+                throw std::invalid_argument("Correlations need at least one velocity sample");
+            }
+            if (store.vertices() != n_vertices) {
+                throw std::invalid_argument(fmt::format("Store samples have {} vertices, the mesh {}", store.vertices(), n_vertices));
+            }
+
+            const std::size_t center_index = velocity_mesh_->center_lin_index();
+            std::vector<std::array<value_type, 3>> centers(samples);
+            for (std::size_t isample = 0; isample < samples; ++isample) {
+                auto& [x, y, z] = centers[isample];
+                store.read(isample, center_index, std::span{&x, 1}, std::span{&y, 1}, std::span{&z, 1});
+            }
+
+            utility::parallel_for(utility::IndexRange{0, n_vertices}, store_block, [&](std::size_t begin, std::size_t end) {
+                std::vector<value_type> vx(store_block), vy(store_block), vz(store_block);
+                std::vector<value_type> sums(9 * store_block);
+                for (std::size_t first = begin; first < end; first += store_block) {
+                    const std::size_t count = std::min(store_block, end - first);
+                    std::fill_n(sums.begin(), 9 * count, value_type{0});
+                    for (std::size_t isample = 0; isample < samples; ++isample) {
+                        store.read(isample, first, std::span{vx}.first(count), std::span{vy}.first(count), std::span{vz}.first(count));
+                        for (std::size_t index = 0; index < count; ++index) {
+                            add_outer_product({vx[index], vy[index], vz[index]}, centers[isample], sums.data() + 9 * index);
+                        }
+                    }
+                    for (std::size_t index = 0; index < count; ++index) {
+                        std::array<value_type, 9> sum;
+                        std::copy_n(sums.begin() + 9 * index, 9, sum.begin());
+                        correlations_[first + index] = Tensor<value_type>{sum} / samples;
+                    }
+                }
+            });
+        }
+
         void save_calculated_covariations(std::string_view filepath,
                                           std::string_view table_name = "TableName") const {
             VtkRectilinearGridSaver saver{filepath};
@@ -38,45 +107,115 @@ namespace stg::spectral {
                                    table_name);
         }
 
+        const std::vector<Tensor<value_type>>& correlations() const noexcept {
+            return correlations_;
+        }
+
     private:
         DataLoader loader_;
         const std::shared_ptr<CubeFiniteElementsMesh<value_type>> velocity_mesh_;
         const std::shared_ptr<CubeFiniteElementsMesh<value_type>> covariance_mesh_{velocity_mesh_};
         std::vector<Tensor<value_type>> correlations_;
 
-        void add_correlations_for_file(std::string_view filename) {
-            const auto velocity_field = loader_.load_velocity_field<value_type>(filename);
-            add_correlations(velocity_field);
+        static constexpr std::size_t prefetch_depth = 2;
+        static constexpr std::size_t merge_chunk = 4096;
+        // Vertices of a slice read from the store, 3 values each
+        static constexpr std::size_t store_block = 4096;
+
+        const std::size_t readers_;
+        const std::size_t accumulators_;
+
+        static std::size_t default_threads() {
+            return std::clamp<std::size_t>(std::thread::hardware_concurrency() / 2, 1, 4);
+        }
+
+        // Adds the outer products with the center value to the partial sums, 9 per vertex
+        void add_correlations(const VelocityField<value_type>& values, std::vector<value_type>& sums) const {
+            const std::size_t n_vertices = correlations_.size();
+            if (values.size() < n_vertices) {
+                throw std::invalid_argument("Velocity field has less values than the mesh vertices");
+            }
+            const auto center_val = values.value(velocity_mesh_->center_lin_index());
+            const std::array<value_type, 3> center{center_val.template get<0>(), center_val.template get<1>(), center_val.template get<2>()};
+            for (std::size_t ivert = 0; ivert < n_vertices; ++ivert) {
+                const auto value = values.value(ivert);
+                add_outer_product({value.template get<0>(), value.template get<1>(), value.template get<2>()}, center, sums.data() + 9 * ivert);
+            }
         }
 
-        void add_correlations(const VelocityField<value_type>& values) {
-            const auto center_lin_index = velocity_mesh_->center_lin_index();
-            const auto center_val = values.value(center_lin_index);
-
-            auto tensors = values.values_view() | ranges::views::transform([&center_val, this](const auto& velocity_tuple) {
-                               const auto [x, y, z] = velocity_tuple;
-                               return calculate_add(Vector<value_type>{x, y, z}, center_val);
-                           });
-            for (std::size_t i = 0; const auto add_tensor: tensors) {
-                correlations_[i] = correlations_[i] + add_tensor;
-                i++;
+        static void add_outer_product(const std::array<value_type, 3>& vertex, const std::array<value_type, 3>& center, value_type* tensor) noexcept {
+            for (std::size_t i = 0; i < 3; ++i) {
+                for (std::size_t j = 0; j < 3; ++j) {
+                    tensor[3 * i + j] += vertex[i] * center[j];
+                }
             }
         }
 
         void run_along_files(std::size_t amount) {
-            for (const std::size_t c_try: rv::iota(0ull, amount)) {
-                const std::string filename = fmt::format("velocity_field_{}.vtk", c_try);
-                add_correlations_for_file(filename);
+            if (amount == 0) {
+                throw std::invalid_argument("Correlations need at least one velocity field");
             }
+            const std::size_t n_vertices = correlations_.size();
+            const std::size_t readers = std::min(readers_, amount);
+            const std::size_t accumulators = std::min(accumulators_, amount);
 
-            std::transform(correlations_.begin(), correlations_.end(),
-                           correlations_.begin(), [amount](auto val) { return val / amount; });
-        }
+            utility::BoundedQueue<VelocityField<value_type>> fields{prefetch_depth * readers};
+            std::vector<std::vector<value_type>> partial_sums(accumulators, std::vector<value_type>(9 * n_vertices));
+            std::atomic<std::size_t> next_file = 0;
+            std::atomic<std::size_t> readers_left = readers;
+            std::mutex error_mutex;
+            std::exception_ptr error;
+            const auto fail = [&] {
+                {
+                    std::lock_guard lock{error_mutex};
+                    if (!error) { error = std::current_exception(); }
+                }
+                fields.close();
+            };
+
+            {
+                std::vector<std::jthread> threads;
+                threads.reserve(readers + accumulators);
+                for (std::size_t reader = 0; reader < readers; ++reader) {
+                    threads.emplace_back([&] {
+                        try {
+                            for (std::size_t c_try = next_file++; c_try < amount; c_try = next_file++) {
+                                const std::string filename = fmt::format("velocity_field_{}.vtk", c_try);
+                                if (!fields.push(loader_.load_velocity_field<value_type>(filename))) { break; }
+                            }
+                        } catch (...) {
+                            fail();
+                        }
+                        if (--readers_left == 0) { fields.close(); }
+                    });
+                }
+                for (std::size_t accumulator = 0; accumulator < accumulators; ++accumulator) {
+                    threads.emplace_back([&, accumulator] {
+                        try {
+                            while (const auto field = fields.pop()) {
+                                add_correlations(*field, partial_sums[accumulator]);
+                            }
+                        } catch (...) {
+                            fail();
+                        }
+                    });
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
 
-        Tensor<value_type> calculate_add(const Vector<value_type>& vertex_value, Vector<value_type> center_value) const {
-            return {vertex_value.template get<0>() * center_value.template get<0>(), vertex_value.template get<0>() * center_value.template get<1>(), vertex_value.template get<0>() * center_value.template get<2>(),
-                    vertex_value.template get<1>() * center_value.template get<0>(), vertex_value.template get<1>() * center_value.template get<1>(), vertex_value.template get<1>() * center_value.template get<2>(),
-                    vertex_value.template get<2>() * center_value.template get<0>(), vertex_value.template get<2>() * center_value.template get<1>(), vertex_value.template get<2>() * center_value.template get<2>()};
+            utility::parallel_for(utility::IndexRange{0, n_vertices}, merge_chunk, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t ivert = begin; ivert < end; ++ivert) {
+                    std::array<value_type, 9> sum{};
+                    for (const auto& partial: partial_sums) {
+                        for (std::size_t component = 0; component < 9; ++component) {
+                            sum[component] += partial[9 * ivert + component];
+                        }
+                    }
+                    correlations_[ivert] = (correlations_[ivert] + Tensor<value_type>{sum}) / amount;
+                }
+            });
         }
     };
 }// namespace stg::spectral
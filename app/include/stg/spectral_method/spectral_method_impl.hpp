@@ -1,17 +1,25 @@
 #ifndef STG_SPECTRAL_METHOD_IMPL_HPP
 #define STG_SPECTRAL_METHOD_IMPL_HPP
 
+#include "async_field_writer.hpp"
 #include "data_loader.hpp"
-#include <boost/asio/post.hpp>
-#include <boost/asio/thread_pool.hpp>
+#include "sample_realization.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <concepts>
 #include <fem.hpp>
+#include <fmt/format.h>
 #include <memory>
 #include <mesh_builders.hpp>
+#include <optional>
 #include <range/v3/view/iota.hpp>
+#include <span>
 #include <statistics.hpp>
 #include <stg_generators.hpp>
 #include <stg_tensor/tensor.hpp>
+#include <stg_thread_pool.hpp>
+#include <string>
 #include <velocity_field.hpp>
 
 namespace stg::spectral {
@@ -19,7 +27,6 @@ namespace stg::spectral {
     using namespace stg::field;
     using namespace stg::generators;
     using namespace stg::statistics;
-    namespace net = boost::asio;
     namespace rv = ranges::views;
 
     template<std::floating_point T, std::size_t seed = 42>
@@ -42,27 +49,45 @@ namespace stg::spectral {
         SpectralMethodApplicationImpl(T cube_edge_len, std::size_t edge_points,
                                       SpectralGeneratorConfig<T> config,
                                       std::size_t samples_amount = 100,
-                                      std::size_t concurrency_hint = std::thread::hardware_concurrency() - 1)
+                                      std::size_t concurrency_hint = std::thread::hardware_concurrency() - 1,
+                                      utility::Affinity affinity = utility::Affinity::none)
             : SpectralMethodApplicationImpl(CubeMeshBuilder<value_type>{cube_edge_len, edge_points},
                                             std::forward<SpectralGeneratorConfig<value_type>>(config),
                                             samples_amount,
-                                            concurrency_hint) {}
+                                            concurrency_hint,
+                                            affinity) {}
 
         SpectralMethodApplicationImpl(CubeMeshBuilder<T> builder,
                                       SpectralGeneratorConfig<T> config,
                                       std::size_t samples_amount = 100,
-                                      std::size_t concurrency_hint = std::thread::hardware_concurrency() - 1)
+                                      std::size_t concurrency_hint = std::thread::hardware_concurrency() - 1,
+                                      utility::Affinity affinity = utility::Affinity::none)
             : SpectralMethodApplicationImpl(
                       builder.build(),
                       std::forward<SpectralGeneratorConfig<value_type>>(config),
                       samples_amount,
-                      concurrency_hint) {}
+                      concurrency_hint,
+                      affinity) {}
 
+        /*
+         * By default the work runs on the process wide utility::ThreadPool::global() and
+         * concurrency_hint is not used. With Affinity::pinned the application owns a pool of
+         * concurrency_hint workers pinned to the CPUs, and the pages of the samples are first
+         * touched by the workers whose Partition::per_worker vertex blocks they hold
+         */
         SpectralMethodApplicationImpl(std::shared_ptr<const CubeFiniteElementsMesh<T>> mesh,
                                       SpectralGeneratorConfig<T> config,
                                       std::size_t samples_amount = 100,
-                                      std::size_t concurrency_hint = std::thread::hardware_concurrency() - 1)
-            : fe_mesh_{std::move(mesh)}, generator_config_(std::move(config)), spectral_generator_{generator_config_}, velocity_samples_{100, fe_mesh_->n_vertices()}, thread_pool_{new net::thread_pool{std::max(1ul, concurrency_hint)}} {}
+                                      std::size_t concurrency_hint = std::thread::hardware_concurrency() - 1,
+                                      utility::Affinity affinity = utility::Affinity::none)
+            : fe_mesh_{std::move(mesh)}, generator_config_(std::move(config)), spectral_generator_{generator_config_}, velocity_samples_{samples_amount, fe_mesh_->n_vertices()},
+              pinned_pool_{affinity == utility::Affinity::pinned
+                                   ? std::make_unique<utility::ThreadPool>(std::max<std::size_t>(1, concurrency_hint), affinity)
+                                   : nullptr} {
+            if (pinned_pool_) {
+                velocity_samples_.for_each_buffer([this](std::span<value_type> buffer) { utility::first_touch(thread_pool_, buffer); });
+            }
+        }
 
         /*
      * Use generator to directly generate value
@@ -76,24 +101,25 @@ namespace stg::spectral {
      * Generate velocity fluctuations in mesh vertices
      */
         void generate_on_mesh(value_type time) {
-            auto executor_ctx = thread_pool_->get_executor();
-            for (const std::size_t index: rv::iota(0ul, fe_mesh_->n_vertices())) {
-                net::post(*thread_pool_.get(),
-                          [this, index, time] { generate_at_vertex(index, time); });
-            }
-            thread_pool_->join();
+            utility::parallel_for(thread_pool_, 0, fe_mesh_->n_vertices(), vertices_chunk,
+                                  [this, time](std::size_t begin, std::size_t end) { generate_at_vertices(begin, end, time); });
         }
 
         /*
-     * Generate samples for statistics in mesh vertices
+     * Generate samples for statistics in mesh vertices. Every sample is an independent
+     * realization of the generator (see SampleRealization), the (sample, vertices chunk)
+     * tiles are spread over the pool and written in place, the result doesn't depend
+     * on the number of threads
      */
         void generate_samples_on_mesh(value_type time) {
-            for (const std::size_t index: rv::iota(0ul, velocity_samples_.size())) {
-                generate_sample(index, time);
-                /*net::post(*thread_pool_.get(),
-                  [this, index, time]{ generate_sample(index, time); });*/
-            }
-            thread_pool_->join();
+            vertex_major_samples_.reset();
+            const std::size_t chunks = vertices_chunks();
+            utility::parallel_for(thread_pool_, 0, velocity_samples_.size() * chunks, 1,
+                                  [this, time, chunks](std::size_t begin, std::size_t end) {
+                                      for (const std::size_t tile: rv::iota(begin, end)) {
+                                          generate_sample_chunk(tile / chunks, tile % chunks, time);
+                                      }
+                                  });
         }
 
         Statistics collect_ansamble_statistics() const {
@@ -103,9 +129,9 @@ namespace stg::spectral {
             const auto vy_view = velocity_field_.vy_view();
             const auto vz_view = velocity_field_.vz_view();
 
-            const auto std_x_f = std::async(std::launch::async, &Mean::mean, vx_view, 0.);
-            const auto std_y_f = std::async(std::launch::async, &Mean::mean, vy_view, 0.);
-            const auto std_z_f = std::async(std::launch::async, &Mean::mean, vz_view, 0.);
+            auto std_x_f = utility::spawn([&vx_view] { return Mean::mean(vx_view); }, thread_pool_);
+            auto std_y_f = utility::spawn([&vy_view] { return Mean::mean(vy_view); }, thread_pool_);
+            auto std_z_f = utility::spawn([&vz_view] { return Mean::mean(vz_view); }, thread_pool_);
 
             cache_.ansamble_cache_ = Statistics{
                     .std_x = std_x_f.get(),
@@ -147,26 +173,47 @@ namespace stg::spectral {
             corr_tensor_data_.resize(fe_mesh_->n_vertices());
             const std::size_t base_vert_index = fe_mesh_->relation_table()->lin_index(ix, jy, kz);
 
-            for (const std::size_t ivert: rv::iota(0ul, fe_mesh_->n_vertices())) {
-                auto space_corr = [&]() mutable {
-                    auto base_x_sample = velocity_samples_.vx_component_for_vertex(base_vert_index);
-                    auto base_y_sample = velocity_samples_.vy_component_for_vertex(base_vert_index);
-                    auto base_z_sample = velocity_samples_.vz_component_for_vertex(base_vert_index);
-
-                    auto vert_x_sample = velocity_samples_.vx_component_for_vertex(ivert);
-                    auto vert_y_sample = velocity_samples_.vy_component_for_vertex(ivert);
-                    auto vert_z_sample = velocity_samples_.vz_component_for_vertex(ivert);
-
-                    corr_tensor_data_[ivert] = SpaceCorrelation::correlation_tensor(base_x_sample, vert_x_sample,
-                                                                                    base_y_sample, vert_y_sample,
-                                                                                    base_z_sample, vert_z_sample,
-                                                                                    0., 0., 0., 0., 0., 0.);
-                };
-                space_corr();
-                /*net::post(*thread_pool_.get(), space_corr);*/
-            }
+            // The ensembles of the vertices are contiguous after one blocked transpose per set of samples
+            if (!vertex_major_samples_) { vertex_major_samples_.emplace(velocity_samples_); }
+            const VertexMajorSamples<value_type>& samples = *vertex_major_samples_;
+            const auto base_x_sample = samples.vx_component_for_vertex(base_vert_index);
+            const auto base_y_sample = samples.vy_component_for_vertex(base_vert_index);
+            const auto base_z_sample = samples.vz_component_for_vertex(base_vert_index);
+
+            // One fused single pass kernel per vertex, the vertices are spread over the pool
+            utility::parallel_for(thread_pool_, 0, fe_mesh_->n_vertices(), correlations_chunk,
+                                  [&](std::size_t begin, std::size_t end) {
+                                      for (const std::size_t ivert: rv::iota(begin, end)) {
+                                          const auto vert_x_sample = samples.vx_component_for_vertex(ivert);
+                                          const auto vert_y_sample = samples.vy_component_for_vertex(ivert);
+                                          const auto vert_z_sample = samples.vz_component_for_vertex(ivert);
+
+                                          corr_tensor_data_[ivert] = SpaceCorrelation::correlation_tensor(base_x_sample, vert_x_sample,
+                                                                                                          base_y_sample, vert_y_sample,
+                                                                                                          base_z_sample, vert_z_sample,
+                                                                                                          0., 0., 0., 0., 0., 0.);
+                                      }
+                                  });
+        }
 
-            thread_pool_->join();
+        /*
+         * Per vertex moments of the samples. Every worker adds the samples of its
+         * Partition::per_worker vertex block, the block its pages were first touched by
+         */
+        std::vector<SampleMoments> samples_moments() const {
+            std::vector<SampleMoments> moments(fe_mesh_->n_vertices());
+            utility::parallel_for(thread_pool_, 0, moments.size(), 1, [this, &moments](std::size_t begin, std::size_t end) {
+                for (std::size_t isample = 0; isample < velocity_samples_.size(); ++isample) {
+                    const auto& sample = velocity_samples_.sample(isample);
+                    const auto vx = sample.component(0);
+                    const auto vy = sample.component(1);
+                    const auto vz = sample.component(2);
+                    for (std::size_t ivert = begin; ivert < end; ++ivert) {
+                        moments[ivert].add({static_cast<double>(vx[ivert]), static_cast<double>(vy[ivert]), static_cast<double>(vz[ivert])});
+                    }
+                }
+            }, utility::Partition::per_worker);
+            return moments;
         }
 
         void generate_correlations_relative_to_space_center() {
@@ -174,39 +221,70 @@ namespace stg::spectral {
             generate_correlations(center_ind[0], center_ind[1], center_ind[2]);
         }
 
-        ~SpectralMethodApplicationImpl() {
-            thread_pool_->join();
+        const VelocitySamples<value_type>& velocity_samples() const noexcept {
+            return velocity_samples_;
+        }
+
+        // Pool of the stages, the pinned one with Affinity::pinned
+        utility::ThreadPool& thread_pool() const noexcept {
+            return thread_pool_;
         }
 
     private:
+        static constexpr std::size_t vertices_chunk = SampleRealization<T, seed>::vertices_chunk;
+        static constexpr std::size_t correlations_chunk = 64;
+
         const std::shared_ptr<const CubeFiniteElementsMesh<value_type>> fe_mesh_;
         const SpectralGeneratorConfig<value_type> generator_config_;
         const SpectralGenerator<value_type, seed> spectral_generator_;
         VelocityField<value_type> velocity_field_{fe_mesh_->n_vertices()};
-        VelocitySamples<value_type> velocity_samples_{100, fe_mesh_->n_vertices()};
+        VelocitySamples<value_type> velocity_samples_;
+        std::optional<VertexMajorSamples<value_type>> vertex_major_samples_;
         std::vector<tensor::Tensor<value_type>> corr_tensor_data_;
         std::vector<value_type> divergences_;
-        std::unique_ptr<net::thread_pool> thread_pool_;
+        const std::unique_ptr<utility::ThreadPool> pinned_pool_;
+        utility::ThreadPool& thread_pool_ = pinned_pool_ ? *pinned_pool_ : utility::ThreadPool::global();
 
         struct {
             Statistics ansamble_cache_;
             bool is_ansamble_cache_ = false;
         } cache_;
 
-        void generate_at_vertex(std::size_t ivert, value_type time) {
-            const auto vert_point = fe_mesh_->relation_table()->vertex(ivert);
-            const auto velocity = spectral_generator_(vert_point, time);
-            velocity_field_.set_value(velocity, ivert);
+        /*
+         * Evaluate generator for vertices [begin, end) with one batched call,
+         * chunks of parallel_for write disjoint slices of the field
+         */
+        void generate_at_vertices(std::size_t begin, std::size_t end, value_type time) {
+            const auto velocities = evaluate_at_vertices(begin, end, time);
+            velocity_field_.set_values(begin, velocities);
         }
 
-        void generate_sample(std::size_t isample, value_type time) {
-            VelocityField<value_type> sample{fe_mesh_->n_vertices()};
-            for (const std::size_t index: rv::iota(0ul, fe_mesh_->n_vertices())) {
-                auto&& vertex = fe_mesh_->relation_table()->vertex(index);
-                auto&& value = spectral_generator_(std::move(vertex), time);
-                sample.set_value(std::move(value), index);
+        std::size_t vertices_chunks() const noexcept {
+            return (fe_mesh_->n_vertices() + vertices_chunk - 1) / vertices_chunk;
+        }
+
+        // Fills the vertices chunk ichunk of the preallocated sample isample in place
+        void generate_sample_chunk(std::size_t isample, std::size_t ichunk, value_type time) {
+            const SampleRealization<value_type, seed> realization{generator_config_, isample, ichunk, vertices_chunks()};
+            const std::size_t begin = ichunk * vertices_chunk;
+            const std::size_t end = std::min(begin + vertices_chunk, fe_mesh_->n_vertices());
+            const auto velocities = evaluate_at_vertices(realization.generator(), begin, end, time);
+            velocity_samples_.writer(isample, begin, end).set_values(begin, velocities);
+        }
+
+        std::vector<Vector<value_type>> evaluate_at_vertices(std::size_t begin, std::size_t end, value_type time) const {
+            return evaluate_at_vertices(spectral_generator_, begin, end, time);
+        }
+
+        template<typename Generator>
+        std::vector<Vector<value_type>> evaluate_at_vertices(const Generator& generator, std::size_t begin, std::size_t end, value_type time) const {
+            std::vector<Point<value_type>> vertices(end - begin);
+            std::vector<Vector<value_type>> velocities(end - begin);
+            for (const std::size_t index: rv::iota(begin, end)) {
+                vertices[index - begin] = fe_mesh_->relation_table()->vertex(index);
             }
-            velocity_samples_.set_sample(std::move(sample), isample);
+            generator.evaluate(vertices, time, velocities);
+            return velocities;
         }
     };
 
@@ -229,25 +307,99 @@ namespace stg::spectral {
                                   const CubeMeshBuilder<value_type>& builder,
                                   std::shared_ptr<ISpectra<value_type>> spectra)
             : loader_{std::move(loader)}, parameters_{std::move(params)}, fe_mesh_{builder.build()}, spectral_generator_{std::move(generator)} {
-            spectral_generator_->initialize_spectra(spectra);
-            spectral_generator_->initialize_wave_vector_amplitudes(parameters_.k_min, parameters_.k_max, parameters_.n_spectra);
-            spectral_generator_->initialize_random_coefficients();
-            spectral_generator_->initialize_inner_generators();
-
-            velocity_field_.resize(fe_mesh_->n_vertices());
+            /*
+             * The spectra, the wave vector amplitudes and the random coefficients are
+             * independent members of the generator, the inner generators read all three
+             */
+            utility::TaskGraph graph{pool_};
+            graph.add("initialize_spectra", {.outputs = {"spectra"}},
+                      [this, &spectra] { spectral_generator_->initialize_spectra(spectra); });
+            graph.add("initialize_wave_vector_amplitudes", {.outputs = {"wave vector amplitudes"}}, [this] {
+                spectral_generator_->initialize_wave_vector_amplitudes(parameters_.k_min, parameters_.k_max, parameters_.n_spectra);
+            });
+            graph.add("initialize_random_coefficients", {.outputs = {"random coefficients"}},
+                      [this] { spectral_generator_->initialize_random_coefficients(); });
+            graph.add("initialize_inner_generators",
+                      {.inputs = {"spectra", "wave vector amplitudes", "random coefficients"}, .outputs = {"generator"}},
+                      [this] { spectral_generator_->initialize_inner_generators(); });
+            graph.add("allocate_velocity_field", {.outputs = {"velocity field"}},
+                      [this] { velocity_field().resize(fe_mesh_->n_vertices()); });
+            graph.run();
+            stage_timings_ = graph.timings();
         }
 
         void generate_velocity_field(value_type time) {
-            auto func = [time, this](std::size_t g_index) {
-                const auto vertex = fe_mesh_->relation_table()->vertex(g_index);
-                velocity_field_.set_value(spectral_generator_->operator()(vertex, time), g_index);
-            };
-            auto executor = pool_.get_executor();
-            for (const std::size_t g_index: rv::iota(0ull, fe_mesh_->n_vertices())) {
-                // func(g_index);
-                net::post(executor, std::bind(func, g_index));
+            generate_velocity_field(time, velocity_field());
+        }
+
+        void generate_velocity_field_on_grid(value_type time) {
+            generate_velocity_field_on_grid(time, velocity_field());
+        }
+
+        /*
+         * Generates the fields at the times and saves the field i to path_template formatted
+         * with i, the velocity table is table_template formatted with i. The fields go through
+         * the ring of buffers of an AsyncFieldWriter, so the field i is written on the I/O
+         * thread while the field i + 1 is generated, and the generation waits once all the
+         * buffers wait for the disk. Returns the timings of the generations and the writes,
+         * also kept in stage_timings
+         */
+        const std::vector<utility::StageTiming>& generate_time_series(std::span<const value_type> times,
+                                                                      std::string_view path_template,
+                                                                      std::string_view table_template = "VelocityField{}",
+                                                                      std::size_t buffers = 2) {
+            AsyncFieldWriter<value_type> writer{field_format(fmt::format(fmt::runtime(path_template), 0)),
+                                                fe_mesh_->n_vertices(), buffers};
+            std::vector<utility::StageTiming> generations;
+            VelocityField<value_type>* last = nullptr;
+            for (std::size_t index = 0; index < times.size(); ++index) {
+                auto& frame = writer.acquire();
+                const auto start = std::chrono::steady_clock::now();
+                generate_velocity_field(times[index], frame.field);
+                const auto end = std::chrono::steady_clock::now();
+                generations.push_back({.name = fmt::format("generate_velocity_field {}", index),
+                                       .start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - writer.origin()),
+                                       .duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)});
+                writer.submit(frame, fmt::format(fmt::runtime(path_template), index), fmt::format(fmt::runtime(table_template), index));
+                last = &frame.field;
+            }
+            writer.flush();
+            if (last != nullptr) {
+                std::swap(velocity_field_, *last);
+            }
+
+            const auto writes = writer.timings();
+            stage_timings_.clear();
+            for (std::size_t index = 0; index < generations.size(); ++index) {
+                stage_timings_.push_back(generations[index]);
+                stage_timings_.push_back(writes[index]);
             }
-            pool_.join();
+            return stage_timings_;
+        }
+
+        /*
+         * One generate → analyze → save run through a utility::TaskGraph: the field is generated
+         * at time, then the moments of its values and the file of every path are stages reading
+         * it, so the statistics and the writers overlap. Returns the moments over the vertices,
+         * the timing of every stage is kept in stage_timings
+         */
+        SampleMoments run_pipeline(value_type time, std::span<const std::filesystem::path> paths,
+                                   std::string_view table_name = "Vector field") {
+            SampleMoments moments;
+            utility::TaskGraph graph{pool_};
+            graph.add("generate_velocity_field", {.inputs = {"generator"}, .outputs = {"velocity field"}},
+                      [this, time] { generate_velocity_field(time); });
+            graph.add("collect_statistics", {.inputs = {"velocity field"}, .outputs = {"statistics"}}, [this, &moments] {
+                const auto& field = velocity_field();
+                moments = Moments::sample_moments(field.component(0), field.component(1), field.component(2));
+            });
+            for (const auto& path: paths) {
+                graph.add(fmt::format("save_data_to {}", path.string()), {.inputs = {"velocity field"}},
+                          [this, &path, table_name] { save_data_to(velocity_field(), path, table_name); });
+            }
+            graph.run();
+            stage_timings_ = graph.timings();
+            return moments;
         }
 
         value_type get_max_period() const {
@@ -256,24 +408,101 @@ namespace stg::spectral {
         }
 
         void save_data_to(std::filesystem::path path, std::string_view table_name = "Vector field") {
-            VtkRectilinearGridSaver saver{path.string()};
-            saver.template save_mesh<value_type>(fe_mesh_->relation_table());
-            saver.save_vector_data(velocity_field_.values_view(), table_name);
+            save_data_to(velocity_field(), path, table_name);
         }
 
         void set_spectra(std::shared_ptr<ISpectra<value_type>> spectra) {
             spectral_generator_->initialize_spectra(std::move(spectra));
         }
 
+        // Encoding of the legacy files, binary is much faster to write, DataLoader reads ASCII
+        void set_output_format(VtkFormat format) noexcept {
+            output_format_ = format;
+        }
+
+        // Format of all the saved fields whatever the path, none to choose it by the extension
+        void set_field_format(std::shared_ptr<const IFieldFormat<value_type>> format) noexcept {
+            field_format_ = std::move(format);
+        }
+
+        // Timings of the stages of the initialization, of the last pipeline or of the last time series
+        const std::vector<utility::StageTiming>& stage_timings() const noexcept {
+            return stage_timings_;
+        }
+
     private:
+        static constexpr std::size_t vertices_chunk = 4096;
+        static constexpr std::size_t grid_slab_layers = 2;
+
         DataLoader loader_;
         SpectralParameters<value_type> parameters_;
         const std::shared_ptr<const CubeFiniteElementsMesh<value_type>> fe_mesh_ = CubeMeshBuilder<value_type>{parameters_.cube_edge_len, parameters_.edge_points}.build();
         const std::shared_ptr<SpectralGeneratorV2<value_type>> spectral_generator_ = std::make_shared<SpectralGeneratorV2<value_type>>(parameters_);
         VelocityField<value_type> velocity_field_;
+        std::vector<utility::StageTiming> stage_timings_;
+        VtkFormat output_format_ = VtkFormat::ascii;
+        std::shared_ptr<const IFieldFormat<value_type>> field_format_;
+
+        VelocityField<value_type>& velocity_field() noexcept { return velocity_field_; }
+
+        void generate_velocity_field(value_type time, VelocityField<value_type>& field) {
+            if (parameters_.grid_phase_tables) {
+                generate_velocity_field_on_grid(time, field);
+                return;
+            }
+            auto func = [time, &field, this](std::size_t begin, std::size_t end) {
+                std::vector<Point<value_type>> vertices(end - begin);
+                std::vector<Vector<value_type>> velocities(end - begin);
+                for (const std::size_t g_index: rv::iota(begin, end)) {
+                    vertices[g_index - begin] = fe_mesh_->relation_table()->vertex(g_index);
+                }
+                spectral_generator_->evaluate(vertices, time, velocities);
+                field.set_values(begin, velocities);
+            };
+            utility::parallel_for(pool_, 0, fe_mesh_->n_vertices(), vertices_chunk, func);
+        }
+
+        /*
+         * Cube mesh is a rectilinear grid with the same axis along x, y and z,
+         * each chunk generates a slab of z layers using per-axis phase tables
+         */
+        void generate_velocity_field_on_grid(value_type time, VelocityField<value_type>& field) {
+            const auto relation_table = fe_mesh_->relation_table();
+            const std::vector<value_type>& axis = relation_table->vertices();
+            const GridAxes<value_type> axes{axis, axis, axis};
+            const std::size_t layer_size = axis.size() * axis.size();
+
+            auto func = [time, axes, layer_size, &field, this](std::size_t k_begin, std::size_t k_end) {
+                std::vector<Vector<value_type>> velocities(axes.n_vertices(k_begin, k_end));
+                spectral_generator_->evaluate_on_grid(axes, k_begin, k_end, time, velocities);
+                field.set_values(k_begin * layer_size, velocities);
+            };
+            utility::parallel_for(pool_, 0, axis.size(), grid_slab_layers, func);
+        }
+
+        /*
+         * The format set by set_field_format, else by the extension: a .vtr path is an XML
+         * grid, a .raw path the raw components, any other a legacy file in the output format
+         */
+        std::shared_ptr<const IFieldFormat<value_type>> field_format(const std::filesystem::path& path) const {
+            if (field_format_) {
+                return field_format_;
+            }
+            if (path.extension() == ".vtr") {
+                return std::make_shared<VtrFieldFormat<value_type>>(fe_mesh_->relation_table());
+            }
+            if (path.extension() == ".raw") {
+                return std::make_shared<RawFieldFormat<value_type>>();
+            }
+            return std::make_shared<VtkFieldFormat<value_type>>(fe_mesh_->relation_table(), output_format_);
+        }
+
+        void save_data_to(const VelocityField<value_type>& field, const std::filesystem::path& path, std::string_view table_name) const {
+            field_format(path)->write(field, path, table_name);
+        }
 
 
-        net::thread_pool pool_{std::thread::hardware_concurrency()};
+        utility::ThreadPool& pool_ = utility::ThreadPool::global();
     };
 }// namespace stg::spectral
 
@@ -0,0 +1,69 @@
+#ifndef STG_INFLOW_H
+#define STG_INFLOW_H
+
+/*
+ * C interface of the inflow plane generator (stg::spectral::InflowPlaneGenerator<double>)
+ * for solvers written in C or Fortran. Functions returning int return STG_INFLOW_OK on
+ * success, the message of the last failure of the calling thread is stg_inflow_last_error()
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    STG_INFLOW_OK = 0,
+    STG_INFLOW_INVALID_ARGUMENT = 1,
+    STG_INFLOW_ERROR = 2
+};
+
+typedef struct stg_inflow stg_inflow;
+
+/*
+ * Parameters of the spectral generator, the spectrum is von Karman (k_e, k_eta, k_cut)
+ * and must have energy between k_min and k_max. reynolds is the row major reynolds stress tensor
+ */
+typedef struct stg_inflow_parameters {
+    uint64_t seed;
+    double ampl_mean, ampl_std;
+    double wv_mean, wv_std;
+    double freq_mean, freq_std;
+    double k_min, k_max;
+    double length_scale, time_scale;
+    size_t n_spectra, n_fourier;
+    double k_e, k_eta, k_cut;
+    double reynolds[9];
+    /* Bytes of the phasors kept between the steps, 0 for the default */
+    size_t memory_budget;
+} stg_inflow_parameters;
+
+stg_inflow_parameters stg_inflow_default_parameters(void);
+
+/*
+ * points are n_points interleaved (x, y, z) triples, the first step is at start_time.
+ * Returns NULL on failure
+ */
+stg_inflow* stg_inflow_create(const stg_inflow_parameters* parameters,
+                              const double* points, size_t n_points,
+                              double start_time, double time_step);
+
+/*
+ * Copies the velocities of the next step into 3 * n_points interleaved (u, v, w)
+ * values, time of the step is written to time if it is not NULL
+ */
+int stg_inflow_next(stg_inflow* inflow, double* velocities, double* time);
+
+size_t stg_inflow_size(const stg_inflow* inflow);
+
+void stg_inflow_destroy(stg_inflow* inflow);
+
+const char* stg_inflow_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STG_INFLOW_H */
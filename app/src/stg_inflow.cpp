@@ -0,0 +1,125 @@
+#include "stg/spectral_method/stg_inflow.h"
+#include "stg/spectral_method/inflow_plane.hpp"
+#include <cmath>
+#include <string>
+
+struct stg_inflow {
+  stg::spectral::InflowPlaneGenerator<double> generator;
+};
+
+namespace {
+  thread_local std::string last_error;
+
+  template<typename Function>
+  int guarded(Function&& function) {
+    try {
+      function();
+      return STG_INFLOW_OK;
+    } catch (const std::invalid_argument& error) {
+      last_error = error.what();
+      return STG_INFLOW_INVALID_ARGUMENT;
+    } catch (const std::exception& error) {
+      last_error = error.what();
+      return STG_INFLOW_ERROR;
+    } catch (...) {
+      last_error = "Unknown error";
+      return STG_INFLOW_ERROR;
+    }
+  }
+
+  // The generator scales the modes by the energy of the spectrum on its wave numbers grid
+  void check_spectrum_energy(const stg::generators::ISpectra<double>& spectra, double k_min, double k_max, std::size_t n_spectra) {
+    double energy = 0.;
+    for (std::size_t index = 0; index < n_spectra; ++index) {
+      const double k = n_spectra == 1 ? k_min : k_min + (k_max - k_min) * index / (n_spectra - 1);
+      energy += spectra(k);
+    }
+    if (!std::isfinite(energy) || energy <= 0.) {
+      throw std::invalid_argument("Spectrum has no energy between k_min and k_max");
+    }
+  }
+}
+
+extern "C" {
+
+  stg_inflow_parameters stg_inflow_default_parameters(void) {
+    const stg::generators::SpectralParameters<double> defaults;
+    stg_inflow_parameters parameters{};
+    parameters.seed = defaults.seed;
+    parameters.ampl_mean = defaults.ampl_mean, parameters.ampl_std = defaults.ampl_std;
+    parameters.wv_mean = defaults.wv_mean, parameters.wv_std = defaults.wv_std;
+    parameters.freq_mean = defaults.freq_mean, parameters.freq_std = defaults.freq_std;
+    parameters.k_min = defaults.k_min, parameters.k_max = defaults.k_max;
+    parameters.length_scale = defaults.length_scale, parameters.time_scale = defaults.time_scale;
+    parameters.n_spectra = defaults.n_spectra, parameters.n_fourier = defaults.n_fourier;
+    parameters.k_e = 1., parameters.k_eta = 100., parameters.k_cut = 40.;
+    std::copy(defaults.reynolds_tensor_.cbegin(), defaults.reynolds_tensor_.cend(), parameters.reynolds);
+    parameters.memory_budget = stg::generators::PhasorTimeStepper<double>::default_memory_budget;
+    return parameters;
+  }
+
+  stg_inflow* stg_inflow_create(const stg_inflow_parameters* parameters,
+                                const double* points, size_t n_points,
+                                double start_time, double time_step) {
+    stg_inflow* inflow = nullptr;
+    guarded([&] {
+      if (parameters == nullptr || points == nullptr) {
+        throw std::invalid_argument("Parameters and points must not be null");
+      }
+      stg::generators::SpectralParameters<double> spectral;
+      spectral.seed = parameters->seed;
+      spectral.ampl_mean = parameters->ampl_mean, spectral.ampl_std = parameters->ampl_std;
+      spectral.wv_mean = parameters->wv_mean, spectral.wv_std = parameters->wv_std;
+      spectral.freq_mean = parameters->freq_mean, spectral.freq_std = parameters->freq_std;
+      spectral.k_min = parameters->k_min, spectral.k_max = parameters->k_max;
+      spectral.length_scale = parameters->length_scale, spectral.time_scale = parameters->time_scale;
+      spectral.n_spectra = parameters->n_spectra, spectral.n_fourier = parameters->n_fourier;
+      std::array<double, 9> reynolds;
+      std::copy(parameters->reynolds, parameters->reynolds + 9, reynolds.begin());
+      spectral.reynolds_tensor_ = stg::tensor::Tensor<double>{reynolds};
+
+      std::vector<stg::Point<double>> face_points(n_points);
+      for (std::size_t i = 0; i < n_points; ++i) {
+        face_points[i] = {points[3 * i], points[3 * i + 1], points[3 * i + 2]};
+      }
+      auto spectra = std::make_shared<stg::generators::VonKarmanSpectra<double>>(
+        parameters->k_e, parameters->k_eta, parameters->k_cut);
+      check_spectrum_energy(*spectra, spectral.k_min, spectral.k_max, spectral.n_spectra);
+      const std::size_t memory_budget = parameters->memory_budget != 0
+                                          ? parameters->memory_budget
+                                          : stg::generators::PhasorTimeStepper<double>::default_memory_budget;
+      inflow = new stg_inflow{{spectral, std::move(spectra), std::move(face_points),
+                               start_time, time_step, memory_budget}};
+    });
+    return inflow;
+  }
+
+  int stg_inflow_next(stg_inflow* inflow, double* velocities, double* time) {
+    return guarded([&] {
+      if (inflow == nullptr || velocities == nullptr) {
+        throw std::invalid_argument("Inflow and velocities must not be null");
+      }
+      const auto frame = inflow->generator.next();
+      for (std::size_t i = 0; i < frame.velocities.size(); ++i) {
+        velocities[3 * i] = frame.velocities[i].get<0>();
+        velocities[3 * i + 1] = frame.velocities[i].get<1>();
+        velocities[3 * i + 2] = frame.velocities[i].get<2>();
+      }
+      if (time != nullptr) {
+        *time = frame.time;
+      }
+    });
+  }
+
+  size_t stg_inflow_size(const stg_inflow* inflow) {
+    return inflow == nullptr ? 0 : inflow->generator.size();
+  }
+
+  void stg_inflow_destroy(stg_inflow* inflow) {
+    delete inflow;
+  }
+
+  const char* stg_inflow_last_error(void) {
+    return last_error.c_str();
+  }
+}
@@ -0,0 +1,63 @@
+#include "common.hpp"
+#include <cstddef>
+#include <vector>
+
+using namespace stg::statistics;
+using namespace stg::utility;
+
+namespace {
+    bool same_moments(const std::vector<SampleMoments>& first, const std::vector<SampleMoments>& second) {
+        if (first.size() != second.size()) { return false; }
+        for (std::size_t ivert = 0; ivert < first.size(); ++ivert) {
+            if (first[ivert].size != second[ivert].size || first[ivert].sums != second[ivert].sums ||
+                first[ivert].products != second[ivert].products) {
+                return false;
+            }
+        }
+        return true;
+    }
+}// namespace
+
+SCENARIO("Distributed ensemble statistics are the single process ones") {
+  const auto config = mock::MakeDefaultSpectralConfig(0.01, 1.5, 50);
+  const auto mesh = CubeMeshBuilder<double>{2., 17}.build();
+  const DistributedEnsemble<double> ensemble{mesh, config, 12, 3};
+
+  ThreadPool pool{3};
+  const auto expected = ensemble.moments(0., pool);
+  REQUIRE(expected.size() == mesh->n_vertices());
+  REQUIRE(expected.front().size == 12);
+
+  THEN("The moments don't depend on the number of threads") {
+    ThreadPool single{1};
+    REQUIRE(same_moments(ensemble.moments(0., single), expected));
+  }
+
+  THEN("The moments don't depend on the number of ranks") {
+    for (const std::size_t ranks: {2ul, 3ul, 8ul}) {
+      launch_local(ranks, [&](ICommunicator& communicator) {
+        ThreadPool rank_pool{2};
+        const auto moments = ensemble.moments(communicator, 0., rank_pool);
+        if (communicator.rank() == 0) {
+          REQUIRE(moments.has_value());
+          REQUIRE(same_moments(*moments, expected));
+        }
+      });
+    }
+  }
+
+  THEN("The moments are the ones of the application samples") {
+    SpectralMethodApplicationImpl<double> application{mesh, config, 12};
+    application.generate_samples_on_mesh(0.);
+    const auto means = DistributedEnsemble<double>::means(expected);
+    const auto correlations = DistributedEnsemble<double>::correlation_tensors(expected);
+    for (std::size_t ivert = 0; ivert < mesh->n_vertices(); ivert += 101) {
+      double mean_x = 0.;
+      for (std::size_t isample = 0; isample < 12; ++isample) {
+        mean_x += application.velocity_samples().sample(isample).value(ivert).get<0>() / 12.;
+      }
+      REQUIRE_THAT(means[ivert][0], WithinAbs(mean_x, 1e-9));
+      REQUIRE_THAT(correlations[ivert].get(0, 0), WithinAbs(1., 1e-9));
+    }
+  }
+}
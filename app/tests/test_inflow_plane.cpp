@@ -0,0 +1,119 @@
+#include "common.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stg/spectral_method/stg_inflow.h>
+
+struct InflowPlaneFixture {
+  const std::size_t plane_n = 16;
+  const double time = 0.5;
+  const double time_step = 0.01;
+
+  SpectralParameters<double> parameters = [] {
+    SpectralParameters<double> result;
+    result.n_spectra = 20;
+    result.n_fourier = 40;
+    return result;
+  }();
+  std::shared_ptr<ISpectra<double>> spectra = std::make_shared<VonKarmanSpectra<double>>(1, 100, 40);
+
+  std::vector<Point<double>> face_points() const {
+    std::vector<Point<double>> points;
+    for (std::size_t j = 0; j < plane_n; ++j) {
+      for (std::size_t i = 0; i < plane_n; ++i) {
+        points.push_back({0., 0.1 * i, 0.1 * j});
+      }
+    }
+    return points;
+  }
+
+  PhasorTimeStepper<double> reference_stepper() const {
+    SpectralGeneratorV2<double> generator{parameters};
+    generator.initialize_spectra(spectra);
+    generator.initialize_wave_vector_amplitudes(parameters.k_min, parameters.k_max, parameters.n_spectra);
+    generator.initialize_random_coefficients();
+    generator.initialize_inner_generators();
+    return generator.time_stepper(face_points(), time, time_step);
+  }
+};
+
+SCENARIO_METHOD(InflowPlaneFixture, "Inflow plane hands out consecutive steps") {
+  GIVEN("Inflow plane generator and the stepper of the same generator") {
+    InflowPlaneGenerator<double> inflow{parameters, spectra, face_points(), time, time_step};
+    auto reference = reference_stepper();
+    std::vector<Vector<double>> expected(reference.size());
+
+    THEN("Every frame equals the step of the stepper") {
+      double max_error = 0.;
+      bool consecutive = true;
+      bool finite = true;
+      double max_velocity = 0.;
+      for (std::size_t step = 0; step < 600; ++step) {
+        reference.step(expected);
+        const auto frame = inflow.next();
+        consecutive = consecutive && frame.step == step && frame.time == time + step * time_step;
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+          for (const double value: {frame.velocities[i].get<0>(), frame.velocities[i].get<1>(), frame.velocities[i].get<2>()}) {
+            finite = finite && std::isfinite(value);
+            max_velocity = std::max(max_velocity, std::abs(value));
+          }
+          max_error = std::max({max_error,
+                                std::abs(frame.velocities[i].get<0>() - expected[i].get<0>()),
+                                std::abs(frame.velocities[i].get<1>() - expected[i].get<1>()),
+                                std::abs(frame.velocities[i].get<2>() - expected[i].get<2>())});
+        }
+      }
+      REQUIRE(consecutive);
+      REQUIRE(finite);
+      REQUIRE(max_velocity > 0.);
+      REQUIRE(max_error == 0.);
+      REQUIRE(inflow.latency().max_compute >= inflow.latency().last_compute);
+    }
+  }
+}
+
+SCENARIO_METHOD(InflowPlaneFixture, "Inflow plane through the C interface") {
+  GIVEN("Handle created with the default parameters") {
+    stg_inflow_parameters c_parameters = stg_inflow_default_parameters();
+    c_parameters.n_spectra = parameters.n_spectra;
+    c_parameters.n_fourier = parameters.n_fourier;
+    std::vector<double> points;
+    for (const auto& point: face_points()) {
+      points.insert(points.end(), {point.get<0>(), point.get<1>(), point.get<2>()});
+    }
+    stg_inflow* inflow = stg_inflow_create(&c_parameters, points.data(), plane_n * plane_n, time, time_step);
+    REQUIRE(inflow != nullptr);
+    REQUIRE(stg_inflow_size(inflow) == plane_n * plane_n);
+
+    THEN("Interleaved velocities equal the first step") {
+      auto reference = reference_stepper();
+      std::vector<Vector<double>> expected(reference.size());
+      reference.step(expected);
+
+      std::vector<double> velocities(3 * plane_n * plane_n);
+      double step_time = 0.;
+      REQUIRE(stg_inflow_next(inflow, velocities.data(), &step_time) == STG_INFLOW_OK);
+      REQUIRE(step_time == time);
+      REQUIRE(std::ranges::all_of(velocities, [](double value) { return std::isfinite(value); }));
+      REQUIRE(std::ranges::any_of(velocities, [](double value) { return value != 0.; }));
+      for (std::size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(velocities[3 * i] == expected[i].get<0>());
+        REQUIRE(velocities[3 * i + 2] == expected[i].get<2>());
+      }
+    }
+
+    THEN("Null arguments are reported") {
+      REQUIRE(stg_inflow_next(inflow, nullptr, nullptr) == STG_INFLOW_INVALID_ARGUMENT);
+      REQUIRE(std::string{stg_inflow_last_error()}.size() > 0);
+      REQUIRE(stg_inflow_create(nullptr, points.data(), 1, 0., 1.) == nullptr);
+    }
+
+    THEN("Spectrum without energy between k_min and k_max is rejected") {
+      stg_inflow_parameters empty_spectrum = c_parameters;
+      empty_spectrum.k_e = 0.1, empty_spectrum.k_eta = 10., empty_spectrum.k_cut = 0.1;
+      REQUIRE(stg_inflow_create(&empty_spectrum, points.data(), plane_n * plane_n, time, time_step) == nullptr);
+      REQUIRE(std::string{stg_inflow_last_error()} == "Spectrum has no energy between k_min and k_max");
+    }
+
+    stg_inflow_destroy(inflow);
+  }
+}
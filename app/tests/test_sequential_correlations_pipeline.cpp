@@ -0,0 +1,93 @@
+#include "common.hpp"
+#include "stg/spectral_method/sequential_analysis.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+struct SequentialCorrelationsPipelineFixture {
+    const fs::path dir = fs::temp_directory_path() / "stg_sequential_correlations";
+    const std::size_t files = 7;
+    const std::shared_ptr<CubeFiniteElementsMesh<double>> mesh = CubeMeshBuilder<double>{2., 5}.build();
+    std::vector<VelocityField<double>> fields;
+
+    SequentialCorrelationsPipelineFixture() {
+        fs::create_directories(dir);
+        std::mt19937_64 engine{7};
+        std::normal_distribution<double> distribution;
+        for (std::size_t ifile = 0; ifile < files; ++ifile) {
+            std::vector<Vector<double>> velocities(mesh->n_vertices());
+            for (auto& velocity: velocities) {
+                velocity = Vector<double>{distribution(engine), distribution(engine), distribution(engine)};
+            }
+            fields.emplace_back(velocities);
+            VtkRectilinearGridSaver saver{(dir / fmt::format("velocity_field_{}.vtk", ifile)).string()};
+            saver.save_mesh(mesh->relation_table());
+            saver.save_velocity_data(fields.back().values_view(), "VelocityField");
+        }
+    }
+
+    ~SequentialCorrelationsPipelineFixture() { fs::remove_all(dir); }
+
+    Tensor<double> expected(std::size_t ivert) const {
+        std::array<double, 9> sum{};
+        for (const auto& field: fields) {
+            const auto center = field.value(mesh->center_lin_index());
+            const auto value = field.value(ivert);
+            const std::array<double, 3> v{value.get<0>(), value.get<1>(), value.get<2>()};
+            const std::array<double, 3> c{center.get<0>(), center.get<1>(), center.get<2>()};
+            for (std::size_t i = 0; i < 3; ++i) {
+                for (std::size_t j = 0; j < 3; ++j) {
+                    sum[3 * i + j] += v[i] * c[j] / files;
+                }
+            }
+        }
+        return Tensor<double>{sum};
+    }
+};
+
+SCENARIO_METHOD(SequentialCorrelationsPipelineFixture, "Prefetching correlations over the files") {
+    for (const auto [readers, accumulators]: {std::pair{1ul, 1ul}, std::pair{3ul, 2ul}, std::pair{8ul, 4ul}}) {
+        SequentialCorrelations<double> analyser{stg::spectral::DataLoader{dir.string() + "/"}, "velocity_field_0.vtk", readers, accumulators};
+        analyser.calc_covariations_for_amount(files);
+
+        const auto& correlations = analyser.correlations();
+        REQUIRE(correlations.size() == mesh->n_vertices());
+        for (std::size_t ivert = 0; ivert < correlations.size(); ivert += 11) {
+            const auto expected_tensor = expected(ivert);
+            for (std::size_t component = 0; component < 9; ++component) {
+                REQUIRE_THAT(correlations[ivert].get(component / 3, component % 3),
+                             WithinAbs(expected_tensor.get(component / 3, component % 3), 1e-9));
+            }
+        }
+    }
+
+    THEN("A missing file fails the run") {
+        SequentialCorrelations<double> analyser{stg::spectral::DataLoader{dir.string() + "/"}, "velocity_field_0.vtk", 2, 2};
+        REQUIRE_THROWS(analyser.calc_covariations_for_amount(files + 3));
+    }
+
+    THEN("The correlations streamed from a sample store are the ones of the files") {
+        {
+            SampleStoreWriter<double> writer{dir / "samples.stg", 5, 2.};
+            for (const auto& field: fields) {
+                writer.append(field);
+            }
+        }
+        SequentialCorrelations<double> analyser{stg::spectral::DataLoader{dir.string() + "/"}, "velocity_field_0.vtk"};
+        analyser.calc_covariations_from_store("samples.stg");
+
+        const auto& correlations = analyser.correlations();
+        for (std::size_t ivert = 0; ivert < correlations.size(); ivert += 11) {
+            const auto expected_tensor = expected(ivert);
+            for (std::size_t component = 0; component < 9; ++component) {
+                REQUIRE_THAT(correlations[ivert].get(component / 3, component % 3),
+                             WithinAbs(expected_tensor.get(component / 3, component % 3), 1e-9));
+            }
+        }
+    }
+
+    THEN("No files is an error, not a NaN average") {
+        SequentialCorrelations<double> analyser{stg::spectral::DataLoader{dir.string() + "/"}, "velocity_field_0.vtk", 2, 2};
+        REQUIRE_THROWS_AS(analyser.calc_covariations_for_amount(0), std::invalid_argument);
+    }
+}
@@ -1,4 +1,11 @@
 #include "common.hpp"
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <chrono>
+#include <map>
+#include <string_view>
+#include <thread>
+#include <utility>
 
 struct SpectralAppFixture {
   const double edge_len = 2.;
@@ -16,3 +23,114 @@ SCENARIO_METHOD(SpectralAppFixture, "Simple generation procedure to check algos"
 
   spectral_generation_method.save_to_vtk(filename);
 }
+
+SCENARIO("Ensemble samples are independent and reproducible realizations") {
+  const auto config = mock::MakeDefaultSpectralConfig(0.01, 1.5, 50);
+  SpectralMethodApplicationImpl<double> first{2., 11, config, 16};
+  SpectralMethodApplicationImpl<double> second{2., 11, config, 16};
+
+  first.generate_samples_on_mesh(0);
+  second.generate_samples_on_mesh(0);
+
+  const auto& samples = first.velocity_samples();
+  REQUIRE(samples.size() == 16);
+
+  THEN("The same sample of the same configuration is the same whatever thread made it") {
+    for (std::size_t isample = 0; isample < samples.size(); ++isample) {
+      for (std::size_t ivert = 0; ivert < samples.sample(isample).size(); ivert += 37) {
+        REQUIRE(samples.sample(isample).value(ivert).get<0>() == second.velocity_samples().sample(isample).value(ivert).get<0>());
+      }
+    }
+  }
+
+  THEN("Different samples are different realizations") {
+    REQUIRE(samples.sample(0).value(5).get<0>() != samples.sample(1).value(5).get<0>());
+  }
+}
+
+SCENARIO("Ensemble moments with the samples first touched by a pinned pool") {
+  const auto config = mock::MakeDefaultSpectralConfig(0.01, 1.5, 50);
+  SpectralMethodApplicationImpl<double> shared{2., 11, config, 16, 3};
+  SpectralMethodApplicationImpl<double> pinned{2., 11, config, 16, 3, utility::Affinity::pinned};
+
+  shared.generate_samples_on_mesh(0);
+  pinned.generate_samples_on_mesh(0);
+  const auto moments = pinned.samples_moments();
+
+  THEN("Samples and moments don't depend on the pool") {
+    const auto shared_moments = shared.samples_moments();
+    REQUIRE(moments.size() == shared_moments.size());
+    for (std::size_t ivert = 0; ivert < moments.size(); ivert += 37) {
+      REQUIRE(pinned.velocity_samples().sample(3).value(ivert).get<2>() == shared.velocity_samples().sample(3).value(ivert).get<2>());
+      REQUIRE(moments[ivert].sums == shared_moments[ivert].sums);
+      REQUIRE(moments[ivert].products == shared_moments[ivert].products);
+    }
+  }
+
+  THEN("Moments of a vertex are the ones of its ensemble") {
+    const auto& samples = pinned.velocity_samples();
+    for (std::size_t ivert = 0; ivert < moments.size(); ivert += 37) {
+      std::vector<double> ensemble(samples.size());
+      for (std::size_t isample = 0; isample < samples.size(); ++isample) {
+        ensemble[isample] = samples.sample(isample).value(ivert).get<1>();
+      }
+      REQUIRE(moments[ivert].size == samples.size());
+      REQUIRE_THAT(moments[ivert].mean(1), WithinAbs(Mean::mean(ensemble), 1e-12));
+    }
+  }
+}
+
+/*
+ * Bytes of the samples the workers of every NUMA node read per second in samples_moments.
+ * Worker w runs the block w of the Partition::per_worker split of the vertices
+ */
+void print_node_bandwidth(std::string_view name, const SpectralMethodApplicationImpl<double>& app) {
+  constexpr std::size_t repetitions = 10;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t repetition = 0; repetition < repetitions; ++repetition) {
+    REQUIRE(!app.samples_moments().empty());
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  const auto& samples = app.velocity_samples();
+  const std::size_t vertices = samples.sample(0).size();
+  const std::size_t vertex_bytes = 3 * samples.size() * sizeof(double);
+  const auto& pool = app.thread_pool();
+  const std::size_t workers = pool.size();
+  // Node -> (bytes, workers)
+  std::map<std::size_t, std::pair<std::size_t, std::size_t>> nodes;
+  for (std::size_t worker = 0; worker < workers; ++worker) {
+    const std::size_t block = vertices * (worker + 1) / workers - vertices * worker / workers;
+    auto& [bytes, node_workers] = nodes[pool.worker_node(worker)];
+    bytes += repetitions * block * vertex_bytes;
+    ++node_workers;
+  }
+  for (const auto& [node, load]: nodes) {
+    fmt::print("{}, node {}: {} workers, {:.2f} GB/s\n", name, node, load.second, static_cast<double>(load.first) / elapsed.count() / 1e9);
+  }
+}
+
+/*
+ * Per vertex ensemble moments over the samples first touched by the main thread (global pool)
+ * and by the workers of a pinned pool, with the bandwidth of every NUMA node.
+ * Run with the [benchmark] tag on a multi socket node
+ */
+SCENARIO("Ensemble moments on the global and on a pinned pool benchmark", "[.][benchmark]") {
+  const auto config = mock::MakeDefaultSpectralConfig(0.01, 1.5, 50);
+  const std::size_t threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+  SpectralMethodApplicationImpl<double> shared{2., 41, config, 32, threads};
+  SpectralMethodApplicationImpl<double> pinned{2., 41, config, 32, threads, utility::Affinity::pinned};
+  shared.generate_samples_on_mesh(0);
+  pinned.generate_samples_on_mesh(0);
+
+  BENCHMARK("Global pool, samples touched by the main thread") {
+    return shared.samples_moments();
+  };
+
+  BENCHMARK("Pinned pool, samples first touched by the workers") {
+    return pinned.samples_moments();
+  };
+
+  print_node_bandwidth("Global pool", shared);
+  print_node_bandwidth("Pinned pool", pinned);
+}
@@ -1,4 +1,6 @@
 #include "common.hpp"
+#include <algorithm>
+#include <cmath>
 #include <fmt/core.h>
 #include <fmt/format.h>
 #include <fmt/os.h>
@@ -34,5 +36,147 @@ SCENARIO_METHOD(SpectralMethodApplicationTestFixture, "Generate samples along ti
     //   application.generate_velocity_field(time_moment);
     //   application.save_data_to(fmt::format(path_template, time_index), table_name);
     //   time_moment += tau;
-    // }
-}
\ No newline at end of file
+    // }
+}
+SCENARIO("Time series through the asynchronous writer") {
+    SpectralParameters<double> parameters{};
+    parameters.n_spectra = 20, parameters.n_fourier = 50, parameters.edge_points = 11;
+    const fs::path directory = fs::temp_directory_path() / "stg_time_series";
+    fs::create_directories(directory);
+    const std::string path_template = (directory / "field_t{}.vtk").string();
+
+    SpectralMethodApplication<double> application{stg::spectral::DataLoader{directory}, parameters, std::make_shared<VonKarmanSpectra<double>>(1, 100, 40)};
+    REQUIRE(application.stage_timings().size() == 5);
+
+    const std::vector<double> times{0., 0.5, 1., 1.5};
+    const auto& timings = application.generate_time_series(times, path_template);
+
+    THEN("The generated field is finite and non-zero") {
+        application.save_data_to(directory / "current.raw");
+        std::vector<double> values(3 * 11 * 11 * 11);
+        std::ifstream file{directory / "current.raw", std::ios::binary};
+        file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(double)));
+        REQUIRE(file.gcount() == static_cast<std::streamsize>(values.size() * sizeof(double)));
+        REQUIRE(std::ranges::all_of(values, [](double value) { return std::isfinite(value); }));
+        REQUIRE(std::ranges::any_of(values, [](double value) { return value != 0.; }));
+    }
+
+    THEN("Every field is saved after it's generated") {
+        REQUIRE(timings.size() == 2 * times.size());
+        for (std::size_t index = 0; index < times.size(); ++index) {
+            REQUIRE(fs::exists(fmt::format(fmt::runtime(path_template), index)));
+            REQUIRE(timings[2 * index + 1].start >= timings[2 * index].start + timings[2 * index].duration);
+        }
+    }
+
+    THEN("The current field is the last one of the series") {
+        const auto read = [](const fs::path& path) {
+            std::ifstream file{path};
+            return std::string{std::istreambuf_iterator<char>{file}, {}};
+        };
+        application.save_data_to(directory / "current.vtk", "VelocityField3");
+        REQUIRE(read(directory / "current.vtk") == read(fmt::format(fmt::runtime(path_template), times.size() - 1)));
+
+        application.generate_velocity_field(times.back());
+        application.save_data_to(directory / "regenerated.vtk", "VelocityField3");
+        REQUIRE(read(directory / "regenerated.vtk") == read(directory / "current.vtk"));
+    }
+
+    THEN("A .vtr path is saved as an XML grid") {
+        application.save_data_to(directory / "current.vtr");
+        REQUIRE(fs::file_size(directory / "current.vtr") > 3 * 11 * 11 * 11 * sizeof(double));
+    }
+
+    THEN("A .raw path is saved as the raw components") {
+        application.generate_time_series(times, (directory / "field_t{}.raw").string(), "VelocityField{}", 3);
+        REQUIRE(fs::file_size(directory / "field_t3.raw") == 3 * 11 * 11 * 11 * sizeof(double));
+    }
+
+    fs::remove_all(directory);
+}
+
+SCENARIO("Generate, analyze and save through the stage graph") {
+    SpectralParameters<double> parameters{};
+    parameters.n_spectra = 20, parameters.n_fourier = 50, parameters.edge_points = 11;
+    const fs::path directory = fs::temp_directory_path() / "stg_pipeline";
+    fs::create_directories(directory);
+
+    SpectralMethodApplication<double> application{stg::spectral::DataLoader{directory}, parameters, std::make_shared<VonKarmanSpectra<double>>(1, 100, 40)};
+    const std::vector<fs::path> paths{directory / "field.vtk", directory / "field.vtr", directory / "field.raw"};
+    const auto moments = application.run_pipeline(0.5, paths);
+    const auto& timings = application.stage_timings();
+
+    THEN("The statistics and every writer follow the generation") {
+        REQUIRE(timings.size() == 2 + paths.size());
+        REQUIRE(timings[0].name == "generate_velocity_field");
+        const auto generated = timings[0].start + timings[0].duration;
+        for (std::size_t index = 1; index < timings.size(); ++index) {
+            REQUIRE(timings[index].start >= generated);
+        }
+        for (const auto& path: paths) {
+            REQUIRE(fs::exists(path));
+        }
+    }
+
+    THEN("The moments are the ones of the saved field") {
+        std::vector<double> values(3 * 11 * 11 * 11);
+        std::ifstream file{directory / "field.raw", std::ios::binary};
+        file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(double)));
+        const std::size_t vertices = values.size() / 3;
+        REQUIRE(moments.size == vertices);
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            const std::span<const double> component{values.data() + axis * vertices, vertices};
+            REQUIRE(std::ranges::all_of(component, [](double value) { return std::isfinite(value); }));
+            REQUIRE_THAT(moments.mean(axis), WithinAbs(Mean::mean(component), 1e-12));
+        }
+        REQUIRE(moments.std(0, moments.mean(0)) > 0.);
+    }
+
+    fs::remove_all(directory);
+}
+
+namespace {
+    // Format slower than the generation, counts the writes
+    struct SlowFieldFormat final : IFieldFormat<double> {
+        mutable std::atomic<std::size_t> writes = 0;
+        mutable std::atomic<bool> fail = false;
+        mutable std::atomic<bool> ordered = true;
+
+        void write(const VelocityField<double>& field, const std::filesystem::path&, std::string_view) const override {
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            if (fail) { throw std::runtime_error("Disk is full"); }
+            if (field.value(0).get<0>() != static_cast<double>(writes)) { ordered = false; }
+            ++writes;
+        }
+    };
+}
+
+SCENARIO("Asynchronous field writer holds the producer back") {
+    auto format = std::make_shared<SlowFieldFormat>();
+    AsyncFieldWriter<double> writer{format, 10, 2};
+
+    for (std::size_t index = 0; index < 6; ++index) {
+        auto& frame = writer.acquire();
+        frame.field.set_value(static_cast<double>(index), 0., 0., 0);
+        writer.submit(frame, fmt::format("field_{}", index), "VelocityField");
+    }
+    writer.flush();
+
+    THEN("The fields are written in order with at most two buffers") {
+        REQUIRE(format->writes == 6);
+        REQUIRE(format->ordered);
+        REQUIRE(writer.stalls() >= 3);
+        const auto timings = writer.timings();
+        REQUIRE(timings.size() == 6);
+        for (std::size_t index = 1; index < timings.size(); ++index) {
+            REQUIRE(timings[index].start >= timings[index - 1].start + timings[index - 1].duration);
+        }
+    }
+
+    THEN("A failed write is rethrown by flush") {
+        format->fail = true;
+        writer.submit(writer.acquire(), "field_failed", "VelocityField");
+        REQUIRE_THROWS_AS(writer.flush(), std::runtime_error);
+        writer.flush();
+    }
+}
@@ -8,6 +8,7 @@
 #include "fem/fe_factory.hpp"
 #include "rtable/vtk_saver.hpp"
 #include "rtable/cube_vtk_saver.hpp"
+#include "rtable/vtr_saver.hpp"
 #include "fem/fe_element_crtp.hpp"
 
 #endif //STG_FEM_HPP
@@ -8,8 +8,6 @@ namespace stg::mesh {
 
   template<std::floating_point T>
   class VoxelFiniteElement final : public LagrangianFiniteElement<T, 8> {
-    using BasisFunctions = std::array<std::function<double(Point<T>)>, 8>;
-    using BasisFunctionsGradients = std::array<std::function<Vector<T>(Point<T>)>, 8>;
   public:
     using value_type = LagrangianFiniteElement<T, 8>::value_type;
 //    using LagrangianFiniteElement<T, 8>::lumped;
@@ -56,14 +54,11 @@ namespace stg::mesh {
       if (values.size() != 8) {
         throw std::logic_error("The array of values has the wrong size");
       }
+      const auto weights = basis_values(param_point);
       value_type result = 0;
-      auto val_iter = values.cbegin();
-      std::for_each(basis_functions_.cbegin(), basis_functions_.cend(), [&](const auto& basis_func) {
-        value_type node_weight = basis_func(param_point);
-        value_type value = *val_iter;
-        result += node_weight * value;
-        val_iter++;
-      });
+      for (std::size_t node = 0; node < weights.size(); ++node) {
+        result += weights[node] * values[node];
+      }
       return result;
     }
 
@@ -110,12 +105,7 @@ namespace stg::mesh {
      * Return values of gradients of basis function in given point
      */
     std::array<Vector<T>, 8> basis_gradients_at_point(Point<T> point) const override {
-      std::array<Vector<T>, 8> result;
-      for (size_t k = 0; const auto& grad_func : basis_functions_gradients_) {
-        result[k] = grad_func(point);
-        k++;
-      }
-      return result;
+      return basis_gradients(point);
     }
 
     /*
@@ -139,66 +129,35 @@ namespace stg::mesh {
     const T dy_;
     const T dz_;
     const T det_j_;
-    static inline const BasisFunctions basis_functions_{
-      [](Point<T> point) { return (1 - point.template get<0>()) * (1 - point.template get<1>()) * (1 - point.template get<2>()); },
-      [](Point<T> point) { return point.template get<0>() * (1 - point.template get<1>()) * (1 - point.template get<2>()); },
-      [](Point<T> point) { return point.template get<0>() * point.template get<1>() * (1 - point.template get<2>()); },
-      [](Point<T> point) { return (1 - point.template get<0>()) * point.template get<1>() * (1 - point.template get<2>()); },
-      [](Point<T> point) { return (1 - point.template get<0>()) * (1 - point.template get<1>()) * point.template get<2>(); },
-      [](Point<T> point) { return point.template get<0>() * (1 - point.template get<1>()) * point.template get<2>(); },
-      [](Point<T> point) { return point.template get<0>() * point.template get<1>() * point.template get<2>(); },
-      [](Point<T> point) { return (1 - point.template get<0>()) * point.template get<1>() * point.template get<2>(); },
-    };
-    static inline const BasisFunctionsGradients basis_functions_gradients_{
-      [](Point<T> point) -> Vector<T> {
-        return {
-          - ((1 - point.template get<2>()) * (1 - point.template get<1>())),
-          - ((1 - point.template get<2>()) * (1 - point.template get<0>())),
-          - ((1 - point.template get<1>()) * (1 - point.template get<0>()))
-        }; },
-      [](Point<T> point) -> Vector<T> {
-        return {
-          ((1 - point.template get<2>()) * (1 - point.template get<1>())),
-          - ((1 - point.template get<2>()) * point.template get<0>()),
-          - ((1 - point.template get<1>()) * point.template get<0>())
-        }; },
-      [](Point<T> point) -> Vector<T> {
-        return {
-          (1 - point.template get<2>()) * point.template get<1>(),
-          (1 - point.template get<2>()) * point.template get<0>(),
-          (-point.template get<1>() * point.template get<0>())
-        }; },
-      [](Point<T> point) -> Vector<T> {
-        return {
-          - ((1 - point.template get<2>()) * point.template get<1>()),
-          (1 - point.template get<2>()) * (1 - point.template get<0>  ()),
-          - point.template get<1>() * (1 - point.template get<0>())
-        }; },
-      [](Point<T> point) -> Vector<T> {
-        return {
-          - point.template get<2>() * (1 - point.template get<1>()),
-          - point.template get<2>() * (1 - point.template get<0>()),
-          (1 - point.template get<1>()) * (1 - point.template get<0>())
-        }; },
-      [](Point<T> point) -> Vector<T> {
-        return {
-          point.template get<2>() * (1 - point.template get<1>()),
-          -point.template get<0>() * point.template get<2>(),
-          (1 - point.template get<1>()) * point.template get<0>()
-        }; },
-      [](Point<T> point) -> Vector<T> {
-        return {
-          point.template get<2>() * point.template get<1>(),
-          point.template get<2>() * point.template get<0>(),
-          point.template get<1>() * point.template get<0>()
-        }; },
-      [](Point<T> point) -> Vector<T> {
-        return {
-          - point.template get<2>() * point.template get<1>(),
-          point.template get<2>() * (1 - point.template get<0>()),
-          point.template get<1>() * (1 - point.template get<0>())
-        }; },
-    };
+
+    /*
+     * Trilinear basis functions and their gradients at the param point, plain
+     * functions instead of arrays of std::function, so they are inlined into the loops
+     */
+    static std::array<value_type, 8> basis_values(const Point<T>& point) noexcept {
+      const value_type x = point.template get<0>();
+      const value_type y = point.template get<1>();
+      const value_type z = point.template get<2>();
+      return {(1 - x) * (1 - y) * (1 - z), x * (1 - y) * (1 - z), x * y * (1 - z), (1 - x) * y * (1 - z),
+              (1 - x) * (1 - y) * z, x * (1 - y) * z, x * y * z, (1 - x) * y * z};
+    }
+
+    static std::array<Vector<T>, 8> basis_gradients(const Point<T>& point) noexcept {
+      const value_type x = point.template get<0>();
+      const value_type y = point.template get<1>();
+      const value_type z = point.template get<2>();
+      return {
+        Vector<T>{-(1 - z) * (1 - y), -(1 - z) * (1 - x), -(1 - y) * (1 - x)},
+        Vector<T>{(1 - z) * (1 - y), -(1 - z) * x, -(1 - y) * x},
+        Vector<T>{(1 - z) * y, (1 - z) * x, -y * x},
+        Vector<T>{-(1 - z) * y, (1 - z) * (1 - x), -y * (1 - x)},
+        Vector<T>{-z * (1 - y), -z * (1 - x), (1 - y) * (1 - x)},
+        Vector<T>{z * (1 - y), -x * z, (1 - y) * x},
+        Vector<T>{z * y, z * x, y * x},
+        Vector<T>{-z * y, z * (1 - x), y * (1 - x)}
+      };
+    }
+
     using LagrangianFiniteElement<T, 8>::global_indices_;
     using LagrangianFiniteElement<T, 8>::lumped_;
     using LagrangianFiniteElement<T, 8>::base_point_;
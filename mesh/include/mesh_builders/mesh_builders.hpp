@@ -7,11 +7,11 @@
 #include "rtable/i_relation_table.hpp"
 #include <concepts>
 #include <execution>
-#include <future>
 #include <iostream>
 #include <memory>
 #include <range/v3/all.hpp>
 #include <ranges>
+#include <stg_thread_pool/task_group.hpp>
 #include <syncstream>
 #include <thread>
 #include <vector>
@@ -40,9 +40,9 @@ namespace stg::mesh {
               nx_{nx}, ny_{ny}, nz_{nz} {}
 
         [[nodiscard("Heavy object construction")]] std::shared_ptr<CubePrizmRelationTable<value_type>> build_relation_table() const {
-            auto vert_future = std::async(std::launch::async, &CubePrizmMeshBuilder::assemble_vertices, this);
-            auto bound_ind_future = std::async(std::launch::async, &CubePrizmMeshBuilder::assemble_bounds_indices, this);
-            auto element_types_future = std::async(std::launch::async, &CubePrizmMeshBuilder::assemble_element_types, this);
+            auto vert_future = utility::spawn([this] { return assemble_vertices(); });
+            auto bound_ind_future = utility::spawn([this] { return assemble_bounds_indices(); });
+            auto element_types_future = utility::spawn([this] { return assemble_element_types(); });
             auto&& vertices = vert_future.get();
             auto&& bound_indices = bound_ind_future.get();
             auto&& element_types = element_types_future.get();
@@ -161,9 +161,9 @@ namespace stg::mesh {
         CubeMeshBuilder(T l, std::size_t n) : l_{l}, n_{n} {}
 
         [[nodiscard("Heavy object construction")]] std::shared_ptr<CubeRelationTable<value_type>> build_relation_table() const {
-            auto vert_future = std::async(std::launch::async, &CubeMeshBuilder::assemble_vertices, this);
-            auto bound_ind_future = std::async(std::launch::async, &CubeMeshBuilder::assemble_bounds_indices, this);
-            auto element_types_future = std::async(std::launch::async, &CubeMeshBuilder::assemble_element_types, this);
+            auto vert_future = utility::spawn([this] { return assemble_vertices(); });
+            auto bound_ind_future = utility::spawn([this] { return assemble_bounds_indices(); });
+            auto element_types_future = utility::spawn([this] { return assemble_element_types(); });
             auto&& vertices = vert_future.get();
             auto&& bound_indices = bound_ind_future.get();
             auto&& element_types = element_types_future.get();
@@ -2,7 +2,9 @@
 #define STG_CUBE_VTK_SAVER_HPP
 
 #include "cube_relation_table.hpp"
-#include <execution>
+#include "vtk_data_type.hpp"
+#include "vtk_data_writer.hpp"
+#include <algorithm>
 #include <filesystem>
 #include <fmt/core.h>
 #include <fmt/format.h>
@@ -13,6 +15,7 @@
 #include <iostream>
 #include <iterator>
 #include <stg_tensor/tensor.hpp>
+#include <stdexcept>
 #include <string_view>
 
 
@@ -20,8 +23,12 @@ namespace stg::mesh {
 
     class VtkRectilinearGridSaver final {
     public:
-        VtkRectilinearGridSaver(std::string_view filename)
-            : file_{open_file(filename)} {}
+        /*
+         * The data sections are written through a block buffer, binary stores the raw
+         * big endian values of the legacy format, smaller and much faster to write
+         */
+        VtkRectilinearGridSaver(std::string_view filename, VtkFormat format = VtkFormat::ascii)
+            : file_{open_file(filename)}, format_{format} {}
 
         template<std::floating_point T>
         void save_mesh(const std::shared_ptr<CubeRelationTable<T>>& rtable) {
@@ -36,10 +43,14 @@ namespace stg::mesh {
                               std::string_view table_name = "DefaultTable") {
             const std::size_t size = std::distance(begin, end);
             write_point_data_header(size);
-            file_.print("SCALARS {} double\n", table_name);
-            file_.print("LOOKUP_TABLE default\n");
-            file_.print("{}", fmt::join(begin, end, "\n"));
-            file_.print("\n");
+            fmt::print(file_, "SCALARS {} {}\n", table_name, vtk_data_type<std::iter_value_t<Iter>>());
+            fmt::print(file_, "LOOKUP_TABLE default\n");
+            write_values([begin, end](auto& writer) {
+                std::for_each(begin, end, [&writer](const auto& value) {
+                    writer.put(value);
+                    writer.end_line();
+                });
+            });
         }
 
         template<std::forward_iterator Iter>
@@ -47,26 +58,32 @@ namespace stg::mesh {
                               std::string_view table_name = "VectorField") {
             // const std::size_t size = std::distance(begin, end);
             // write_point_data_header(size);
-            file_.print("VECTORS {} double\n", table_name);
-            std::for_each(begin, end, [&](const auto& vector) {
-                file_.print("{} {} {}\n",
-                            vector.template get<0>(),
-                            vector.template get<1>(),
-                            vector.template get<2>());
+            fmt::print(file_, "VECTORS {} {}\n", table_name,
+                       vtk_data_type<decltype(std::declval<std::iter_value_t<Iter>>().template get<0>())>());
+            write_values([begin, end](auto& writer) {
+                std::for_each(begin, end, [&writer](const auto& vector) {
+                    writer.put(vector.template get<0>());
+                    writer.put(vector.template get<1>());
+                    writer.put(vector.template get<2>());
+                    writer.end_line();
+                });
             });
-            file_.print("\n");
         }
 
         template<std::ranges::viewable_range Range>
         void save_vector_data(Range&& range, std::string_view table_name = "VectorField") {
             const std::size_t size = std::ranges::distance(range);
             write_point_data_header(size);
-            file_.print("VECTORS {} double\n", table_name);
-            std::ranges::for_each(std::forward<Range>(range),
-                                  [&](const auto& vector) {
-                                      file_.print("{} {} {}\n", std::get<0>(vector), std::get<1>(vector), std::get<2>(vector));
-                                  });
-            file_.print("\n");
+            fmt::print(file_, "VECTORS {} {}\n", table_name,
+                       vtk_data_type<decltype(std::get<0>(std::declval<std::ranges::range_reference_t<Range>>()))>());
+            write_values([&range](auto& writer) {
+                std::ranges::for_each(range, [&writer](const auto& vector) {
+                    writer.put(std::get<0>(vector));
+                    writer.put(std::get<1>(vector));
+                    writer.put(std::get<2>(vector));
+                    writer.end_line();
+                });
+            });
         }
 
         template<ranges::viewable_range Range>
@@ -74,12 +91,17 @@ namespace stg::mesh {
                                 std::string_view table_name = "VectorField") {
             const std::size_t size = ranges::distance(range);
             write_point_data_header(size);
-            file_.print("VECTORS {} double\n", table_name);
-            ranges::for_each(range, [&](const auto& vec_zip) {
-                const auto [x, y, z] = vec_zip;
-                file_.print("{} {} {}\n", x, y, z);
+            fmt::print(file_, "VECTORS {} {}\n", table_name,
+                       vtk_data_type<decltype(std::get<0>(std::declval<ranges::range_reference_t<Range>>()))>());
+            write_values([&range](auto& writer) {
+                ranges::for_each(range, [&writer](const auto& vec_zip) {
+                    const auto [x, y, z] = vec_zip;
+                    writer.put(x);
+                    writer.put(y);
+                    writer.put(z);
+                    writer.end_line();
+                });
             });
-            file_.print("\n");
         }
 
         template<std::forward_iterator Iter>
@@ -87,37 +109,55 @@ namespace stg::mesh {
                               std::string_view table_name = "TensorData") {
             const std::size_t size = std::distance(begin, end);
             write_point_data_header(size);
-            file_.print("TENSORS {} double\n", table_name);
-            std::for_each(begin, end, [&](const auto& tensor) {
-                file_.print("{}", fmt::join(tensor.cbegin(), tensor.cend(), " "));
-                file_.print("\n");
+            fmt::print(file_, "TENSORS {} {}\n", table_name,
+                       vtk_data_type<typename std::iter_value_t<Iter>::value_type>());
+            write_values([begin, end](auto& writer) {
+                std::for_each(begin, end, [&writer](const auto& tensor) {
+                    std::for_each(tensor.cbegin(), tensor.cend(), [&writer](auto value) { writer.put(value); });
+                    writer.end_line();
+                });
             });
-            file_.print("\n");
         }
 
         ~VtkRectilinearGridSaver() {}
 
     private:
-        fmt::ostream file_;
+        std::ofstream file_;
+        const VtkFormat format_;
         mutable bool has_point_data_flag_ = false;
 
-        fmt::ostream open_file(std::string_view filename) {
-            return fmt::output_file(filename.data(),
-                                    fmt::file::CREATE | fmt::file::WRONLY | fmt::file::APPEND);
+        static std::ofstream open_file(std::string_view filename) {
+            std::ofstream file{std::string{filename}, std::ios_base::out | std::ios_base::app | std::ios_base::binary};
+            if (!file) {
+                throw std::runtime_error(fmt::format("Can't open {} to save the grid", filename));
+            }
+            return file;
+        }
+
+        // Section values through the block writer, a new line ends the section
+        template<typename Write>
+        void write_values(Write&& write) {
+            {
+                detail::VtkValueWriter writer{file_, format_};
+                write(writer);
+            }
+            file_.put('\n');
+            file_.flush();
         }
 
         void write_header(std::size_t dimensions) {
-            file_.print("# vtk DataFile Version 2.0\n"
-                        "Function\n"
-                        "ASCII\n"
-                        "DATASET RECTILINEAR_GRID\n"
-                        "DIMENSIONS {} {} {}\n",
-                        dimensions, dimensions, dimensions);
+            fmt::print(file_,
+                       "# vtk DataFile Version 2.0\n"
+                       "Function\n"
+                       "{}\n"
+                       "DATASET RECTILINEAR_GRID\n"
+                       "DIMENSIONS {} {} {}\n",
+                       vtk_format_name(format_), dimensions, dimensions, dimensions);
         }
 
         void write_point_data_header(std::size_t size) {
             if (!has_point_data_flag_) {
-                file_.print("POINT_DATA {}\n", size);
+                fmt::print(file_, "POINT_DATA {}\n", size);
                 has_point_data_flag_ = true;
             }
         }
@@ -133,40 +173,13 @@ namespace stg::mesh {
         void write_coordinate_component(Iter begin, Iter end,
                                         std::size_t points_num,
                                         std::string_view component) {
-            file_.print("{}_COORDINATES {} double\n", component, points_num);
-            file_.print("{}", fmt::join(begin, end, "\n"));
-            file_.print("\n");
-        }
-
-        template<std::forward_iterator Iter>
-        void write_cell_data(Iter begin, Iter end, size_t elements_amount) {
-            fmt::print(file_, "CELLS {} {}\n", elements_amount, bounded_vertices(begin, end));
-            std::for_each(begin, end, [&](const auto& value) {
-                file_.print("{} {}", value.size(), fmt::join(value, " "));
-                file_.print("\n");
+            fmt::print(file_, "{}_COORDINATES {} {}\n", component, points_num, vtk_data_type<std::iter_value_t<Iter>>());
+            write_values([begin, end](auto& writer) {
+                std::for_each(begin, end, [&writer](const auto& value) {
+                    writer.put(value);
+                    writer.end_line();
+                });
             });
-            file_.print("\n");
-        }
-
-        template<std::forward_iterator Iter>
-        void write_cell_types_data(Iter begin, Iter end, size_t elements_amount) {
-            file_.print("CELL_TYPES {}\n", elements_amount);
-            file_.print("{}", fmt::join(begin, end, "\n"));
-            file_.print("\n");
-        }
-
-        template<std::forward_iterator Iter>
-        size_t bounded_vertices(Iter begin, Iter end) const {
-            auto result = std::transform_reduce(
-                    std::execution::par_unseq,
-                    begin, end, 0ul,
-                    [](auto left, auto right) {
-                        return left + right + 1ul;
-                    },
-                    [](const auto& elem) {
-                        return elem.size();
-                    });
-            return result;
         }
     };
 }// namespace stg::mesh
@@ -0,0 +1,33 @@
+#ifndef STG_VTK_DATA_TYPE_HPP
+#define STG_VTK_DATA_TYPE_HPP
+
+#include <concepts>
+#include <string_view>
+#include <type_traits>
+
+namespace stg::mesh {
+
+    // Legacy VTK data type name of the values written as T
+    template<typename T>
+        requires std::is_arithmetic_v<std::remove_cvref_t<T>>
+    constexpr std::string_view vtk_data_type() noexcept {
+        if constexpr (std::same_as<std::remove_cvref_t<T>, float>) {
+            return "float";
+        } else {
+            return "double";
+        }
+    }
+
+    // XML VTK data type name of the values written as T
+    template<typename T>
+        requires std::is_arithmetic_v<std::remove_cvref_t<T>>
+    constexpr std::string_view vtk_xml_data_type() noexcept {
+        if constexpr (std::same_as<std::remove_cvref_t<T>, float>) {
+            return "Float32";
+        } else {
+            return "Float64";
+        }
+    }
+}// namespace stg::mesh
+
+#endif//STG_VTK_DATA_TYPE_HPP
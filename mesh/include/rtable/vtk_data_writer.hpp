@@ -0,0 +1,120 @@
+#ifndef STG_VTK_DATA_WRITER_HPP
+#define STG_VTK_DATA_WRITER_HPP
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fmt/format.h>
+#include <iterator>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace stg::mesh {
+
+    // Encoding of the data sections of a legacy VTK file, binary is big endian as VTK expects
+    enum class VtkFormat {
+        ascii,
+        binary
+    };
+
+    constexpr std::string_view vtk_format_name(VtkFormat format) noexcept {
+        return format == VtkFormat::ascii ? "ASCII" : "BINARY";
+    }
+
+    namespace detail {
+        template<typename T>
+            requires std::is_arithmetic_v<T>
+        T byteswap(T value) noexcept {
+            using Bits = std::conditional_t<sizeof(T) == 8, std::uint64_t,
+                                            std::conditional_t<sizeof(T) == 4, std::uint32_t,
+                                                               std::conditional_t<sizeof(T) == 2, std::uint16_t, std::uint8_t>>>;
+            auto bits = std::bit_cast<Bits>(value);
+            Bits swapped = 0;
+            for (std::size_t byte = 0; byte < sizeof(T); ++byte, bits >>= 8) {
+                swapped = static_cast<Bits>((swapped << 8) | (bits & 0xff));
+            }
+            return std::bit_cast<T>(swapped);
+        }
+
+        /*
+         * Writes the values of a data section through a block buffer, one large write per
+         * block instead of a formatted write per value. ASCII puts a space between the values
+         * of a line, binary stores the raw values in the byte order given (big endian for
+         * the legacy files) with no separators
+         */
+        class VtkValueWriter final {
+        public:
+            static constexpr std::size_t block_size = std::size_t{1} << 20;
+
+            VtkValueWriter(std::ostream& file, VtkFormat format, std::endian order = std::endian::big)
+                : file_{file}, format_{format}, swap_{order != std::endian::native} {
+                buffer_.reserve(block_size + 64);
+            }
+
+            VtkValueWriter(const VtkValueWriter&) = delete;
+            VtkValueWriter& operator=(const VtkValueWriter&) = delete;
+
+            ~VtkValueWriter() { flush(); }
+
+            template<typename T>
+                requires std::is_arithmetic_v<T>
+            void put(T value) {
+                if (format_ == VtkFormat::ascii) {
+                    if (!line_start_) { buffer_.push_back(' '); }
+                    fmt::format_to(std::back_inserter(buffer_), "{}", value);
+                    line_start_ = false;
+                } else {
+                    // The type named by vtk_data_type
+                    using Stored = std::conditional_t<std::same_as<T, float>, float, double>;
+                    const Stored stored = swap_ ? byteswap(static_cast<Stored>(value)) : static_cast<Stored>(value);
+                    const auto offset = buffer_.size();
+                    buffer_.resize(offset + sizeof(Stored));
+                    std::memcpy(buffer_.data() + offset, &stored, sizeof(Stored));
+                }
+                if (buffer_.size() >= block_size) { flush(); }
+            }
+
+            // Cell connectivity and types, int in the legacy files
+            template<std::integral T>
+            void put_index(T value) {
+                if (format_ == VtkFormat::ascii) {
+                    put(value);
+                    return;
+                }
+                const auto stored = static_cast<std::int32_t>(value);
+                const auto offset = buffer_.size();
+                buffer_.resize(offset + sizeof(stored));
+                const std::int32_t ordered = swap_ ? byteswap(stored) : stored;
+                std::memcpy(buffer_.data() + offset, &ordered, sizeof(ordered));
+                if (buffer_.size() >= block_size) { flush(); }
+            }
+
+            void end_line() {
+                if (format_ == VtkFormat::ascii) {
+                    buffer_.push_back('\n');
+                    line_start_ = true;
+                }
+            }
+
+            void flush() {
+                if (!buffer_.empty()) {
+                    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+                    buffer_.clear();
+                }
+            }
+
+        private:
+            std::ostream& file_;
+            const VtkFormat format_;
+            const bool swap_;
+            bool line_start_ = true;
+            std::vector<char> buffer_;
+        };
+    }// namespace detail
+}// namespace stg::mesh
+
+#endif//STG_VTK_DATA_WRITER_HPP
@@ -14,6 +14,8 @@
 #include <stg_tensor/tensor.hpp>
 #include "i_relation_table.hpp"
 #include "cube_relation_table.hpp"
+#include "vtk_data_type.hpp"
+#include "vtk_data_writer.hpp"
 
 
 namespace stg::mesh {
@@ -34,6 +36,9 @@ namespace stg::mesh {
   public:
     VtkSaver() = default;
 
+    // Binary writes the raw big endian values, the sections go through a block buffer either way
+    explicit VtkSaver(VtkFormat format) : format_{format} {}
+
     template<std::floating_point T>
     void save_mesh(const std::shared_ptr<IRelationTable<T>>& rtable, std::string_view filename) const {
       const auto& vertices = rtable->vertices();
@@ -43,7 +48,7 @@ namespace stg::mesh {
       if (!std::filesystem::exists(path)) {
         std::filesystem::create_directories(path.parent_path());
       }
-      std::ofstream file{path, std::ios_base::out};
+      std::ofstream file{path, std::ios_base::out | std::ios_base::binary};
       write_header(file);
       write_point_data(file, vertices.cbegin(), vertices.cend(), rtable->n_vertices());
       write_cell_data(file, bound_indices.cbegin(), bound_indices.cend(), rtable->n_elements());
@@ -59,15 +64,19 @@ namespace stg::mesh {
       if (!std::filesystem::exists(path)) {
         std::filesystem::create_directories(path.parent_path());
       }
-      std::ofstream file{path, std::ios_base::app};
+      std::ofstream file{path, std::ios_base::app | std::ios_base::binary};
       if (!has_point_data_flag_) {
         fmt::print(file, "POINT_DATA {}\n", std::distance(begin, end));
         has_point_data_flag_ = true;
       }
-      fmt::print(file, "SCALARS {} double\n", table_name);
+      fmt::print(file, "SCALARS {} {}\n", table_name, vtk_data_type<IterValueType>());
       fmt::print(file, "LOOKUP_TABLE default\n");
-      std::copy(begin, end, std::ostream_iterator<IterValueType>{file, "\n"});
-      file << std::endl;
+      write_values(file, [begin, end](auto& writer) {
+        std::for_each(begin, end, [&writer](const IterValueType& value) {
+          writer.put(value);
+          writer.end_line();
+        });
+      });
     }
 
     template<std::forward_iterator Iter>
@@ -78,20 +87,21 @@ namespace stg::mesh {
       if (!std::filesystem::exists(path)) {
         std::filesystem::create_directories(path.parent_path());
       }
-      std::ofstream file{path, std::ios_base::app};
+      std::ofstream file{path, std::ios_base::app | std::ios_base::binary};
       if (!has_point_data_flag_) {
         fmt::print(file, "POINT_DATA {}\n", std::distance(begin, end));
         has_point_data_flag_ = true;
       }
-      fmt::print(file, "VECTORS {} double\n", table_name);
-      std::for_each(begin, end, [&file](const auto& vector) {
-        fmt::print(file, "{} {} {}\n",
-                   vector.template get<0>(),
-                   vector.template get<1>(),
-                   vector.template get<2>());
-        file << std::endl;
+      fmt::print(file, "VECTORS {} {}\n", table_name,
+                 vtk_data_type<decltype(std::declval<std::iter_value_t<Iter>>().template get<0>())>());
+      write_values(file, [begin, end](auto& writer) {
+        std::for_each(begin, end, [&writer](const auto& vector) {
+          writer.put(vector.template get<0>());
+          writer.put(vector.template get<1>());
+          writer.put(vector.template get<2>());
+          writer.end_line();
+        });
       });
-      file << std::endl;
     }
 
     template<std::forward_iterator Iter>
@@ -104,58 +114,74 @@ namespace stg::mesh {
       if (!std::filesystem::exists(path)) {
         std::filesystem::create_directories(path.parent_path());
       }
-      std::ofstream file{path, std::ios_base::app};
+      std::ofstream file{path, std::ios_base::app | std::ios_base::binary};
       if (!has_point_data_flag_) {
         fmt::print(file, "POINT_DATA {}\n", std::distance(begin, end));
         has_point_data_flag_ = true;
       }
-      fmt::print(file, "TENSORS {} double\n", table_name);
-      std::for_each(begin, end, [&file](const auto& tensor) {
-        std::copy(tensor.cbegin(), tensor.cend(), std::ostream_iterator<TensorValueType>{file, " "});
-        file << std::endl;
+      fmt::print(file, "TENSORS {} {}\n", table_name, vtk_data_type<TensorValueType>());
+      write_values(file, [begin, end](auto& writer) {
+        std::for_each(begin, end, [&writer](const auto& tensor) {
+          std::for_each(tensor.cbegin(), tensor.cend(), [&writer](TensorValueType value) { writer.put(value); });
+          writer.end_line();
+        });
       });
-      file << std::endl;
     }
 
   protected:
+    // Section values through the block writer, a new line ends the section
+    template<typename Write>
+    void write_values(std::ofstream& file, Write&& write) const {
+      {
+        detail::VtkValueWriter writer{file, format_};
+        write(writer);
+      }
+      file.put('\n');
+    }
+
     void write_header(std::ofstream& file) const {
       fmt::print(file,
         "# vtk DataFile Version 3.0\n"
         "RFG method\n"
-        "ASCII\n"
-        "DATASET UNSTRUCTURED_GRID\n");
-      file << std::endl;
+        "{}\n"
+        "DATASET UNSTRUCTURED_GRID\n\n", vtk_format_name(format_));
     }
 
     template<std::forward_iterator Iter>
     void write_point_data(std::ofstream& file, Iter begin, Iter end, size_t points_number) const {
-      fmt::print(file, "POINTS {} double\n", points_number);
-      std::for_each(begin, end, [&file](const auto& value) {
-        static size_t counter = 0;
-        file << value << " ";
-        if (++counter % 3 == 0) {
-          file << std::endl;
-        }
+      fmt::print(file, "POINTS {} {}\n", points_number, vtk_data_type<std::iter_value_t<Iter>>());
+      write_values(file, [begin, end](auto& writer) {
+        std::size_t counter = 0;
+        std::for_each(begin, end, [&writer, &counter](const std::iter_value_t<Iter>& value) {
+          writer.put(value);
+          if (++counter % 3 == 0) {
+            writer.end_line();
+          }
+        });
       });
-      file << std::endl;
     }
 
     template<std::forward_iterator Iter>
     void write_cell_data(std::ofstream& file, Iter begin, Iter end, size_t elements_amount) const {
       fmt::print(file, "CELLS {} {}\n", elements_amount, bounded_vertices(begin, end));
-      std::for_each(begin, end, [&file](const auto& value) {
-        file << value.size() << " ";
-        std::copy(value.cbegin(), value.cend(), std::ostream_iterator<size_t>{file, " "});
-        file << std::endl;
+      write_values(file, [begin, end](auto& writer) {
+        std::for_each(begin, end, [&writer](const auto& value) {
+          writer.put_index(value.size());
+          std::for_each(value.cbegin(), value.cend(), [&writer](auto index) { writer.put_index(index); });
+          writer.end_line();
+        });
       });
-      file << std::endl;
     }
 
     template<std::forward_iterator Iter>
     void write_cell_types_data(std::ofstream& file, Iter begin, Iter end, size_t elements_amount) const {
       fmt::print(file, "CELL_TYPES {}\n", elements_amount);
-      std::copy(begin, end, std::ostream_iterator<size_t>{file, "\n"});
-      file << std::endl;
+      write_values(file, [begin, end](auto& writer) {
+        std::for_each(begin, end, [&writer](auto type) {
+          writer.put_index(static_cast<std::size_t>(type));
+          writer.end_line();
+        });
+      });
     }
 
     template<std::forward_iterator Iter>
@@ -171,6 +197,7 @@ namespace stg::mesh {
     }
 
     mutable bool has_point_data_flag_ = false;
+    VtkFormat format_ = VtkFormat::ascii;
   };
 }
 
@@ -0,0 +1,202 @@
+#ifndef STG_VTR_SAVER_HPP
+#define STG_VTR_SAVER_HPP
+
+#include "cube_relation_table.hpp"
+#include "vtk_data_type.hpp"
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace stg::mesh {
+
+    /*
+     * XML rectilinear grid (.vtr) with the arrays in the raw appended section. The XML
+     * header gives the offsets of the arrays, so the arrays are kept until close (or the
+     * destructor) writes the file: the coordinates are written straight from the mesh,
+     * the point data from the buffers filled by the save calls, one write per array.
+     * The values are in the byte order of the machine, the header says which one
+     */
+    class VtrRectilinearGridSaver final {
+    public:
+        explicit VtrRectilinearGridSaver(std::string_view filename)
+            : filename_{filename} {}
+
+        VtrRectilinearGridSaver(const VtrRectilinearGridSaver&) = delete;
+        VtrRectilinearGridSaver& operator=(const VtrRectilinearGridSaver&) = delete;
+
+        // Writes the file if close wasn't called, the errors are lost
+        ~VtrRectilinearGridSaver() {
+            try {
+                close();
+            } catch (...) {}
+        }
+
+        template<std::floating_point T>
+        void save_mesh(const std::shared_ptr<CubeRelationTable<T>>& rtable) {
+            const auto& vertices = rtable->vertices();
+            dimensions_ = vertices.size();
+            const std::span<const char> bytes{reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(T)};
+            coordinates_.clear();
+            for (const std::string_view axis: {"x", "y", "z"}) {
+                coordinates_.push_back(DataArray{std::string{axis}, vtk_xml_data_type<T>(), 1, rtable, bytes});
+            }
+        }
+
+        template<std::forward_iterator Iter>
+        void save_scalar_data(Iter begin, Iter end, std::string_view table_name = "DefaultTable") {
+            using Value = stored_t<std::iter_value_t<Iter>>;
+            auto buffer = std::make_shared<std::vector<char>>();
+            buffer->reserve(std::distance(begin, end) * sizeof(Value));
+            std::for_each(begin, end, [&buffer](const auto& value) { append<Value>(*buffer, value); });
+            add_point_data(table_name, vtk_xml_data_type<Value>(), 1, std::move(buffer));
+        }
+
+        template<std::ranges::viewable_range Range>
+        void save_vector_data(Range&& range, std::string_view table_name = "VectorField") {
+            using Value = stored_t<std::remove_cvref_t<decltype(std::get<0>(std::declval<std::ranges::range_reference_t<Range>>()))>>;
+            auto buffer = std::make_shared<std::vector<char>>();
+            std::ranges::for_each(range, [&buffer](const auto& vector) {
+                append<Value>(*buffer, std::get<0>(vector));
+                append<Value>(*buffer, std::get<1>(vector));
+                append<Value>(*buffer, std::get<2>(vector));
+            });
+            add_point_data(table_name, vtk_xml_data_type<Value>(), 3, std::move(buffer));
+        }
+
+        template<ranges::viewable_range Range>
+        void save_velocity_data(Range&& range, std::string_view table_name = "VectorField") {
+            using Value = stored_t<std::remove_cvref_t<decltype(std::get<0>(std::declval<ranges::range_reference_t<Range>>()))>>;
+            auto buffer = std::make_shared<std::vector<char>>();
+            buffer->reserve(static_cast<std::size_t>(ranges::distance(range)) * 3 * sizeof(Value));
+            ranges::for_each(range, [&buffer](const auto& vec_zip) {
+                const auto [x, y, z] = vec_zip;
+                append<Value>(*buffer, x);
+                append<Value>(*buffer, y);
+                append<Value>(*buffer, z);
+            });
+            add_point_data(table_name, vtk_xml_data_type<Value>(), 3, std::move(buffer));
+        }
+
+        template<std::forward_iterator Iter>
+        void save_tensor_data(Iter begin, Iter end, std::string_view table_name = "TensorData") {
+            using Value = stored_t<typename std::iter_value_t<Iter>::value_type>;
+            auto buffer = std::make_shared<std::vector<char>>();
+            buffer->reserve(std::distance(begin, end) * 9 * sizeof(Value));
+            std::for_each(begin, end, [&buffer](const auto& tensor) {
+                std::for_each(tensor.cbegin(), tensor.cend(), [&buffer](auto value) { append<Value>(*buffer, value); });
+            });
+            add_point_data(table_name, vtk_xml_data_type<Value>(), 9, std::move(buffer));
+        }
+
+        // Writes the file, the next calls do nothing
+        void close() {
+            if (closed_) { return; }
+            closed_ = true;
+            if (coordinates_.empty()) {
+                throw std::logic_error("Grid must be saved before the file is written");
+            }
+
+            std::ofstream file{filename_, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary};
+            if (!file) {
+                throw std::runtime_error(fmt::format("Can't open {} to save the grid", filename_));
+            }
+            const std::size_t last = dimensions_ - 1;
+            fmt::print(file,
+                       "<?xml version=\"1.0\"?>\n"
+                       "<VTKFile type=\"RectilinearGrid\" version=\"1.0\" byte_order=\"{}\" header_type=\"UInt64\">\n"
+                       "  <RectilinearGrid WholeExtent=\"0 {} 0 {} 0 {}\">\n"
+                       "    <Piece Extent=\"0 {} 0 {} 0 {}\">\n",
+                       std::endian::native == std::endian::little ? "LittleEndian" : "BigEndian",
+                       last, last, last, last, last, last);
+            std::uint64_t offset = 0;
+            fmt::print(file, "      <PointData>\n");
+            for (const auto& array: point_data_) {
+                write_array_header(file, array, offset);
+            }
+            fmt::print(file, "      </PointData>\n"
+                             "      <Coordinates>\n");
+            for (const auto& array: coordinates_) {
+                write_array_header(file, array, offset);
+            }
+            fmt::print(file, "      </Coordinates>\n"
+                             "    </Piece>\n"
+                             "  </RectilinearGrid>\n"
+                             "  <AppendedData encoding=\"raw\">\n"
+                             "   _");
+            for (const auto& array: point_data_) {
+                write_array_data(file, array);
+            }
+            for (const auto& array: coordinates_) {
+                write_array_data(file, array);
+            }
+            fmt::print(file, "\n  </AppendedData>\n"
+                             "</VTKFile>\n");
+            if (!file) {
+                throw std::runtime_error(fmt::format("Grid isn't written to {}", filename_));
+            }
+        }
+
+    private:
+        // Bytes of an array and the owner that keeps them alive
+        struct DataArray {
+            std::string name;
+            std::string_view type;
+            std::size_t components;
+            std::shared_ptr<const void> owner;
+            std::span<const char> bytes;
+        };
+
+        template<typename T>
+        using stored_t = std::conditional_t<std::same_as<std::remove_cvref_t<T>, float>, float, double>;
+
+        std::string filename_;
+        std::size_t dimensions_ = 0;
+        std::vector<DataArray> coordinates_;
+        std::vector<DataArray> point_data_;
+        bool closed_ = false;
+
+        template<typename Stored, typename T>
+        static void append(std::vector<char>& buffer, T value) {
+            const auto stored = static_cast<Stored>(value);
+            const auto offset = buffer.size();
+            buffer.resize(offset + sizeof(Stored));
+            std::memcpy(buffer.data() + offset, &stored, sizeof(Stored));
+        }
+
+        void add_point_data(std::string_view name, std::string_view type, std::size_t components,
+                            std::shared_ptr<std::vector<char>> buffer) {
+            const std::span<const char> bytes{*buffer};
+            point_data_.push_back(DataArray{std::string{name}, type, components, std::move(buffer), bytes});
+        }
+
+        static void write_array_header(std::ofstream& file, const DataArray& array, std::uint64_t& offset) {
+            fmt::print(file, "        <DataArray type=\"{}\" Name=\"{}\" NumberOfComponents=\"{}\" format=\"appended\" offset=\"{}\"/>\n",
+                       array.type, array.name, array.components, offset);
+            offset += sizeof(std::uint64_t) + array.bytes.size();
+        }
+
+        static void write_array_data(std::ofstream& file, const DataArray& array) {
+            const std::uint64_t size = array.bytes.size();
+            file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            file.write(array.bytes.data(), static_cast<std::streamsize>(array.bytes.size()));
+        }
+    };
+}// namespace stg::mesh
+
+#endif//STG_VTR_SAVER_HPP
@@ -0,0 +1,79 @@
+#ifndef STG_MAPPED_FILE_HPP
+#define STG_MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace stg::mesh {
+
+  /*
+   * Read only memory map of a whole file, the pages are read by the kernel on the first
+   * access and may be shared with the page cache, no copy to a user buffer. The advice
+   * tells the kernel the access pattern (MADV_RANDOM for the reads of a few blocks)
+   */
+  class MappedFile final {
+  public:
+    explicit MappedFile(const std::filesystem::path& path, int advice = MADV_SEQUENTIAL) {
+      const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (descriptor < 0) {
+        throw std::system_error(errno, std::generic_category(), "Can't open " + path.string());
+      }
+      struct stat status{};
+      if (::fstat(descriptor, &status) != 0) {
+        const int error = errno;
+        ::close(descriptor);
+        throw std::system_error(error, std::generic_category(), "Can't stat " + path.string());
+      }
+      size_ = static_cast<std::size_t>(status.st_size);
+      if (size_ != 0) {
+        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (data == MAP_FAILED) {
+          const int error = errno;
+          ::close(descriptor);
+          throw std::system_error(error, std::generic_category(), "Can't map " + path.string());
+        }
+        ::madvise(data, size_, advice);
+        data_ = static_cast<const char*>(data);
+      }
+      ::close(descriptor);
+    }
+
+    MappedFile() noexcept = default;
+
+    MappedFile(MappedFile&& other) noexcept
+      : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)} { }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+      return *this;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+      if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+      }
+    }
+
+    [[nodiscard]] std::string_view view() const noexcept { return {data_, size_}; }
+
+  private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+  };
+}
+
+#endif //STG_MAPPED_FILE_HPP
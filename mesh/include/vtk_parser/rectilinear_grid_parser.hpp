@@ -1,157 +1,492 @@
 #ifndef STG_RECTILINEAR_GRID_PARSER_HPP
 #define STG_RECTILINEAR_GRID_PARSER_HPP
 
-#include <string>
-#include <string_view>
-#include <fstream>
-#include <iostream>
-#include <iterator>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fmt/format.h>
-#include <boost/lexical_cast.hpp>
-#include <boost/tokenizer.hpp>
-#include <rtable/cube_relation_table.hpp>
+#include <fmt/ostream.h>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
 #include <mesh_builders/cube_fe_mesh.hpp>
+#include <rtable/cube_relation_table.hpp>
+#include <rtable/vtk_data_writer.hpp>
+#include <stg_thread_pool/parallel_for.hpp>
+#include "mapped_file.hpp"
 
 namespace stg::mesh {
 
+  namespace detail {
+    constexpr bool is_blank(char symbol) noexcept {
+      return symbol == ' ' || symbol == '\n' || symbol == '\r' || symbol == '\t';
+    }
+
+    // Line at position without the line break, position moves to the next line
+    inline std::string_view next_line(std::string_view text, std::size_t& position) noexcept {
+      const std::size_t end = std::min(text.find('\n', position), text.size());
+      std::string_view line = text.substr(position, end - position);
+      position = std::min(end + 1, text.size());
+      while (!line.empty() && is_blank(line.back())) { line.remove_suffix(1); }
+      while (!line.empty() && is_blank(line.front())) { line.remove_prefix(1); }
+      return line;
+    }
+
+    // Blank separated token of a line, empty if there are less tokens
+    inline std::string_view token(std::string_view line, std::size_t index) noexcept {
+      std::size_t position = 0;
+      for (std::size_t current = 0;; ++current) {
+        while (position < line.size() && is_blank(line[position])) { ++position; }
+        const std::size_t end = std::min(line.find_first_of(" \t", position), line.size());
+        if (current == index || position == line.size()) {
+          return line.substr(position, end - position);
+        }
+        position = end;
+      }
+    }
+
+    template<typename T>
+    T to_number(std::string_view text) {
+      if (!text.empty() && text.front() == '+') { text.remove_prefix(1); }
+      T value{};
+      const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (error != std::errc{} || end != text.data() + text.size()) {
+        throw std::runtime_error(fmt::format("'{}' is not a number in the VTK file", text));
+      }
+      return value;
+    }
+
+    // Values of a data section: where they start, how many and how they are stored
+    struct VtkSection {
+      std::size_t begin = 0;
+      std::size_t records = 0;// 0 if not declared, ASCII only
+      std::size_t components = 1;
+      bool single_precision = false;
+      bool binary = false;
+      std::endian order = std::endian::big;
+    };
+
+    /*
+     * ASCII values of a section split into chunks at blanks: the values of every chunk
+     * are counted in parallel, then parsed in parallel with from_chars straight to their
+     * indices, the offsets of the chunks are the prefix sums of the counts
+     */
+    class AsciiValues final {
+    public:
+      static constexpr std::size_t min_chunk_bytes = std::size_t{1} << 18;
+
+      explicit AsciiValues(std::string_view text)
+        : text_{text} {
+        const std::size_t threads = utility::ThreadPool::global().size() + 1;
+        const std::size_t chunks = std::clamp<std::size_t>(text.size() / min_chunk_bytes, 1, 4 * threads);
+        bounds_.resize(chunks + 1, text.size());
+        bounds_.front() = 0;
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+          std::size_t position = std::max(chunk * text.size() / chunks, bounds_[chunk - 1]);
+          while (position < text.size() && !is_blank(text[position])) { ++position; }
+          bounds_[chunk] = position;
+        }
+
+        offsets_.resize(chunks);
+        std::vector<std::size_t> counts(chunks);
+        for_each_chunk([this, &counts](std::size_t chunk) { counts[chunk] = count(this->chunk(chunk)); });
+        std::exclusive_scan(counts.cbegin(), counts.cend(), offsets_.begin(), std::size_t{0});
+        size_ = offsets_.back() + counts.back();
+      }
+
+      [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+      template<typename T, typename Store>
+      void parse(Store&& store) const {
+        std::atomic<bool> malformed = false;
+        for_each_chunk([&](std::size_t chunk) {
+          const std::string_view text = this->chunk(chunk);
+          std::size_t index = offsets_[chunk];
+          const char* position = text.data();
+          const char* const end = text.data() + text.size();
+          while (true) {
+            while (position != end && is_blank(*position)) { ++position; }
+            if (position == end) { break; }
+            if (*position == '+') { ++position; }
+            T value{};
+            const auto [last, error] = std::from_chars(position, end, value);
+            if (error != std::errc{} || (last != end && !is_blank(*last))) {
+              malformed.store(true, std::memory_order_relaxed);
+              break;
+            }
+            store(index++, value);
+            position = last;
+          }
+        });
+        if (malformed.load()) {
+          throw std::runtime_error("Malformed number in the VTK data");
+        }
+      }
+
+    private:
+      std::string_view text_;
+      std::vector<std::size_t> bounds_;
+      std::vector<std::size_t> offsets_;
+      std::size_t size_ = 0;
+
+      std::string_view chunk(std::size_t index) const noexcept {
+        return text_.substr(bounds_[index], bounds_[index + 1] - bounds_[index]);
+      }
+
+      template<typename Function>
+      void for_each_chunk(Function&& function) const {
+        utility::parallel_for(utility::ThreadPool::global(), 0, offsets_.size(), 1, [&function](std::size_t begin, std::size_t end) {
+          for (std::size_t index = begin; index < end; ++index) {
+            function(index);
+          }
+        });
+      }
+
+      static std::size_t count(std::string_view text) noexcept {
+        std::size_t result = 0;
+        bool in_value = false;
+        for (const char symbol: text) {
+          const bool blank = is_blank(symbol);
+          result += !blank && !in_value;
+          in_value = !blank;
+        }
+        return result;
+      }
+    };
+  }
+
   /*
+   * Reader of the cube rectilinear grids saved by VtkRectilinearGridSaver (legacy ASCII or
+   * binary) and VtrRectilinearGridSaver (XML with raw appended data). The file is memory
+   * mapped, the sections are found by scanning the mapped lines (binary blocks are skipped
+   * by their size) and the values are parsed in parallel chunks with from_chars into the
+   * result buffers.
    * Пока только кубическая сетка
    */
   class RectilinearGridParser final {
   public:
 
     RectilinearGridParser(std::string_view filename)
-      : file_{open_file(filename)} { }
+      : file_{map_file(filename)}, xml_{file_.view().starts_with("<?xml")} { }
 
     RectilinearGridParser(const RectilinearGridParser&) = delete;
     RectilinearGridParser& operator=(const RectilinearGridParser&) = delete;
 
     template<std::floating_point T>
     std::shared_ptr<CubeRelationTable<T>> mesh() {
-      boost::char_separator<char> sep{" "};
-      std::string line;
-      bool coordinates_begin = false;
-      bool has_n_points = false;
-      bool has_length = false;
-      std::size_t n;
-      double l;
-
-      while (std::getline(file_, line)) {
-        boost::tokenizer tok(line, sep);
-        if (*tok.begin() == "DIMENSIONS") {
-          n = std::stoul(*(++tok.begin()));
-          cached_vert_number_ = n * n * n;
-          has_n_points = true;
-        }
+      const auto [n, l] = grid();
+      CubeMeshBuilder<T> builder{static_cast<T>(l), n};
+      return builder.build_relation_table();
+    }
 
-        if (coordinates_begin) {
-          const auto coordinate_left = *tok.begin();
-          l = 2 * std::fabs(std::stod(coordinate_left));
-          has_length = true;
-        }
+    template<std::floating_point T>
+    std::shared_ptr<CubeFiniteElementsMesh<T>> fe_mesh() {
+      const auto [n, l] = grid();
+      CubeMeshBuilder<T> builder{static_cast<T>(l), n};
+      return builder.build();
+    }
 
-        if (*tok.begin() == "X_COORDINATES") {
-          coordinates_begin = true;
-        }
+    // All the values of the section after the starting line (the array of that name in a .vtr)
+    template<std::floating_point T>
+    std::vector<T> scalar_data(std::string_view starting_expr = "LOOKUP_TABLE default",
+                               [[maybe_unused]] std::string_view end_expr = " ") {
+      std::vector<T> result;
+      const auto section = find_section(starting_expr);
+      if (!section) { return result; }
+      read_section<T>(*section, [&result](std::size_t size) { result.resize(size); },
+                      [&result](std::size_t index, T value) { result[index] = value; });
+      return result;
+    }
 
-        if (has_n_points && has_length) { break; }
+    template<std::floating_point T>
+    std::vector<Vector<T>> vector_data(std::string_view starting_expr = "LOOKUP_TABLE default",
+                                       [[maybe_unused]] std::string_view end_expr = " ") {
+      const auto [x, y, z] = vector_components<T>(starting_expr);
+      std::vector<Vector<T>> result(x.size());
+      for (std::size_t index = 0; index < result.size(); ++index) {
+        result[index] = Vector<T>{x[index], y[index], z[index]};
       }
+      return result;
+    }
 
-      CubeMeshBuilder<T> builder{l, n};
-      return builder.build_relation_table();
+    // Components of the vectors of the section as separate arrays
+    template<std::floating_point T>
+    std::array<std::vector<T>, 3> vector_components(std::string_view starting_expr = "LOOKUP_TABLE default") {
+      std::array<std::vector<T>, 3> result;
+      const auto section = find_section(starting_expr);
+      if (!section) { return result; }
+      read_section<T>(*section, [&result](std::size_t size) {
+        if (size % 3 != 0) {
+          throw std::runtime_error(fmt::format("{} values aren't 3D vectors", size));
+        }
+        for (auto& component: result) { component.resize(size / 3); }
+      }, components_store<T>(result[0], result[1], result[2]));
+      return result;
     }
 
+    // Components of the vectors of the section into the preallocated buffers of the same size
     template<std::floating_point T>
-    std::shared_ptr<CubeFiniteElementsMesh<T>> fe_mesh() {
-      boost::char_separator<char> sep{" "};
-      std::string line;
-      bool coordinates_begin = false;
-      bool has_n_points = false;
-      bool has_length = false;
-      std::size_t n;
-      double l;
+    void read_vector_components(std::span<T> x, std::span<T> y, std::span<T> z,
+                                std::string_view starting_expr = "LOOKUP_TABLE default") {
+      const auto section = find_section(starting_expr);
+      if (!section) {
+        throw std::runtime_error(fmt::format("No {} section in the file", starting_expr));
+      }
+      read_section<T>(*section, [&x, &y, &z](std::size_t size) {
+        if (size != 3 * x.size() || y.size() != x.size() || z.size() != x.size()) {
+          throw std::invalid_argument(fmt::format("{} values don't fit the buffers of {} vectors", size, x.size()));
+        }
+      }, components_store<T>(x, y, z));
+    }
+
+  private:
+    MappedFile file_;
+    bool xml_ = false;
 
-      while (std::getline(file_, line)) {
-        boost::tokenizer tok(line, sep);
-        if (*tok.begin() == "DIMENSIONS") {
-          n = std::stoul(*(++tok.begin()));
-          cached_vert_number_ = n * n * n;
-          has_n_points = true;
-          has_cached_vert_number_ = true;
+    static MappedFile map_file(std::string_view filename) {
+      std::filesystem::path path = std::filesystem::absolute(filename);
+      if (!std::filesystem::exists(path)) {
+        fmt::print(std::cerr, "File doesn't exists {}", filename);
+        return {};
+      }
+      return MappedFile{path};
+    }
+
+    // The buffers are sized by the prepare call, so they are taken by reference
+    template<typename T, typename X, typename Y, typename Z>
+    static auto components_store(X& x, Y& y, Z& z) {
+      return [&x, &y, &z](std::size_t index, T value) {
+        switch (index % 3) {
+          case 0: x[index / 3] = value; break;
+          case 1: y[index / 3] = value; break;
+          default: z[index / 3] = value;
         }
+      };
+    }
 
-        if (coordinates_begin) {
-          const auto coordinate_left = *tok.begin();
-          l = 2 * std::fabs(std::stod(coordinate_left));
-          has_length = true;
+    // Values of the section: prepare gets their number, store every value with its index
+    template<std::floating_point T, typename Prepare, typename Store>
+    void read_section(const detail::VtkSection& section, Prepare&& prepare, Store&& store) const {
+      const std::string_view text = file_.view();
+      if (!section.binary) {
+        const detail::AsciiValues values{text.substr(section.begin, ascii_end(text, section.begin) - section.begin)};
+        if (section.records != 0 && values.size() != section.records * section.components) {
+          throw std::runtime_error(fmt::format("Section has {} values instead of {}", values.size(), section.records * section.components));
         }
+        prepare(values.size());
+        values.parse<T>(store);
+        return;
+      }
 
-        if (*tok.begin() == "X_COORDINATES") {
-          coordinates_begin = true;
+      const std::size_t size = section.records * section.components;
+      const std::size_t value_size = section.single_precision ? sizeof(float) : sizeof(double);
+      if (section.begin + size * value_size > text.size()) {
+        throw std::runtime_error("Binary section is cut off");
+      }
+      prepare(size);
+      const char* const data = text.data() + section.begin;
+      const bool swap = section.order != std::endian::native;
+      utility::parallel_for(utility::ThreadPool::global(), 0, size, binary_block, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; ++index) {
+          if (section.single_precision) {
+            store(index, static_cast<T>(read_raw<float>(data + index * sizeof(float), swap)));
+          } else {
+            store(index, static_cast<T>(read_raw<double>(data + index * sizeof(double), swap)));
+          }
         }
+      });
+    }
 
-        if (has_n_points && has_length) { break; }
+    static constexpr std::size_t binary_block = std::size_t{1} << 16;
+
+    template<typename V>
+    static V read_raw(const char* data, bool swap) noexcept {
+      V value;
+      std::memcpy(&value, data, sizeof(V));
+      return swap ? detail::byteswap(value) : value;
+    }
+
+    // End of the ASCII values: the next keyword line or the end of the file
+    static std::size_t ascii_end(std::string_view text, std::size_t position) noexcept {
+      while (position < text.size()) {
+        std::size_t first = position;
+        while (first < text.size() && (text[first] == ' ' || text[first] == '\t')) { ++first; }
+        if (first < text.size() && text[first] >= 'A' && text[first] <= 'Z') { return position; }
+        const std::size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) { break; }
+        position = end + 1;
       }
+      return text.size();
+    }
 
-      CubeMeshBuilder<T> builder{l, n};
-      return builder.build();
+    // Number of vertices along an edge and the edge length of the cube
+    std::pair<std::size_t, double> grid() const {
+      std::optional<detail::VtkSection> coordinates;
+      std::size_t n = 0;
+      if (xml_) {
+        coordinates = find_xml_array({}, true);
+        n = detail::to_number<std::size_t>(detail::token(xml_attribute(file_.view(), "WholeExtent"), 1)) + 1;
+      } else {
+        coordinates = find_legacy_section([](std::string_view line) { return line.starts_with("X_COORDINATES"); });
+        n = coordinates ? coordinates->records : 0;
+      }
+      if (!coordinates || n == 0) {
+        throw std::runtime_error("No grid coordinates in the file");
+      }
+      // The grid is symmetric, the first coordinate is -l/2
+      double left = 0.;
+      if (coordinates->binary) {
+        const char* const data = file_.view().data() + coordinates->begin;
+        const bool swap = coordinates->order != std::endian::native;
+        left = coordinates->single_precision ? read_raw<float>(data, swap) : read_raw<double>(data, swap);
+      } else {
+        std::size_t position = coordinates->begin;
+        left = detail::to_number<double>(detail::token(detail::next_line(file_.view(), position), 0));
+      }
+      return {n, 2 * std::fabs(left)};
     }
 
-    template<std::floating_point T>
-    std::vector<T> scalar_data(std::string_view starting_expr = "LOOKUP_TABLE default",
-                               std::string_view end_expr = " ") {
-      bool scalar_data_start = false;
-      boost::char_separator<char> sep{" "};
-      std::string line;
-      std::vector<T> result;
-      if (has_cached_vert_number_) result.reserve(cached_vert_number_);
-      while (std::getline(file_, line)) {
-        if (scalar_data_start) {
-          result.push_back(std::stod(line));
-        }
-        if (line == starting_expr) {
-          scalar_data_start = true;
-        }
+    std::optional<detail::VtkSection> find_section(std::string_view starting_expr) const {
+      if (xml_) {
+        const auto keyword = detail::token(starting_expr, 0);
+        const bool named = keyword == "SCALARS" || keyword == "VECTORS" || keyword == "TENSORS";
+        return find_xml_array(named ? detail::token(starting_expr, 1) : std::string_view{}, false);
       }
-      return result;
+      return find_legacy_section([starting_expr](std::string_view line) { return line == starting_expr; });
     }
 
-    template<std::floating_point T>
-    std::vector<Vector<T>> vector_data(std::string_view starting_expr = "LOOKUP_TABLE default",
-                                       std::string_view end_expr = " ") {
-      bool vector_data_start = false;
-      boost::char_separator<char> sep{" "};
-      std::string line;
-      std::vector<Vector<T>> result;
-      if (has_cached_vert_number_) result.reserve(cached_vert_number_);
-      while (std::getline(file_, line)) {
-        boost::tokenizer tok{line, sep};
-        if (vector_data_start) {
-          std::vector<T> vel(3);
-          std::transform(tok.begin(), tok.end(), vel.begin(), [](const std::string& value) {
-            return std::stod(value);
-          });
-          result.push_back({vel[0], vel[1], vel[2]});
-        }
-        if (line == starting_expr) {
-          vector_data_start = true;
+    /*
+     * Walks the lines of a legacy file up to the first line matched, the declared sections
+     * on the way are skipped: the binary ones by their size, the ASCII ones up to the next keyword
+     */
+    template<typename Match>
+    std::optional<detail::VtkSection> find_legacy_section(Match&& match) const {
+      const std::string_view text = file_.view();
+      std::size_t position = 0;
+      bool binary = false;
+      std::size_t points = 0;
+      detail::VtkSection scalars;
+      bool scalars_matched = false;
+      while (position < text.size()) {
+        const std::string_view line = detail::next_line(text, position);
+        if (line.empty()) { continue; }
+        const std::string_view keyword = detail::token(line, 0);
+        const std::string_view type = detail::token(line, 2);
+
+        std::optional<detail::VtkSection> declared;
+        if (line == "BINARY") {
+          binary = true;
+        } else if (keyword == "POINT_DATA") {
+          points = detail::to_number<std::size_t>(detail::token(line, 1));
+        } else if (keyword.ends_with("_COORDINATES")) {
+          declared = detail::VtkSection{.records = detail::to_number<std::size_t>(detail::token(line, 1)), .single_precision = type == "float"};
+        } else if (keyword == "SCALARS") {
+          const auto components = detail::token(line, 3);
+          scalars = detail::VtkSection{.records = points,
+                                       .components = components.empty() ? 1 : detail::to_number<std::size_t>(components),
+                                       .single_precision = type == "float"};
+          // The values follow the lookup table line
+          scalars_matched = match(line);
+          continue;
+        } else if (keyword == "LOOKUP_TABLE") {
+          declared = scalars;
+        } else if (keyword == "VECTORS" || keyword == "NORMALS") {
+          declared = detail::VtkSection{.records = points, .components = 3, .single_precision = type == "float"};
+        } else if (keyword == "TENSORS") {
+          declared = detail::VtkSection{.records = points, .components = 9, .single_precision = type == "float"};
+        }
+
+        if (!declared) {
+          if (match(line)) {
+            return detail::VtkSection{.begin = position};
+          }
+          continue;
+        }
+        declared->begin = position;
+        declared->binary = binary;
+        if (std::exchange(scalars_matched, false) || match(line)) {
+          return declared;
+        }
+        if (binary) {
+          position += declared->records * declared->components * (declared->single_precision ? sizeof(float) : sizeof(double));
+        } else {
+          position = ascii_end(text, position);
         }
       }
-      return result;
+      return std::nullopt;
     }
 
-  private:
-    std::ifstream file_;
-    std::size_t cached_vert_number_;
-    bool has_cached_vert_number_ = false;
+    static std::string_view xml_attribute(std::string_view tag, std::string_view name) {
+      const std::string pattern = fmt::format(" {}=\"", name);
+      const auto begin = tag.find(pattern);
+      if (begin == std::string_view::npos) { return {}; }
+      const auto value = begin + pattern.size();
+      return tag.substr(value, tag.find('"', value) - value);
+    }
 
-    static std::ifstream open_file(std::string_view filename) {
-      std::filesystem::path path = std::filesystem::absolute(filename);
-      if (!std::filesystem::exists(path)) {
-        fmt::print(std::cerr, "File doesn't exists {}", filename);
+    /*
+     * Raw appended array of a .vtr file: the array of the name in the point data, the first
+     * point data array for an empty name or the first coordinates array
+     */
+    std::optional<detail::VtkSection> find_xml_array(std::string_view name, bool coordinates) const {
+      const std::string_view text = file_.view();
+      const auto appended = text.find("<AppendedData");
+      if (appended == std::string_view::npos) {
+        throw std::runtime_error("Only the appended raw XML arrays are read");
+      }
+      const std::string_view header = text.substr(0, appended);
+      const auto file_tag = header.substr(header.find("<VTKFile"));
+      const bool header_64 = xml_attribute(file_tag.substr(0, file_tag.find('>')), "header_type") != "UInt32";
+      const std::endian order = xml_attribute(file_tag.substr(0, file_tag.find('>')), "byte_order") == "BigEndian" ? std::endian::big : std::endian::little;
+      const auto coordinates_begin = header.find("<Coordinates");
+      const auto underscore = text.find('_', appended);
+      if (underscore == std::string_view::npos) {
+        throw std::runtime_error("Appended data has no start mark");
+      }
+      const auto data_begin = underscore + 1;
+      const std::size_t size_bytes = header_64 ? sizeof(std::uint64_t) : sizeof(std::uint32_t);
+
+      for (auto position = header.find("<DataArray"); position != std::string_view::npos; position = header.find("<DataArray", position + 1)) {
+        const std::string_view tag = header.substr(position, header.find('>', position) - position);
+        if ((position > coordinates_begin) != coordinates) { continue; }
+        if (!name.empty() && xml_attribute(tag, "Name") != name) { continue; }
+        if (xml_attribute(tag, "format") != "appended") {
+          throw std::runtime_error("Only the appended raw XML arrays are read");
+        }
+        const auto components = xml_attribute(tag, "NumberOfComponents");
+        detail::VtkSection section{.components = components.empty() ? 1 : detail::to_number<std::size_t>(components),
+                                   .single_precision = xml_attribute(tag, "type") == "Float32",
+                                   .binary = true,
+                                   .order = order};
+        const std::size_t offset = detail::to_number<std::size_t>(xml_attribute(tag, "offset"));
+        // The size header and the bytes it announces must lie in the file
+        if (offset > text.size() - data_begin || text.size() - data_begin - offset < size_bytes) {
+          throw std::runtime_error(fmt::format("Size of the appended array at {} is out of the file", offset));
+        }
+        const char* const size = text.data() + data_begin + offset;
+        const std::uint64_t bytes = header_64 ? read_raw<std::uint64_t>(size, order != std::endian::native)
+                                              : read_raw<std::uint32_t>(size, order != std::endian::native);
+        section.begin = data_begin + offset + size_bytes;
+        if (bytes > text.size() - section.begin) {
+          throw std::runtime_error(fmt::format("Appended array at {} of {} bytes is out of the file", offset, bytes));
+        }
+        section.records = bytes / (section.components * (section.single_precision ? sizeof(float) : sizeof(double)));
+        return section;
       }
-      return std::ifstream{path, std::ios_base::in};
+      return std::nullopt;
     }
   };
 }
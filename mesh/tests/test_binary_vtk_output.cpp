@@ -0,0 +1,112 @@
+#include "common.hpp"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+  std::string read_file(const std::string& filename) {
+    std::ifstream file{filename, std::ios_base::binary};
+    return std::string{std::istreambuf_iterator<char>{file}, {}};
+  }
+
+  template<typename T>
+  T read_value(const std::string& content, std::size_t position, std::endian order) {
+    T value;
+    std::memcpy(&value, content.data() + position, sizeof(T));
+    return order == std::endian::native ? value : detail::byteswap(value);
+  }
+
+  // Position of the data of the section starting with the keyword line
+  std::size_t section_data(const std::string& content, const std::string& keyword_line) {
+    const auto position = content.find(keyword_line);
+    REQUIRE(position != std::string::npos);
+    return position + keyword_line.size();
+  }
+}
+
+SCENARIO("Binary legacy VTK grid is big endian") {
+  const std::size_t n = 4;
+  const std::string filename = "tests_mesh/binary_cube_mesh.vtk";
+  std::filesystem::create_directories("tests_mesh");
+  std::filesystem::remove(filename);
+  const auto mesh = CubeMeshBuilder<double>{2., n}.build();
+
+  std::vector<double> scalars(n * n * n);
+  ranges::iota(scalars, 0);
+  std::vector<stg::Vector<double>> vectors(n * n * n, stg::Vector<double>{1., 2., 3.});
+  {
+    VtkRectilinearGridSaver saver{filename, VtkFormat::binary};
+    saver.save_mesh<double>(mesh->relation_table());
+    saver.save_scalar_data(scalars.cbegin(), scalars.cend());
+    saver.save_vector_data(vectors.cbegin(), vectors.cend());
+  }
+  const auto content = read_file(filename);
+
+  THEN("The header names the binary format") {
+    REQUIRE(content.find("BINARY\nDATASET RECTILINEAR_GRID\nDIMENSIONS 4 4 4\n") != std::string::npos);
+  }
+
+  THEN("The sections hold the raw values") {
+    const auto& axis = mesh->relation_table()->vertices();
+    const auto coordinates = section_data(content, "Y_COORDINATES 4 double\n");
+    for (std::size_t index = 0; index < n; ++index) {
+      REQUIRE(read_value<double>(content, coordinates + index * sizeof(double), std::endian::big) == axis[index]);
+    }
+    const auto values = section_data(content, "LOOKUP_TABLE default\n");
+    for (std::size_t index = 0; index < scalars.size(); ++index) {
+      REQUIRE(read_value<double>(content, values + index * sizeof(double), std::endian::big) == scalars[index]);
+    }
+    const auto vector_values = section_data(content, "VECTORS VectorField double\n");
+    REQUIRE(read_value<double>(content, vector_values + 5 * sizeof(double), std::endian::big) == 3.);
+    REQUIRE(content.size() == vector_values + 3 * scalars.size() * sizeof(double) + 1);
+  }
+}
+
+SCENARIO("Binary legacy VTK unstructured grid") {
+  const std::string filename = "tests_mesh/binary_prizm_mesh.vtk";
+  const auto mesh = CubePrizmMeshBuilder<double>{0., 1., 0., 1., 0., 1., 3, 3, 3}.build();
+  VtkSaver{VtkFormat::binary}.save_mesh<double>(mesh->relation_table(), filename);
+  const auto content = read_file(filename);
+
+  THEN("The cells are big endian ints") {
+    REQUIRE(content.find("BINARY\n") != std::string::npos);
+    const auto cells = section_data(content, fmt::format("CELLS {} {}\n", mesh->n_elements(), mesh->n_elements() * 9));
+    REQUIRE(read_value<std::int32_t>(content, cells, std::endian::big) == 8);
+  }
+}
+
+SCENARIO("XML rectilinear grid with appended raw data") {
+  const std::size_t n = 3;
+  const std::string filename = "tests_mesh/appended_cube_mesh.vtr";
+  std::filesystem::create_directories("tests_mesh");
+  const auto mesh = CubeMeshBuilder<double>{2., n}.build();
+  std::vector<stg::Vector<double>> vectors(n * n * n, stg::Vector<double>{1., 2., 3.});
+  std::vector<Tensor<double>> tensors(n * n * n, Tensor<double>{std::array<double, 9>{1, 0, 0, 0, 1, 0, 0, 0, 1}});
+  {
+    VtrRectilinearGridSaver saver{filename};
+    saver.save_mesh<double>(mesh->relation_table());
+    saver.save_tensor_data(tensors.cbegin(), tensors.cend(), "CorrelationTensors");
+  }
+  const auto content = read_file(filename);
+
+  THEN("The header lists the arrays with their offsets") {
+    REQUIRE(content.starts_with("<?xml version=\"1.0\"?>\n<VTKFile type=\"RectilinearGrid\""));
+    REQUIRE(content.find("WholeExtent=\"0 2 0 2 0 2\"") != std::string::npos);
+    REQUIRE(content.find("Name=\"CorrelationTensors\" NumberOfComponents=\"9\" format=\"appended\" offset=\"0\"") != std::string::npos);
+    REQUIRE(content.find(fmt::format("Name=\"x\" NumberOfComponents=\"1\" format=\"appended\" offset=\"{}\"", 8 + 9 * 27 * 8)) != std::string::npos);
+    REQUIRE(content.ends_with("\n  </AppendedData>\n</VTKFile>\n"));
+  }
+
+  THEN("The appended arrays are the raw values after their sizes") {
+    const auto data = section_data(content, "<AppendedData encoding=\"raw\">\n   _");
+    REQUIRE(read_value<std::uint64_t>(content, data, std::endian::native) == 9 * 27 * sizeof(double));
+    REQUIRE(read_value<double>(content, data + 8 + 4 * sizeof(double), std::endian::native) == 1.);
+    const auto x = data + 8 + 9 * 27 * sizeof(double);
+    REQUIRE(read_value<std::uint64_t>(content, x, std::endian::native) == n * sizeof(double));
+    REQUIRE(read_value<double>(content, x + 8 + 2 * sizeof(double), std::endian::native) == mesh->relation_table()->vertices()[2]);
+  }
+}
@@ -1,4 +1,9 @@
 #include "common.hpp"
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
 
 struct ParsingFixture {
   static inline const double eps = 1.e-6;
@@ -57,4 +62,123 @@ SCENARIO_METHOD(ParsingVectorDataFixture, "Parse file with vector data") {
   CHECK_THAT(vector_data.back().get<0>(), WithinRel(0.0268544, eps));
   CHECK_THAT(vector_data.back().get<1>(), WithinRel(-0.214446, eps));
   CHECK_THAT(vector_data.back().get<2>(), WithinRel(-0.0763451, eps));
-}
\ No newline at end of file
+}
+SCENARIO("Parse the grids written in every format") {
+  const std::size_t n = 9;
+  std::filesystem::create_directories("tests_mesh");
+  const auto mesh = CubeMeshBuilder<double>{3., n}.build_relation_table();
+  std::vector<double> scalars(n * n * n);
+  std::vector<std::array<double, 3>> vectors(n * n * n);
+  for (std::size_t index = 0; index < scalars.size(); ++index) {
+    scalars[index] = 0.5 * static_cast<double>(index) - 3.;
+    vectors[index] = {static_cast<double>(index), -static_cast<double>(index), 0.25 * static_cast<double>(index)};
+  }
+
+  auto check = [&](const std::string& filename) {
+    RectilinearGridParser parser{filename};
+    const auto parsed_mesh = parser.mesh<double>();
+    CHECK(parsed_mesh->n_vertices() == n * n * n);
+    CHECK_THAT(parsed_mesh->vertices().front(), WithinRel(mesh->vertices().front(), 1.e-12));
+
+    CHECK(parser.scalar_data<double>("SCALARS Pressure double") == scalars);
+    const auto [x, y, z] = parser.vector_components<double>("VECTORS Velocity double");
+    REQUIRE(x.size() == vectors.size());
+    for (std::size_t index = 0; index < vectors.size(); ++index) {
+      REQUIRE(x[index] == vectors[index][0]);
+      REQUIRE(y[index] == vectors[index][1]);
+      REQUIRE(z[index] == vectors[index][2]);
+    }
+
+    std::vector<float> fx(vectors.size()), fy(vectors.size()), fz(vectors.size());
+    parser.read_vector_components<float>(fx, fy, fz, "VECTORS Velocity double");
+    CHECK(fz.back() == static_cast<float>(vectors.back()[2]));
+  };
+
+  GIVEN("Legacy ASCII and binary files") {
+    for (const auto format: {VtkFormat::ascii, VtkFormat::binary}) {
+      const std::string filename = fmt::format("tests_mesh/parsed_cube_{}.vtk", vtk_format_name(format));
+      std::filesystem::remove(filename);
+      {
+        VtkRectilinearGridSaver saver{filename, format};
+        saver.save_mesh<double>(mesh);
+        saver.save_vector_data(vectors, "Velocity");
+        saver.save_scalar_data(scalars.cbegin(), scalars.cend(), "Pressure");
+      }
+      THEN(fmt::format("The {} values are read back exactly", vtk_format_name(format))) {
+        check(filename);
+      }
+    }
+  }
+
+  GIVEN("XML file with the appended raw arrays") {
+    const std::string filename = "tests_mesh/parsed_cube.vtr";
+    {
+      VtrRectilinearGridSaver saver{filename};
+      saver.save_mesh<double>(mesh);
+      saver.save_vector_data(vectors, "Velocity");
+      saver.save_scalar_data(scalars.cbegin(), scalars.cend(), "Pressure");
+    }
+    THEN("The arrays are found by their names") {
+      check(filename);
+    }
+  }
+
+  GIVEN("XML appended arrays running past the end of the file") {
+    const auto write_vtr = [](const std::string& filename, std::string_view header_type, std::size_t offset, auto size) {
+      std::ofstream file{filename, std::ios_base::binary};
+      file << fmt::format("<?xml version=\"1.0\"?>\n"
+                          "<VTKFile type=\"RectilinearGrid\" version=\"1.0\" byte_order=\"{}\" header_type=\"{}\">\n"
+                          "  <RectilinearGrid WholeExtent=\"0 1 0 1 0 1\">\n"
+                          "    <Piece Extent=\"0 1 0 1 0 1\">\n"
+                          "      <PointData>\n"
+                          "        <DataArray type=\"Float64\" Name=\"Pressure\" NumberOfComponents=\"1\" format=\"appended\" offset=\"{}\"/>\n"
+                          "      </PointData>\n"
+                          "    </Piece>\n"
+                          "  </RectilinearGrid>\n"
+                          "  <AppendedData encoding=\"raw\">\n"
+                          "   _",
+                          std::endian::native == std::endian::little ? "LittleEndian" : "BigEndian", header_type, offset);
+      file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+      const double value = 1.;
+      file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    for (const std::string_view header_type: {"UInt64", "UInt32"}) {
+      const std::string filename = fmt::format("tests_mesh/truncated_{}.vtr", header_type);
+      THEN(fmt::format("An array longer than the file throws with {} sizes", header_type)) {
+        if (header_type == "UInt64") {
+          write_vtr(filename, header_type, 0, std::uint64_t{1000});
+        } else {
+          write_vtr(filename, header_type, 0, std::uint32_t{1000});
+        }
+        RectilinearGridParser parser{filename};
+        REQUIRE_THROWS_AS(parser.scalar_data<double>(), std::runtime_error);
+      }
+      THEN(fmt::format("A size header past the end of the file throws with {} sizes", header_type)) {
+        write_vtr(filename, header_type, 10, std::uint32_t{8});
+        RectilinearGridParser parser{filename};
+        REQUIRE_THROWS_AS(parser.scalar_data<double>(), std::runtime_error);
+      }
+    }
+
+    THEN("A size whose end overflows throws") {
+      const std::string filename = "tests_mesh/overflowing.vtr";
+      write_vtr(filename, "UInt64", 0, std::numeric_limits<std::uint64_t>::max());
+      RectilinearGridParser parser{filename};
+      REQUIRE_THROWS_AS(parser.scalar_data<double>(), std::runtime_error);
+    }
+  }
+
+  GIVEN("Malformed ASCII values") {
+    const std::string filename = "tests_mesh/malformed_cube.vtk";
+    {
+      std::ofstream file{filename};
+      file << "# vtk DataFile Version 2.0\nFunc\nASCII\nDATASET RECTILINEAR_GRID\nPOINT_DATA 3\n"
+              "SCALARS data double 1\nLOOKUP_TABLE default\n1.5\n2.x\n3\n";
+    }
+    THEN("Parsing throws") {
+      RectilinearGridParser parser{filename};
+      REQUIRE_THROWS_AS(parser.scalar_data<double>(), std::runtime_error);
+    }
+  }
+}
@@ -0,0 +1,107 @@
+#ifndef STG_COUNTER_BASED_ENGINE_HPP
+#define STG_COUNTER_BASED_ENGINE_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace stg::random {
+
+    /*
+     * Philox4x32-10 counter based engine (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+     * Block number i of the stream s is a pure function of (seed, s, i):
+     * key = seed, counter = (i, s), so any (seed, stream, counter) position is
+     * reached in O(1) and streams drawn by different threads never overlap.
+     * Satisfies UniformRandomBitGenerator, every block gives four 32 bit values
+     */
+    class Philox4x32 final {
+    public:
+        using result_type = std::uint32_t;
+        using counter_type = std::array<std::uint32_t, 4>;
+        using key_type = std::array<std::uint32_t, 2>;
+
+        static constexpr std::uint64_t default_seed = 20111115u;
+
+        static constexpr result_type min() noexcept { return 0; }
+        static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+        constexpr Philox4x32() noexcept : Philox4x32{default_seed} {}
+
+        constexpr explicit Philox4x32(std::uint64_t seed, std::uint64_t stream = 0, std::uint64_t counter = 0) noexcept
+            : key_{low(seed), high(seed)}, stream_{stream} {
+            seek(counter);
+        }
+
+        // Move to the first value of the block number counter
+        constexpr void seek(std::uint64_t counter) noexcept {
+            counter_ = counter;
+            position_ = block_size;
+        }
+
+        constexpr result_type operator()() noexcept {
+            if (position_ == block_size) {
+                output_ = block(key_, {low(counter_), high(counter_), low(stream_), high(stream_)});
+                ++counter_;
+                position_ = 0;
+            }
+            return output_[position_++];
+        }
+
+        constexpr void discard(unsigned long long z) noexcept {
+            const auto left_in_block = static_cast<unsigned long long>(block_size - position_);
+            if (z < left_in_block) {
+                position_ += static_cast<unsigned>(z);
+                return;
+            }
+            z -= left_in_block;
+            seek(counter_ + z / block_size);
+            for (z %= block_size; z > 0; --z) {
+                operator()();
+            }
+        }
+
+        constexpr std::uint64_t seed() const noexcept { return key_[0] | static_cast<std::uint64_t>(key_[1]) << 32; }
+
+        constexpr std::uint64_t stream() const noexcept { return stream_; }
+
+        /*
+         * Ten rounds of the philox bijection
+         */
+        static constexpr counter_type block(key_type key, counter_type counter) noexcept {
+            for (unsigned round = 0; round < rounds; ++round) {
+                const std::uint64_t product_0 = static_cast<std::uint64_t>(multiplier_0) * counter[0];
+                const std::uint64_t product_1 = static_cast<std::uint64_t>(multiplier_1) * counter[2];
+                counter = {high(product_1) ^ counter[1] ^ key[0], low(product_1),
+                           high(product_0) ^ counter[3] ^ key[1], low(product_0)};
+                key[0] += weyl_0;
+                key[1] += weyl_1;
+            }
+            return counter;
+        }
+
+        friend constexpr bool operator==(const Philox4x32& lhs, const Philox4x32& rhs) noexcept {
+            return lhs.key_ == rhs.key_ && lhs.stream_ == rhs.stream_ && lhs.counter_ == rhs.counter_ &&
+                   lhs.position_ == rhs.position_;
+        }
+
+    private:
+        static constexpr unsigned block_size = 4;
+        static constexpr unsigned rounds = 10;
+        static constexpr std::uint32_t multiplier_0 = 0xD2511F53u;
+        static constexpr std::uint32_t multiplier_1 = 0xCD9E8D57u;
+        static constexpr std::uint32_t weyl_0 = 0x9E3779B9u;
+        static constexpr std::uint32_t weyl_1 = 0xBB67AE85u;
+
+        key_type key_;
+        std::uint64_t stream_;
+        std::uint64_t counter_ = 0;
+        unsigned position_ = block_size;
+        counter_type output_{};
+
+        static constexpr std::uint32_t low(std::uint64_t value) noexcept { return static_cast<std::uint32_t>(value); }
+
+        static constexpr std::uint32_t high(std::uint64_t value) noexcept { return static_cast<std::uint32_t>(value >> 32); }
+    };
+}// namespace stg::random
+
+#endif//STG_COUNTER_BASED_ENGINE_HPP
@@ -2,6 +2,7 @@
 #define STG_IRN_GENERATOR_HPP
 
 #include <concepts>
+#include <span>
 #include <type_traits>
 #include "generator_concept.hpp"
 
@@ -13,6 +14,12 @@ namespace stg {
       using engine_type = std::nullptr_t;
       using distribution = std::nullptr_t;
       virtual result_type operator()() = 0;
+      // Bulk draw, one virtual call per span instead of per value
+      virtual void fill(std::span<result_type> values) {
+        for (auto& value : values) {
+          value = operator()();
+        }
+      }
       virtual ~IRNGenerator() = default;
   };
 }
@@ -1,16 +1,21 @@
 #ifndef STG_RANGOM_GENERATOR_MULTIDIM_GAUSSIAN_GENERATOR_HPP
 #define STG_RANGOM_GENERATOR_MULTIDIM_GAUSSIAN_GENERATOR_HPP
 
+#include "bulk_normal.hpp"
 #include "generator_engines.hpp"
 #include "irn_generator.hpp"
 #include <algorithm>
 #include <armadillo>
+#include <array>
 #include <concepts>
 #include <cstddef>
 #include <geometry/geometry.hpp>
 #include <random>
+#include <span>
+#include <stdexcept>
 #include <stg_tensor/tensor.hpp>
 #include <type_traits>
+#include <vector>
 
 namespace stg::random {
 
@@ -23,36 +28,41 @@ namespace stg::random {
         using value_type = T;
         using result_type = Vector<value_type>;
 
-        MultidimenasionalGaussianGenerator(Vector<T> mean, tensor::Tensor<T> covariance, std::size_t seed = std::mt19937_64::default_seed) noexcept(
-                std::is_nothrow_copy_constructible<Vector<T>>::value&&
-                        std::is_nothrow_copy_constructible<tensor::Tensor<T>>::value);
+        MultidimenasionalGaussianGenerator(Vector<T> mean, tensor::Tensor<T> covariance, std::size_t seed = std::mt19937_64::default_seed);
 
-
-        MultidimenasionalGaussianGenerator(const arma::vec3& mean, const arma::mat33& covariance, std::size_t seed = std::mt19937_64::default_seed) noexcept(
-                std::is_nothrow_copy_constructible<arma::vec3>::value&&
-                        std::is_nothrow_copy_constructible<arma::mat33>::value);
+        MultidimenasionalGaussianGenerator(const arma::vec3& mean, const arma::mat33& covariance, std::size_t seed = std::mt19937_64::default_seed);
 
         result_type operator()();
 
+        /*
+         * Batched path: 3 * out.size() standard normals are drawn in one call,
+         * every vector is mean + L z with the factor L L^T = covariance computed once. Uses its own engine seeded with the same seed,
+         * independent of the armadillo generator of operator()
+         */
+        void fill(std::span<result_type> out);
+
+        std::vector<result_type> operator()(std::size_t n);
+
         ~MultidimenasionalGaussianGenerator() = default;
 
     private:
         arma::vec3 mean_;
         arma::mat33 covariance_ = arma::mat::fixed<3, 3>();
+        arma::mat33 factor_;
+        engine_type engine_;
+        std::vector<T> normals_;
+
+        static arma::mat33 covariance_factor(const arma::mat33& covariance);
     };
 
 
     template<std::floating_point T>
-    MultidimenasionalGaussianGenerator<T>::MultidimenasionalGaussianGenerator(Vector<T> mean, tensor::Tensor<T> covariance, std::size_t seed) noexcept(
-            std::is_nothrow_copy_constructible<Vector<T>>::value&&
-                    std::is_nothrow_copy_constructible<tensor::Tensor<T>>::value)
-        : MultidimenasionalGaussianGenerator<T>{arma::vec::fixed<3>({mean.template get<0>(), mean.template get<0>(), mean.template get<0>()}), arma::mat::fixed<3, 3>(covariance.cbegin())} {}
+    MultidimenasionalGaussianGenerator<T>::MultidimenasionalGaussianGenerator(Vector<T> mean, tensor::Tensor<T> covariance, std::size_t seed)
+        : MultidimenasionalGaussianGenerator<T>{arma::vec::fixed<3>({mean.template get<0>(), mean.template get<1>(), mean.template get<2>()}), arma::mat::fixed<3, 3>(covariance.cbegin()), seed} {}
 
     template<std::floating_point T>
-    MultidimenasionalGaussianGenerator<T>::MultidimenasionalGaussianGenerator(const arma::vec3& mean, const arma::mat33& covariance, std::size_t seed) noexcept(
-            std::is_nothrow_copy_constructible<arma::vec3>::value&&
-                    std::is_nothrow_copy_constructible<arma::mat33>::value)
-        : mean_{mean}, covariance_{covariance} {
+    MultidimenasionalGaussianGenerator<T>::MultidimenasionalGaussianGenerator(const arma::vec3& mean, const arma::mat33& covariance, std::size_t seed)
+        : mean_{mean}, covariance_{covariance}, factor_{covariance_factor(covariance)}, engine_{seed} {
         arma::arma_rng::set_seed(seed);
     }
 
@@ -61,6 +71,51 @@ namespace stg::random {
         arma::vec3 arma_result = arma::mvnrnd(mean_, covariance_);
         return {arma_result.at(0), arma_result.at(1), arma_result.at(2)};
     }
+
+    template<std::floating_point T>
+    void MultidimenasionalGaussianGenerator<T>::fill(std::span<result_type> out) {
+        normals_.resize(3 * out.size());
+        fill_normal(engine_, std::span{normals_}, T{0}, T{1});
+        std::array<T, 9> l;
+        for (arma::uword i = 0; i < 3; ++i) {
+            for (arma::uword j = 0; j < 3; ++j) {
+                l[3 * i + j] = static_cast<T>(factor_.at(i, j));
+            }
+        }
+        const T m_x = static_cast<T>(mean_.at(0)), m_y = static_cast<T>(mean_.at(1)), m_z = static_cast<T>(mean_.at(2));
+        for (std::size_t index = 0; index < out.size(); ++index) {
+            const T z_0 = normals_[3 * index], z_1 = normals_[3 * index + 1], z_2 = normals_[3 * index + 2];
+            out[index] = {m_x + l[0] * z_0 + l[1] * z_1 + l[2] * z_2,
+                          m_y + l[3] * z_0 + l[4] * z_1 + l[5] * z_2,
+                          m_z + l[6] * z_0 + l[7] * z_1 + l[8] * z_2};
+        }
+    }
+
+    template<std::floating_point T>
+    std::vector<typename MultidimenasionalGaussianGenerator<T>::result_type> MultidimenasionalGaussianGenerator<T>::operator()(std::size_t n) {
+        std::vector<result_type> result(n);
+        fill(result);
+        return result;
+    }
+
+    /*
+     * Lower Cholesky factor, semi-definite covariances (zero variance components)
+     * fall back to V sqrt(max(lambda, 0)) of the symmetric eigen decomposition
+     */
+    template<std::floating_point T>
+    arma::mat33 MultidimenasionalGaussianGenerator<T>::covariance_factor(const arma::mat33& covariance) {
+        arma::mat33 lower;
+        if (arma::chol(lower, covariance, "lower")) {
+            return lower;
+        }
+        arma::vec eigen_values;
+        arma::mat eigen_vectors;
+        if (!arma::eig_sym(eigen_values, eigen_vectors, arma::symmatu(covariance))) {
+            throw std::invalid_argument("Covariance matrix is not symmetric positive semi-definite");
+        }
+        lower = eigen_vectors * arma::diagmat(arma::sqrt(arma::clamp(eigen_values, 0., arma::datum::inf)));
+        return lower;
+    }
 }// namespace stg::random
 
-#endif
\ No newline at end of file
+#endif
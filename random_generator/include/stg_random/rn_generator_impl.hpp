@@ -1,8 +1,12 @@
 #ifndef STG_RN_GENERATOR_IMPL_HPP
 #define STG_RN_GENERATOR_IMPL_HPP
 
+#include "bulk_normal.hpp"
 #include "generator_concept.hpp"
 #include "irn_generator.hpp"
+#include <random>
+#include <span>
+#include <type_traits>
 
 namespace stg {
   template<concepts::EngineConcept Engine, concepts::DistributionConcept<Engine> Distribution>
@@ -18,6 +22,20 @@ namespace stg {
 
     result_type operator()() override { return distribution_(engine_); }
 
+    /*
+     * Normal distributions are filled by the ziggurat method (fill_normal),
+     * the values differ from the ones of repeated operator() calls
+     */
+    void fill(std::span<result_type> values) override {
+      if constexpr (std::is_same_v<Distribution, std::normal_distribution<result_type>> && std::uniform_random_bit_generator<Engine>) {
+        random::fill_normal(engine_, values, distribution_.mean(), distribution_.stddev());
+      } else {
+        for (auto& value : values) {
+          value = distribution_(engine_);
+        }
+      }
+    }
+
     ~RNGenerator() override = default;
 
   private:
@@ -1,6 +1,7 @@
 #ifndef STG_STG_RANGOM_HPP
 #define STG_STG_RANGOM_HPP
 
+#include "stg_random/counter_based_engine.hpp"
 #include "stg_random/generator_concept.hpp"
 #include "stg_random/generator_engines.hpp"
 #include "stg_random/irn_generator.hpp"
@@ -0,0 +1,75 @@
+#include "common.hpp"
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <stg_random/counter_based_engine.hpp>
+#include <vector>
+
+using stg::random::Philox4x32;
+
+SCENARIO("Philox block function reproduces the reference answers") {
+  GIVEN("Known answer vectors of Philox4x32-10") {
+    REQUIRE(Philox4x32::block({0u, 0u}, {0u, 0u, 0u, 0u})
+            == Philox4x32::counter_type{0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u});
+    REQUIRE(Philox4x32::block({0xffffffffu, 0xffffffffu}, {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu})
+            == Philox4x32::counter_type{0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu});
+    REQUIRE(Philox4x32::block({0xa4093822u, 0x299f31d0u}, {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u})
+            == Philox4x32::counter_type{0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u});
+  }
+}
+
+SCENARIO("Counter based engine is addressed by seed, stream and counter") {
+  GIVEN("Engine of some stream") {
+    Philox4x32 engine{seed, 7};
+
+    WHEN("Other engine jumps over the same number of values") {
+      Philox4x32 skipped{seed, 7};
+      for (int i = 0; i < 11; ++i) {
+        engine();
+      }
+      skipped.discard(11);
+
+      THEN("Both engines give the same values") {
+        REQUIRE(engine == skipped);
+        REQUIRE(engine() == skipped());
+      }
+    }
+
+    WHEN("Other engine starts from the third block") {
+      Philox4x32 shifted{seed, 7, 3};
+      engine.discard(12);
+
+      THEN("Its first value is the thirteenth value of the stream") {
+        REQUIRE(engine() == shifted());
+      }
+    }
+
+    WHEN("Engine of the neighbour stream is created") {
+      Philox4x32 neighbour{seed, 8};
+
+      THEN("Streams differ") {
+        REQUIRE(engine() != neighbour());
+      }
+    }
+  }
+}
+
+SCENARIO("Parallel draws from per index streams do not depend on the schedule") {
+  GIVEN("Values drawn by index in parallel and sequentially") {
+    const std::size_t size = 10000;
+    const auto draw = [](std::size_t index) {
+      Philox4x32 engine{seed, index};
+      return std::normal_distribution<double>{0., 1.}(engine);
+    };
+
+    std::vector<std::size_t> indices(size);
+    std::iota(indices.begin(), indices.end(), 0ul);
+    std::vector<double> parallel(size), sequential(size);
+    std::transform(std::execution::par, indices.begin(), indices.end(), parallel.begin(), draw);
+    std::transform(indices.begin(), indices.end(), sequential.begin(), draw);
+
+    THEN("Results are equal") {
+      REQUIRE(parallel == sequential);
+    }
+  }
+}
@@ -1,5 +1,11 @@
 #include "common.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
 using namespace stg;
 
 struct GeneratorFixture {
@@ -23,4 +29,28 @@ SCENARIO_METHOD(GeneratorFixture, "Check that generator generate defined values
     CHECK_THAT(second_value, Catch::Matchers::WithinRel(1.29382, eps));
     CHECK(std::fabs(second_value - first_value) > eps);
   }
-}
\ No newline at end of file
+}
+SCENARIO("Bulk fill draws values of the generator distribution") {
+  GIVEN("Normal generator with its own engine") {
+    std::mt19937_64 engine{seed};
+    RNGenerator<std::mt19937_64, std::normal_distribution<>> generator{engine, std::normal_distribution<>{2., 3.}};
+    IRNGenerator<double>& interface = generator;
+
+    WHEN("Odd number of values is filled by one call") {
+      std::vector<double> values(1'000'001, std::numeric_limits<double>::quiet_NaN());
+      interface.fill(values);
+
+      THEN("Every value is set, mean and variance match the distribution") {
+        REQUIRE(std::ranges::none_of(values, [](double value) { return std::isnan(value); }));
+        const double mean = std::accumulate(values.begin(), values.end(), 0.) / values.size();
+        double variance = 0.;
+        for (const double value : values) {
+          variance += (value - mean) * (value - mean);
+        }
+        variance /= values.size();
+        CHECK_THAT(mean, WithinAbs(2., 1.e-2));
+        CHECK_THAT(variance, WithinRel(9., 1.e-2));
+      }
+    }
+  }
+}
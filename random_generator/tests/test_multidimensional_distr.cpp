@@ -46,4 +46,39 @@ SCENARIO("Create random values using multidimensional distribution") {
     std /= 1'000'000ull;
 
     CHECK_THAT(std, WithinRel(-0.000316637, eps));
-}
\ No newline at end of file
+}
+SCENARIO("Batched multidimensional generation follows the covariance") {
+    GIVEN("Degenerate covariance with correlated first components and zero third variance") {
+        arma::vec3 mean{1, -1, 2};
+        arma::mat33 covariance{4, 2, 0, 2, 3, 0, 0, 0, 0};
+        stg::random::MultidimenasionalGaussianGenerator<double> dist{mean, covariance, 42};
+
+        WHEN("Many vectors are generated by one call") {
+            const std::size_t size = 1'000'000;
+            const auto values = dist(size);
+
+            THEN("Sample mean and covariance match the given ones") {
+                REQUIRE(values.size() == size);
+                arma::vec3 sample_mean{0, 0, 0};
+                for (const auto& value: values) {
+                    sample_mean += arma::vec3{value.get<0>(), value.get<1>(), value.get<2>()};
+                }
+                sample_mean /= static_cast<double>(size);
+
+                arma::mat33 sample_covariance(arma::fill::zeros);
+                for (const auto& value: values) {
+                    const arma::vec3 deviation = arma::vec3{value.get<0>(), value.get<1>(), value.get<2>()} - sample_mean;
+                    sample_covariance += deviation * deviation.t();
+                }
+                sample_covariance /= static_cast<double>(size);
+
+                for (const arma::uword i: {0u, 1u, 2u}) {
+                    CHECK_THAT(sample_mean.at(i), WithinAbs(mean.at(i), 1.e-2));
+                    for (const arma::uword j: {0u, 1u, 2u}) {
+                        CHECK_THAT(sample_covariance.at(i, j), WithinAbs(covariance.at(i, j), 2.e-2));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -2,6 +2,7 @@
 #define STG_STATISTICS_HPP
 
 #include "statistics/mean.hpp"
+#include "statistics/moments.hpp"
 #include "statistics/standard_deviation.hpp"
 #include "statistics/standard_deviation.hpp"
 #include "statistics/covariance.hpp"
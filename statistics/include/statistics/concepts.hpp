@@ -3,6 +3,7 @@
 
 #include <concepts>
 #include <iterator>
+#include <ranges>
 #include <range/v3/all.hpp>
 
 namespace stg::statistics {
@@ -49,6 +50,11 @@ namespace stg::statistics {
                             && Deductible<RangeValueType<Range>>
                             && Multiplicable<RangeValueType<Range>>
                             && std::is_arithmetic_v<RangeValueType<Range>>;
+
+  // Floating point values stored one after another, e.g. a vector or a span
+  template<typename Range>
+  concept ContiguousNumericRange = std::ranges::contiguous_range<Range>
+                                   && std::floating_point<std::ranges::range_value_t<Range>>;
 }
 
 #endif //STG_CONCEPTS_HPP
@@ -1,10 +1,12 @@
 #ifndef STG_CORRELATION_HPP
 #define STG_CORRELATION_HPP
 
+#include <array>
 #include <iterator>
 #include <stg_tensor/tensor.hpp>
 #include "concepts.hpp"
 #include "covariance.hpp"
+#include "moments.hpp"
 #include "standard_deviation.hpp"
 
 namespace stg::statistics {
@@ -23,78 +25,27 @@ using namespace stg::tensor;
 
     template<NumericViewable Range>
     static Tensor<RangeValueType<Range>> correlation_tensor(Range&& f_range, Range&& s_range, Range&& t_range) {
-      auto f_mean_f = std::async(std::launch::async, [&] { return Mean::mean(f_range); });
-      auto s_mean_f = std::async(std::launch::async, [&] { return Mean::mean(s_range); });
-      auto t_mean_f = std::async(std::launch::async, [&] { return Mean::mean(t_range); });
-
-      const auto f_mean = f_mean_f.get();
-      const auto s_mean = s_mean_f.get();
-      const auto t_mean = t_mean_f.get();
-
-      auto f_std_f = std::async(std::launch::async, [&] { return StandardDeviation::std(f_range, f_mean); });
-      auto s_std_f = std::async(std::launch::async, [&] { return StandardDeviation::std(s_range, s_mean); });
-      auto t_std_f = std::async(std::launch::async, [&] { return StandardDeviation::std(t_range, t_mean); });
-
-      return correlation_tensor(std::forward<Range>(f_range),
-                                std::forward<Range>(s_range),
-                                std::forward<Range>(t_range),
-                                f_mean, s_mean, t_mean,
-                                f_std_f.get(), s_std_f.get(), t_std_f.get());
+      const auto moments = Moments::sample_moments(f_range, s_range, t_range);
+      const std::array<double, 3> means{moments.mean(0), moments.mean(1), moments.mean(2)};
+      const std::array<double, 3> stds{moments.std(0, means[0]), moments.std(1, means[1]), moments.std(2, means[2])};
+      return Moments::correlation_tensor<RangeValueType<Range>>(moments, means, stds);
     }
 
     template<NumericViewable Range, std::floating_point MeanValueType>
     static auto correlation_tensor(Range&& f_range, Range&& s_range, Range&& t_range,
                                    MeanValueType f_mean, MeanValueType s_mean, MeanValueType t_mean) {
-      auto f_std_f = std::async(std::launch::async, [&] { return StandardDeviation::std(f_range, f_mean); });
-      auto s_std_f = std::async(std::launch::async, [&] { return StandardDeviation::std(s_range, s_mean); });
-      auto t_std_f = std::async(std::launch::async, [&] { return StandardDeviation::std(t_range, t_mean); });
-
-      return correlation_tensor(std::forward<Range>(f_range),
-                                std::forward<Range>(s_range),
-                                std::forward<Range>(t_range),
-                                f_mean, s_mean, t_mean,
-                                f_std_f.get(), s_std_f.get(), t_std_f.get());
+      const auto moments = Moments::sample_moments(f_range, s_range, t_range);
+      const std::array<double, 3> stds{moments.std(0, f_mean), moments.std(1, s_mean), moments.std(2, t_mean)};
+      return Moments::correlation_tensor(moments, {f_mean, s_mean, t_mean}, stds);
     }
 
     template<NumericViewable Range, std::floating_point MeanValueType>
     static auto correlation_tensor(Range&& f_range, Range&& s_range, Range&& t_range,
                                    MeanValueType first_mean, MeanValueType second_mean, MeanValueType third_mean,
                                    MeanValueType first_std, MeanValueType second_std, MeanValueType third_std) {
-      auto c_11_f = std::async(std::launch::async, [&] {
-        return Correlation::correlation(f_range, f_range,
-                                        first_mean, first_mean,
-                                        first_std, first_std); });
-      auto c_12_f = std::async(std::launch::async, [&] {
-        return Correlation::correlation(f_range, s_range,
-                                        first_mean, second_mean,
-                                        first_std, second_std); });
-      auto c_13_f = std::async(std::launch::async, [&] {
-        return Correlation::correlation(f_range, t_range,
-                                        first_mean, third_mean,
-                                        first_std, third_std); });
-      auto c_22_f = std::async(std::launch::async, [&] {
-        return Correlation::correlation(s_range, s_range,
-                                        second_mean, second_mean,
-                                        second_std, second_std); });
-      auto c_23_f = std::async(std::launch::async, [&] {
-        return Correlation::correlation(s_range, t_range,
-                                        second_mean, third_mean,
-                                        second_std, third_std); });
-      auto c_33_f = std::async(std::launch::async, [&] {
-        return Correlation::correlation(t_range, t_range,
-                                        third_mean, third_mean,
-                                        third_std, third_std); });
-
-      auto c_11 = c_11_f.get();
-      auto c_12 = c_12_f.get();
-      auto c_13 = c_13_f.get();
-      auto c_22 = c_22_f.get();
-      auto c_23 = c_23_f.get();
-      auto c_33 = c_33_f.get();
-
-      return Tensor{ c_11, c_12, c_13,
-                     c_12, c_22, c_23,
-                     c_13, c_23, c_33};
+      const auto moments = Moments::sample_moments(f_range, s_range, t_range);
+      return Moments::correlation_tensor(moments, {first_mean, second_mean, third_mean},
+                                         {first_std, second_std, third_std});
     }
 
     template<NumericViewable FirstRange, NumericViewable SecondRange>
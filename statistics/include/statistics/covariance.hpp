@@ -3,7 +3,6 @@
 
 #include <execution>
 #include <ranges>
-#include <future>
 #include <algorithm>
 #include <numeric>
 #include <cmath>
@@ -11,6 +10,7 @@
 #include <stg_tensor/tensor.hpp>
 #include "concepts.hpp"
 #include "mean.hpp"
+#include "moments.hpp"
 #include "standard_deviation.hpp"
 
 
@@ -22,14 +22,10 @@ using namespace stg::tensor;
 
     template<NumericViewable FirstRange, NumericViewable SecondRange>
     static auto covariance(FirstRange&& f_range, SecondRange&& s_range) {
-      auto f_mean = std::async(std::launch::async, [&] {
-        return Mean::mean(s_range);
-      });
-      auto s_mean = std::async(std::launch::async, [&] {
-        return Mean::mean(s_range);
-      });
-
-      return covariance(f_range, s_range, f_mean.get(), s_mean.get());
+      const auto f_mean = Mean::mean(f_range);
+      const auto s_mean = Mean::mean(s_range);
+
+      return covariance(f_range, s_range, f_mean, s_mean);
     }
 
     template<NumericViewable FirstRange, NumericViewable SecondRange,
@@ -51,47 +47,14 @@ using namespace stg::tensor;
     static auto covariance_tensor(Range&& f_range, Range&& s_range, Range&& t_range,
                                   MeanValueType first_mean, MeanValueType second_mean,
                                   MeanValueType third_mean) {
-      auto c_11_f = std::async(std::launch::async, [&] {
-        return Covariance::covariance(f_range, f_range,
-                                      first_mean, first_mean); });
-      auto c_12_f = std::async(std::launch::async, [&] {
-        return Covariance::covariance(f_range, s_range,
-                                      first_mean, second_mean); });
-      auto c_13_f = std::async(std::launch::async, [&] {
-        return Covariance::covariance(f_range, t_range,
-                                      first_mean, third_mean); });
-      auto c_22_f = std::async(std::launch::async, [&] {
-        return Covariance::covariance(s_range, s_range,
-                                      second_mean, second_mean); });
-      auto c_23_f = std::async(std::launch::async, [&] {
-        return Covariance::covariance(s_range, t_range,
-                                      second_mean, third_mean); });
-      auto c_33_f = std::async(std::launch::async, [&] {
-        return Covariance::covariance(t_range, t_range,
-                                      third_mean, third_mean); });
-
-      auto c_11 = c_11_f.get();
-      auto c_12 = c_12_f.get();
-      auto c_13 = c_13_f.get();
-      auto c_22 = c_22_f.get();
-      auto c_23 = c_23_f.get();
-      auto c_33 = c_33_f.get();
-
-      return Tensor{ c_11, c_12, c_13,
-                     c_12, c_22, c_23,
-                     c_13, c_23, c_33 };
+      const auto moments = Moments::sample_moments(f_range, s_range, t_range);
+      return Moments::covariance_tensor(moments, {first_mean, second_mean, third_mean});
     }
 
     template<NumericViewable Range>
     static auto covariance_tensor(Range&& f_range, Range&& s_range, Range&& t_range) {
-      const auto f_mean = Mean::mean(std::forward<Range>(f_range));
-      const auto s_mean = Mean::mean(std::forward<Range>(s_range));
-      const auto t_mean = Mean::mean(std::forward<Range>(t_range));
-
-      return covariance_tensor(std::forward<Range>(f_range),
-                               std::forward<Range>(s_range),
-                               std::forward<Range>(t_range),
-                               f_mean, s_mean, t_mean);
+      const auto moments = Moments::sample_moments(f_range, s_range, t_range);
+      return Moments::covariance_tensor(moments, {moments.mean(0), moments.mean(1), moments.mean(2)});
     }
 
     template<std::forward_iterator Iter>
@@ -0,0 +1,260 @@
+#ifndef STG_STATISTICS_MOMENTS_HPP
+#define STG_STATISTICS_MOMENTS_HPP
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <stdexcept>
+#include <stg_tensor/tensor.hpp>
+#include "concepts.hpp"
+
+namespace stg::statistics {
+using namespace stg::tensor;
+
+  /*
+   * Raw sums of a sample of vectors (x, y, z): sums of the components and
+   * sums of their products, products[3 * i + j] = sum x_i * x_j
+   */
+  struct SampleMoments final {
+    std::size_t size = 0;
+    std::array<double, 3> sums{};
+    std::array<double, 9> products{};
+
+    void add(const std::array<double, 3>& v) {
+      ++size;
+      for (std::size_t i = 0; i < 3; ++i) {
+        sums[i] += v[i];
+        for (std::size_t j = 0; j < 3; ++j) {
+          products[3 * i + j] += v[i] * v[j];
+        }
+      }
+    }
+
+    // Merges the sums of a disjoint sample
+    SampleMoments& operator+=(const SampleMoments& other) {
+      size += other.size;
+      for (std::size_t i = 0; i < 3; ++i) {
+        sums[i] += other.sums[i];
+      }
+      for (std::size_t i = 0; i < 9; ++i) {
+        products[i] += other.products[i];
+      }
+      return *this;
+    }
+
+    double mean(std::size_t i) const { return sums[i] / size; }
+
+    double std(std::size_t i, double mean) const { return std::sqrt(products[4 * i] / size - mean * mean); }
+
+    double covariance(std::size_t i, std::size_t j, double mean_i, double mean_j) const {
+      return products[3 * i + j] / size - mean_i * mean_j;
+    }
+  };
+
+  /*
+   * Raw sums of two samples of vectors f and s taken at the same realizations,
+   * products[3 * i + j] = sum f_i * s_j
+   */
+  struct CrossMoments final {
+    std::size_t size = 0;
+    std::array<double, 3> first_sums{}, second_sums{};
+    std::array<double, 3> first_squares{}, second_squares{};
+    std::array<double, 9> products{};
+
+    double first_mean(std::size_t i) const { return first_sums[i] / size; }
+
+    double second_mean(std::size_t i) const { return second_sums[i] / size; }
+
+    double first_std(std::size_t i, double mean) const { return std::sqrt(first_squares[i] / size - mean * mean); }
+
+    double second_std(std::size_t i, double mean) const { return std::sqrt(second_squares[i] / size - mean * mean); }
+
+    double covariance(std::size_t i, std::size_t j, double first_mean, double second_mean) const {
+      return products[3 * i + j] / size - first_mean * second_mean;
+    }
+  };
+
+  /*
+   * Single pass kernels for the 3x3 statistics tensors: every sum, sum of squares and
+   * cross product is accumulated in one sweep over the component samples instead of
+   * one sweep per mean, deviation and tensor component. The tensors are the same
+   * E[ab] - E[a] E[b] estimates as Covariance and Correlation give
+   */
+  class Moments final {
+  public:
+    template<NumericViewable XRange, NumericViewable YRange, NumericViewable ZRange>
+    static SampleMoments sample_moments(XRange&& x_range, YRange&& y_range, ZRange&& z_range) {
+      SampleMoments moments;
+      moments.size = checked_size(x_range, y_range, z_range);
+      auto x = ranges::begin(x_range);
+      auto y = ranges::begin(y_range);
+      auto z = ranges::begin(z_range);
+      for (std::size_t index = 0; index < moments.size; ++index, ++x, ++y, ++z) {
+        const std::array<double, 3> v{static_cast<double>(*x), static_cast<double>(*y), static_cast<double>(*z)};
+        for (std::size_t i = 0; i < 3; ++i) {
+          moments.sums[i] += v[i];
+          for (std::size_t j = i; j < 3; ++j) {
+            moments.products[3 * i + j] += v[i] * v[j];
+          }
+        }
+      }
+      for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < i; ++j) {
+          moments.products[3 * i + j] = moments.products[3 * j + i];
+        }
+      }
+      return moments;
+    }
+
+    template<NumericViewable FirstRange, NumericViewable SecondRange, NumericViewable ThirdRange>
+    static CrossMoments cross_moments(FirstRange&& f_x_range, FirstRange&& s_x_range,
+                                      SecondRange&& f_y_range, SecondRange&& s_y_range,
+                                      ThirdRange&& f_z_range, ThirdRange&& s_z_range) {
+      if constexpr (ContiguousNumericRange<FirstRange> && ContiguousNumericRange<SecondRange> && ContiguousNumericRange<ThirdRange>) {
+        return lane_cross_moments(std::ranges::data(f_x_range), std::ranges::data(s_x_range),
+                                  std::ranges::data(f_y_range), std::ranges::data(s_y_range),
+                                  std::ranges::data(f_z_range), std::ranges::data(s_z_range),
+                                  checked_size(f_x_range, s_x_range, f_y_range, s_y_range, f_z_range, s_z_range));
+      } else {
+        CrossMoments moments;
+        moments.size = checked_size(f_x_range, s_x_range, f_y_range, s_y_range, f_z_range, s_z_range);
+        auto f_x = ranges::begin(f_x_range);
+        auto f_y = ranges::begin(f_y_range);
+        auto f_z = ranges::begin(f_z_range);
+        auto s_x = ranges::begin(s_x_range);
+        auto s_y = ranges::begin(s_y_range);
+        auto s_z = ranges::begin(s_z_range);
+        for (std::size_t index = 0; index < moments.size; ++index, ++f_x, ++f_y, ++f_z, ++s_x, ++s_y, ++s_z) {
+          const std::array<double, 3> f{static_cast<double>(*f_x), static_cast<double>(*f_y), static_cast<double>(*f_z)};
+          const std::array<double, 3> s{static_cast<double>(*s_x), static_cast<double>(*s_y), static_cast<double>(*s_z)};
+          for (std::size_t i = 0; i < 3; ++i) {
+            moments.first_sums[i] += f[i];
+            moments.second_sums[i] += s[i];
+            moments.first_squares[i] += f[i] * f[i];
+            moments.second_squares[i] += s[i] * s[i];
+            for (std::size_t j = 0; j < 3; ++j) {
+              moments.products[3 * i + j] += f[i] * s[j];
+            }
+          }
+        }
+        return moments;
+      }
+    }
+
+    template<std::floating_point T = double>
+    static Tensor<T> covariance_tensor(const SampleMoments& moments, const std::array<double, 3>& means) {
+      std::array<T, 9> result;
+      for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+          result[3 * i + j] = static_cast<T>(moments.covariance(i, j, means[i], means[j]));
+        }
+      }
+      return Tensor<T>{result};
+    }
+
+    template<std::floating_point T = double>
+    static Tensor<T> correlation_tensor(const SampleMoments& moments, const std::array<double, 3>& means,
+                                        const std::array<double, 3>& stds) {
+      std::array<T, 9> result;
+      for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+          result[3 * i + j] = static_cast<T>(moments.covariance(i, j, means[i], means[j]) / (stds[i] * stds[j]));
+        }
+      }
+      return Tensor<T>{result};
+    }
+
+    template<std::floating_point T = double>
+    static Tensor<T> covariance_tensor(const CrossMoments& moments,
+                                       const std::array<double, 3>& first_means,
+                                       const std::array<double, 3>& second_means) {
+      std::array<T, 9> result;
+      for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+          result[3 * i + j] = static_cast<T>(moments.covariance(i, j, first_means[i], second_means[j]));
+        }
+      }
+      return Tensor<T>{result};
+    }
+
+    template<std::floating_point T = double>
+    static Tensor<T> correlation_tensor(const CrossMoments& moments,
+                                        const std::array<double, 3>& first_means,
+                                        const std::array<double, 3>& second_means,
+                                        const std::array<double, 3>& first_stds,
+                                        const std::array<double, 3>& second_stds) {
+      std::array<T, 9> result;
+      for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+          result[3 * i + j] = static_cast<T>(moments.covariance(i, j, first_means[i], second_means[j]) / (first_stds[i] * second_stds[j]));
+        }
+      }
+      return Tensor<T>{result};
+    }
+
+  private:
+    static constexpr std::size_t lanes = 4;
+
+    /*
+     * cross_moments of contiguous samples (e.g. the vertex-major layout): the samples
+     * index % lanes go to independent lane sums the compiler keeps in SIMD registers,
+     * the lanes are added at the end
+     */
+    template<typename F, typename S, typename G, typename H, typename U, typename V>
+    static CrossMoments lane_cross_moments(const F* f_x, const S* s_x, const G* f_y, const H* s_y,
+                                           const U* f_z, const V* s_z, std::size_t size) {
+      std::array<std::array<double, lanes>, 3> first_sums{}, second_sums{}, first_squares{}, second_squares{};
+      std::array<std::array<double, lanes>, 9> products{};
+      const auto accumulate = [&](std::size_t index, std::size_t lane) {
+        const std::array<double, 3> f{static_cast<double>(f_x[index]), static_cast<double>(f_y[index]), static_cast<double>(f_z[index])};
+        const std::array<double, 3> s{static_cast<double>(s_x[index]), static_cast<double>(s_y[index]), static_cast<double>(s_z[index])};
+        for (std::size_t i = 0; i < 3; ++i) {
+          first_sums[i][lane] += f[i];
+          second_sums[i][lane] += s[i];
+          first_squares[i][lane] += f[i] * f[i];
+          second_squares[i][lane] += s[i] * s[i];
+          for (std::size_t j = 0; j < 3; ++j) {
+            products[3 * i + j][lane] += f[i] * s[j];
+          }
+        }
+      };
+      std::size_t index = 0;
+      for (; index + lanes <= size; index += lanes) {
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+          accumulate(index + lane, lane);
+        }
+      }
+      for (; index < size; ++index) {
+        accumulate(index, index % lanes);
+      }
+
+      CrossMoments moments;
+      moments.size = size;
+      const auto add_lanes = [](const std::array<double, lanes>& sums) {
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+      };
+      for (std::size_t i = 0; i < 3; ++i) {
+        moments.first_sums[i] = add_lanes(first_sums[i]);
+        moments.second_sums[i] = add_lanes(second_sums[i]);
+        moments.first_squares[i] = add_lanes(first_squares[i]);
+        moments.second_squares[i] = add_lanes(second_squares[i]);
+      }
+      for (std::size_t i = 0; i < 9; ++i) {
+        moments.products[i] = add_lanes(products[i]);
+      }
+      return moments;
+    }
+
+    template<typename Range, typename... Ranges>
+    static std::size_t checked_size(Range&& range, Ranges&&... others) {
+      const std::size_t size = ranges::distance(range);
+      if (((static_cast<std::size_t>(ranges::distance(others)) != size) || ...)) {
+        throw std::logic_error("Ranges sizes are not equal");
+      }
+      return size;
+    }
+  };
+}
+
+#endif //STG_STATISTICS_MOMENTS_HPP
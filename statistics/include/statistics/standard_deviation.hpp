@@ -6,7 +6,6 @@
 #include <algorithm>
 #include <numeric>
 #include <cmath>
-#include <future>
 #include <fmt/format.h>
 #include "concepts.hpp"
 #include "mean.hpp"
@@ -67,11 +66,11 @@ namespace rv = ranges::views;
 
     template<NumericViewable FirstRange, NumericViewable SecondRange>
     static auto std(FirstRange&& f_range, SecondRange&& s_range) {
-      auto f_mean = std::async(std::launch::async, [f_range] {return Mean::mean(f_range); });
-      auto s_mean = std::async(std::launch::async, [s_range] {return Mean::mean(s_range); });
+      const auto f_mean = Mean::mean(f_range);
+      const auto s_mean = Mean::mean(s_range);
       return std(std::forward<FirstRange>(f_range),
                  std::forward<SecondRange>(s_range),
-                 f_mean.get(), s_mean.get());
+                 f_mean, s_mean);
     }
   };
 
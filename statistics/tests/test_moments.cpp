@@ -0,0 +1,142 @@
+#include "common.hpp"
+#include <list>
+#include <span>
+
+struct MomentsFixture {
+  constexpr static inline double eps = 1.e-9;
+  constexpr static inline std::size_t size = 1000;
+
+  std::array<std::vector<double>, 3> first;
+  std::array<std::vector<double>, 3> second;
+
+  MomentsFixture() {
+    std::mt19937_64 engine{seed};
+    // Shifted and scaled components, so the means and the deviations differ
+    for (std::size_t i = 0; i < 3; ++i) {
+      std::normal_distribution<double> first_distribution{0.5 * i, 1. + i};
+      std::normal_distribution<double> second_distribution{-1. * i, 2. - 0.5 * i};
+      first[i].resize(size);
+      second[i].resize(size);
+      std::generate(first[i].begin(), first[i].end(), [&] { return first_distribution(engine); });
+      std::generate(second[i].begin(), second[i].end(), [&] { return second_distribution(engine); });
+    }
+    // Correlated components
+    for (std::size_t index = 0; index < size; ++index) {
+      first[1][index] += 0.5 * first[0][index];
+      second[2][index] -= 0.25 * first[0][index];
+    }
+  }
+};
+
+SCENARIO_METHOD(MomentsFixture, "Single pass moments agree with the separate statistics") {
+  GIVEN("Moments of one sample of vectors") {
+    const auto moments = Moments::sample_moments(first[0], first[1], first[2]);
+
+    THEN("Means, deviations and covariances are those of Mean, StandardDeviation and Covariance") {
+      REQUIRE(moments.size == size);
+      for (std::size_t i = 0; i < 3; ++i) {
+        const double mean = Mean::mean(first[i]);
+        CHECK_THAT(moments.mean(i), WithinAbs(mean, eps));
+        CHECK_THAT(moments.std(i, moments.mean(i)), WithinRel(StandardDeviation::std(first[i]), eps));
+        for (std::size_t j = 0; j < 3; ++j) {
+          const double covariance = moments.covariance(i, j, moments.mean(i), moments.mean(j));
+          CHECK_THAT(covariance, WithinAbs(Covariance::covariance(first[i], first[j]), eps));
+        }
+      }
+    }
+
+    THEN("Moments of two halves merge into the moments of the whole sample") {
+      const auto half = [this](std::size_t i, std::size_t part) {
+        return std::span<const double>{first[i]}.subspan(part * size / 2, size / 2);
+      };
+      auto merged = Moments::sample_moments(half(0, 0), half(1, 0), half(2, 0));
+      merged += Moments::sample_moments(half(0, 1), half(1, 1), half(2, 1));
+      REQUIRE(merged.size == moments.size);
+      for (std::size_t i = 0; i < 3; ++i) {
+        CHECK_THAT(merged.sums[i], WithinAbs(moments.sums[i], eps));
+      }
+      for (std::size_t i = 0; i < 9; ++i) {
+        CHECK_THAT(merged.products[i], WithinRel(moments.products[i], eps));
+      }
+    }
+  }
+
+  GIVEN("Cross moments of two samples of vectors") {
+    const auto moments = Moments::cross_moments(first[0], second[0], first[1], second[1], first[2], second[2]);
+
+    THEN("Means, deviations and cross covariances are those of Mean, StandardDeviation and Covariance") {
+      REQUIRE(moments.size == size);
+      for (std::size_t i = 0; i < 3; ++i) {
+        CHECK_THAT(moments.first_mean(i), WithinAbs(Mean::mean(first[i]), eps));
+        CHECK_THAT(moments.second_mean(i), WithinAbs(Mean::mean(second[i]), eps));
+        CHECK_THAT(moments.first_std(i, moments.first_mean(i)), WithinRel(StandardDeviation::std(first[i]), eps));
+        CHECK_THAT(moments.second_std(i, moments.second_mean(i)), WithinRel(StandardDeviation::std(second[i]), eps));
+        for (std::size_t j = 0; j < 3; ++j) {
+          const double covariance = moments.covariance(i, j, moments.first_mean(i), moments.second_mean(j));
+          CHECK_THAT(covariance, WithinAbs(Covariance::covariance(first[i], second[j]), eps));
+        }
+      }
+    }
+  }
+
+  GIVEN("Cross moments of samples whose length is not a multiple of the lanes") {
+    constexpr std::size_t odd_size = size - 3;
+    const auto part = [](const std::vector<double>& values) {
+      return std::span<const double>{values}.first(odd_size);
+    };
+    const auto moments = Moments::cross_moments(part(first[0]), part(second[0]), part(first[1]), part(second[1]),
+                                                part(first[2]), part(second[2]));
+
+    THEN("The remainder is accumulated, so the statistics are those of Mean and Covariance") {
+      REQUIRE(moments.size == odd_size);
+      for (std::size_t i = 0; i < 3; ++i) {
+        CHECK_THAT(moments.first_mean(i), WithinAbs(Mean::mean(part(first[i])), eps));
+        CHECK_THAT(moments.second_mean(i), WithinAbs(Mean::mean(part(second[i])), eps));
+        for (std::size_t j = 0; j < 3; ++j) {
+          const double covariance = moments.covariance(i, j, moments.first_mean(i), moments.second_mean(j));
+          CHECK_THAT(covariance, WithinAbs(Covariance::covariance(part(first[i]), part(second[j])), eps));
+        }
+      }
+    }
+
+    THEN("The lanes agree with the scalar loop over a non contiguous range") {
+      const auto list = [&](const std::vector<double>& values) {
+        const auto values_part = part(values);
+        return std::list<double>{values_part.begin(), values_part.end()};
+      };
+      const auto scalar = Moments::cross_moments(list(first[0]), list(second[0]), list(first[1]), list(second[1]),
+                                                 list(first[2]), list(second[2]));
+      REQUIRE(scalar.size == moments.size);
+      for (std::size_t i = 0; i < 3; ++i) {
+        CHECK_THAT(moments.first_sums[i], WithinAbs(scalar.first_sums[i], eps));
+        CHECK_THAT(moments.second_squares[i], WithinRel(scalar.second_squares[i], eps));
+      }
+      for (std::size_t i = 0; i < 9; ++i) {
+        CHECK_THAT(moments.products[i], WithinAbs(scalar.products[i], eps));
+      }
+    }
+  }
+
+  GIVEN("Cross moments of single precision samples") {
+    const auto to_float = [](const std::vector<double>& values) {
+      return std::vector<float>{values.begin(), values.end()};
+    };
+    const std::array<std::vector<float>, 3> first_float{to_float(first[0]), to_float(first[1]), to_float(first[2])};
+    const std::array<std::vector<float>, 3> second_float{to_float(second[0]), to_float(second[1]), to_float(second[2])};
+    const auto moments = Moments::cross_moments(first_float[0], second_float[0], first_float[1], second_float[1],
+                                                first_float[2], second_float[2]);
+
+    THEN("The values are accumulated in double precision up to the rounding of the inputs") {
+      constexpr double float_eps = 1.e-5;
+      REQUIRE(moments.size == size);
+      for (std::size_t i = 0; i < 3; ++i) {
+        CHECK_THAT(moments.first_mean(i), WithinAbs(Mean::mean(first[i]), float_eps));
+        CHECK_THAT(moments.second_mean(i), WithinAbs(Mean::mean(second[i]), float_eps));
+        for (std::size_t j = 0; j < 3; ++j) {
+          const double covariance = moments.covariance(i, j, moments.first_mean(i), moments.second_mean(j));
+          CHECK_THAT(covariance, WithinAbs(Covariance::covariance(first[i], second[j]), float_eps));
+        }
+      }
+    }
+  }
+}
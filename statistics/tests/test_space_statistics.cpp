@@ -59,3 +59,31 @@ SCENARIO_METHOD(RangesSpaceStatisticsFixture, "Calculate space covariation") {
                      test_corr.cbegin(), is_floating_equal));
   }
 }
+
+SCENARIO("Contiguous samples use the lane kernel") {
+  std::mt19937_64 engine{seed};
+  std::normal_distribution<double> distribution;
+  std::array<std::vector<double>, 6> samples;
+  for (auto& sample: samples) {
+    sample.resize(1003);
+    std::generate(sample.begin(), sample.end(), [&] { return distribution(engine); });
+  }
+  const auto strided = [](const std::vector<double>& sample) {
+    return sample | ranges::views::transform([](double value) { return value; });
+  };
+
+  const auto contiguous = Moments::cross_moments(samples[0], samples[1], samples[2], samples[3], samples[4], samples[5]);
+  const auto generic = Moments::cross_moments(strided(samples[0]), strided(samples[1]), strided(samples[2]),
+                                              strided(samples[3]), strided(samples[4]), strided(samples[5]));
+
+  THEN("The sums are the same up to the order of the additions") {
+    REQUIRE(contiguous.size == generic.size);
+    for (std::size_t i = 0; i < 3; ++i) {
+      CHECK_THAT(contiguous.first_sums[i], WithinAbs(generic.first_sums[i], 1e-9));
+      CHECK_THAT(contiguous.second_squares[i], WithinRel(generic.second_squares[i], 1e-12));
+    }
+    for (std::size_t i = 0; i < 9; ++i) {
+      CHECK_THAT(contiguous.products[i], WithinAbs(generic.products[i], 1e-9));
+    }
+  }
+}
@@ -1,7 +1,10 @@
 #ifndef STG_STG_GENERATORS_HPP
 #define STG_STG_GENERATORS_HPP
 
+#include "stg_generators/fourier_modes.hpp"
+#include "stg_generators/phasor_time_stepper.hpp"
 #include "stg_generators/spectral_generator.hpp"
+#include "stg_generators/static_spectral_generator.hpp"
 #include "stg_generators/i_fluctuation_generator.hpp"
 #include "stg_generators/generator_concept.hpp"
 #include "stg_generators/coro_generator.hpp"
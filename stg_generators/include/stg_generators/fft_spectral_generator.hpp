@@ -0,0 +1,150 @@
+#ifndef STG_FFT_SPECTRAL_GENERATOR_HPP
+#define STG_FFT_SPECTRAL_GENERATOR_HPP
+
+#include "fftw_plan_cache.hpp"
+#include "spectras_base.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <rtable/cube_relation_table.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace stg::generators {
+
+    /*
+     * Synthesis of a periodic divergence free velocity field on the cube mesh by inverse fft.
+     * The cube of n vertices per edge with the step h is treated as a period n * h, so the
+     * wave numbers are k = 2 pi / (n h) * m with -n / 2 < m < n / 2 (the DFT grid of the
+     * mesh; make_fourier_space() of the table covers the same band with another step).
+     * For every k
+     *     u(k) = sqrt(E(|k|) dk^3 / (4 pi |k|^2)) (I - k k^T / |k|^2) xi,
+     * xi is a complex normal vector with E|xi_i|^2 = 1, hence 1 / 2 sum |u(k)|^2 ~ int E(k) dk.
+     * The projection keeps k * u(k) = 0, the mean and the nyquist modes are set to zero,
+     * u(-k) = conj(u(k)) is enforced on the kx = 0 plane, the rest of the half spectrum is
+     * hermitian by construction of the complex to real transform.
+     * One generation costs three c2r transforms, O(N log N) instead of O(N modes)
+     */
+    template<std::floating_point T>
+    class FFTSpectralGenerator final {
+    public:
+        using value_type = T;
+        using velocity_components = std::array<std::vector<value_type>, 3>;
+
+        FFTSpectralGenerator(std::shared_ptr<mesh::CubeRelationTable<value_type>> space,
+                             std::shared_ptr<ISpectra<value_type>> spectra,
+                             int threads = static_cast<int>(std::thread::hardware_concurrency()))
+            : space_{std::move(space)}, spectra_{std::move(spectra)},
+              n_{static_cast<std::size_t>(space_->n())}, threads_{std::max(threads, 1)} {
+            if (n_ < 2) {
+                throw std::invalid_argument("Cube mesh needs at least two vertices along the edge");
+            }
+        }
+
+        std::size_t n_vertices() const noexcept { return n_ * n_ * n_; }
+
+        // Step of the wave numbers grid
+        double dk() const noexcept { return 2 * std::numbers::pi / (static_cast<double>(n_) * space_->h()); }
+
+        /*
+         * One realization of the field, components are indexed as the space vertices
+         * lin_index(i, j, k). The spectrum depends on the seed only, not on the number of threads
+         */
+        velocity_components operator()(std::size_t seed) const {
+            const std::size_t half = n_ / 2 + 1;
+            const std::size_t spectrum_size = n_ * n_ * half;
+            std::array<fftw_unique_ptr<fftw_complex>, 3> spectrum{fftw_allocate<fftw_complex>(spectrum_size),
+                                                                  fftw_allocate<fftw_complex>(spectrum_size),
+                                                                  fftw_allocate<fftw_complex>(spectrum_size)};
+            fill_spectrum(seed, spectrum);
+
+            const int n = static_cast<int>(n_);
+            const auto plan = FftwPlanCache::instance().c2r_3d({n, n, n}, threads_);
+            auto real = fftw_allocate<double>(n_vertices());
+            velocity_components result;
+            for (std::size_t component = 0; component < 3; ++component) {
+                fftw_execute_dft_c2r(plan.get(), spectrum[component].get(), real.get());
+                result[component].assign(real.get(), real.get() + n_vertices());
+            }
+            return result;
+        }
+
+    private:
+        std::shared_ptr<mesh::CubeRelationTable<value_type>> space_;
+        std::shared_ptr<ISpectra<value_type>> spectra_;
+        std::size_t n_;
+        int threads_;
+
+        // Signed wave number of the fft index
+        long wave_number(std::size_t index) const noexcept {
+            return index <= n_ / 2 ? static_cast<long>(index) : static_cast<long>(index) - static_cast<long>(n_);
+        }
+
+        bool is_nyquist(long m) const noexcept { return n_ % 2 == 0 && std::labs(m) == static_cast<long>(n_ / 2); }
+
+        // Half spectrum index of (kz, ky, kx), kx is the fastest as i in lin_index
+        std::size_t spectrum_index(std::size_t c, std::size_t b, std::size_t a) const noexcept {
+            return (c * n_ + b) * (n_ / 2 + 1) + a;
+        }
+
+        void fill_spectrum(std::size_t seed, std::array<fftw_unique_ptr<fftw_complex>, 3>& spectrum) const {
+            std::mt19937_64 engine{seed};
+            std::normal_distribution<double> normal{0., std::numbers::sqrt2 / 2};
+            const double dk = this->dk();
+            const double dk3 = dk * dk * dk;
+
+            for (std::size_t c = 0; c < n_; ++c) {
+                for (std::size_t b = 0; b < n_; ++b) {
+                    for (std::size_t a = 0; a < n_ / 2 + 1; ++a) {
+                        const std::size_t index = spectrum_index(c, b, a);
+                        std::array<std::array<double, 2>, 3> xi;
+                        for (auto& value: xi) {
+                            value = {normal(engine), normal(engine)};
+                        }
+
+                        const long mx = wave_number(a), my = wave_number(b), mz = wave_number(c);
+                        const std::array<double, 3> k{dk * mx, dk * my, dk * mz};
+                        const double k2 = k[0] * k[0] + k[1] * k[1] + k[2] * k[2];
+                        if (k2 == 0. || is_nyquist(mx) || is_nyquist(my) || is_nyquist(mz)) {
+                            for (auto& component: spectrum) {
+                                component[index][0] = component[index][1] = 0.;
+                            }
+                            continue;
+                        }
+
+                        const auto energy = static_cast<double>((*spectra_)(static_cast<value_type>(std::sqrt(k2))));
+                        const double amplitude = std::sqrt(energy * dk3 / (4 * std::numbers::pi * k2));
+                        for (std::size_t part = 0; part < 2; ++part) {
+                            const double k_xi = (k[0] * xi[0][part] + k[1] * xi[1][part] + k[2] * xi[2][part]) / k2;
+                            for (std::size_t component = 0; component < 3; ++component) {
+                                spectrum[component][index][part] = amplitude * (xi[component][part] - k[component] * k_xi);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // kx = 0 plane holds both k and -k, mirror one half onto the other
+            for (std::size_t c = 0; c < n_; ++c) {
+                for (std::size_t b = 0; b < n_; ++b) {
+                    const std::size_t mirror_c = (n_ - c) % n_, mirror_b = (n_ - b) % n_;
+                    if (c * n_ + b <= mirror_c * n_ + mirror_b) {
+                        continue;
+                    }
+                    const std::size_t index = spectrum_index(c, b, 0), mirror = spectrum_index(mirror_c, mirror_b, 0);
+                    for (auto& component: spectrum) {
+                        component[index][0] = component[mirror][0];
+                        component[index][1] = -component[mirror][1];
+                    }
+                }
+            }
+        }
+    };
+}// namespace stg::generators
+
+#endif//STG_FFT_SPECTRAL_GENERATOR_HPP
@@ -0,0 +1,128 @@
+#ifndef STG_FFTW_PLAN_CACHE_HPP
+#define STG_FFTW_PLAN_CACHE_HPP
+
+#include <array>
+#include <cstddef>
+#include <fftw3.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+namespace stg::generators {
+
+    struct FftwDeleter {
+        void operator()(void* pointer) const noexcept { fftw_free(pointer); }
+    };
+
+    template<typename T>
+    using fftw_unique_ptr = std::unique_ptr<T[], FftwDeleter>;
+
+    template<typename T>
+    fftw_unique_ptr<T> fftw_allocate(std::size_t size) {
+        auto* pointer = static_cast<T*>(fftw_malloc(sizeof(T) * size));
+        if (pointer == nullptr) {
+            throw std::bad_alloc{};
+        }
+        return fftw_unique_ptr<T>{pointer};
+    }
+
+    /*
+     * Process-wide cache of FFTW plans keyed by the transform shape and the number of threads.
+     * The planner is not thread safe, so planning and destroying go under one mutex. Cached plans
+     * are executed through the new-array interface (fftw_execute_dft_c2r), which is thread safe
+     * for any arrays allocated by fftw_malloc.
+     * Plans are shared: clear() drops the cache references only, a plan is destroyed when its
+     * last user releases it
+     */
+    class FftwPlanCache final {
+    public:
+        using dimensions = std::array<int, 3>;
+        using shared_plan = std::shared_ptr<std::remove_pointer_t<fftw_plan>>;
+
+        static FftwPlanCache& instance() {
+            static FftwPlanCache cache;
+            return cache;
+        }
+
+        FftwPlanCache(const FftwPlanCache&) = delete;
+        FftwPlanCache& operator=(const FftwPlanCache&) = delete;
+
+        ~FftwPlanCache() { clear(); }
+
+        /*
+         * Complex to real 3d plan, dims are given in the row-major order (slowest first),
+         * input has dims[0] * dims[1] * (dims[2] / 2 + 1) elements.
+         * The plan is measured once on scratch arrays and reused for every later call
+         */
+        shared_plan c2r_3d(const dimensions& dims, int threads = 1) {
+            const std::lock_guard lock{mutex_};
+            const key_type key{dims, threads};
+            if (const auto found = plans_.find(key); found != plans_.end()) {
+                return found->second;
+            }
+
+            const std::lock_guard planner_lock{planner_mutex()};
+            init_threads();
+            fftw_plan_with_nthreads(threads);
+            const std::size_t real_size = static_cast<std::size_t>(dims[0]) * dims[1] * dims[2];
+            const std::size_t complex_size = static_cast<std::size_t>(dims[0]) * dims[1] * (dims[2] / 2 + 1);
+            auto input = fftw_allocate<fftw_complex>(complex_size);
+            auto output = fftw_allocate<double>(real_size);
+            fftw_plan plan = fftw_plan_dft_c2r_3d(dims[0], dims[1], dims[2], input.get(), output.get(), FFTW_MEASURE);
+            if (plan == nullptr) {
+                throw std::runtime_error("FFTW failed to create complex to real plan");
+            }
+            return plans_.emplace(key, shared_plan{plan, PlanDeleter{}}).first->second;
+        }
+
+        std::size_t size() const {
+            const std::lock_guard lock{mutex_};
+            return plans_.size();
+        }
+
+        // Plans still held by generators stay valid until they are released
+        void clear() {
+            std::map<key_type, shared_plan> released;
+            {
+                const std::lock_guard lock{mutex_};
+                released.swap(plans_);
+            }
+        }
+
+    private:
+        using key_type = std::tuple<dimensions, int>;
+
+        struct PlanDeleter {
+            void operator()(fftw_plan plan) const {
+                const std::lock_guard lock{planner_mutex()};
+                fftw_destroy_plan(plan);
+            }
+        };
+
+        mutable std::mutex mutex_;
+        std::map<key_type, shared_plan> plans_;
+        bool threads_initialized_ = false;
+
+        FftwPlanCache() = default;
+
+        static std::mutex& planner_mutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        void init_threads() {
+            if (threads_initialized_) {
+                return;
+            }
+            if (fftw_init_threads() == 0) {
+                throw std::runtime_error("FFTW failed to initialize threads");
+            }
+            threads_initialized_ = true;
+        }
+    };
+}// namespace stg::generators
+
+#endif//STG_FFTW_PLAN_CACHE_HPP
@@ -0,0 +1,245 @@
+#ifndef STG_FOURIER_MODES_HPP
+#define STG_FOURIER_MODES_HPP
+
+#include "grid_axes.hpp"
+#include "simd_sincos.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <geometry/geometry.hpp>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace stg::generators {
+
+    /*
+     * Structure-of-arrays storage of Fourier modes (k_n, p_n, q_n, omega_n).
+     * Every component lives in its own contiguous array padded with zero modes
+     * up to simd::max_lanes, so the sum kernels run without a tail loop
+     */
+    template<std::floating_point T>
+    class FourierModes final {
+    public:
+        using value_type = T;
+
+        FourierModes() = default;
+
+        explicit FourierModes(std::size_t size) { resize(size); }
+
+        FourierModes(const std::vector<Vector<value_type>>& wave_vectors,
+                     const std::vector<Vector<value_type>>& p_vectors,
+                     const std::vector<Vector<value_type>>& q_vectors,
+                     const std::vector<value_type>& frequencies) {
+            if (wave_vectors.size() != p_vectors.size() ||
+                wave_vectors.size() != q_vectors.size() ||
+                wave_vectors.size() != frequencies.size()) {
+                throw std::logic_error("Modes components have different lengths");
+            }
+            resize(wave_vectors.size());
+            for (std::size_t index = 0; index < size_; ++index) {
+                set_wave_vector(index, wave_vectors[index]);
+                set_p_vector(index, p_vectors[index]);
+                set_q_vector(index, q_vectors[index]);
+                omega_[index] = frequencies[index];
+            }
+        }
+
+        void resize(std::size_t size) {
+            size_ = size;
+            const std::size_t padded = (size + simd::max_lanes - 1) / simd::max_lanes * simd::max_lanes;
+            for (auto* component: {&kx_, &ky_, &kz_, &px_, &py_, &pz_, &qx_, &qy_, &qz_, &omega_}) {
+                component->assign(padded, value_type{0});
+            }
+        }
+
+        std::size_t size() const noexcept { return size_; }
+
+        bool empty() const noexcept { return size_ == 0; }
+
+        Vector<value_type> wave_vector(std::size_t index) const {
+            assert(index < size_);
+            return {kx_[index], ky_[index], kz_[index]};
+        }
+
+        Vector<value_type> p_vector(std::size_t index) const {
+            assert(index < size_);
+            return {px_[index], py_[index], pz_[index]};
+        }
+
+        Vector<value_type> q_vector(std::size_t index) const {
+            assert(index < size_);
+            return {qx_[index], qy_[index], qz_[index]};
+        }
+
+        void set_wave_vector(std::size_t index, const Vector<value_type>& k) {
+            assert(index < size_);
+            kx_[index] = k.template get<0>();
+            ky_[index] = k.template get<1>();
+            kz_[index] = k.template get<2>();
+        }
+
+        void set_p_vector(std::size_t index, const Vector<value_type>& p) {
+            assert(index < size_);
+            px_[index] = p.template get<0>();
+            py_[index] = p.template get<1>();
+            pz_[index] = p.template get<2>();
+        }
+
+        void set_q_vector(std::size_t index, const Vector<value_type>& q) {
+            assert(index < size_);
+            qx_[index] = q.template get<0>();
+            qy_[index] = q.template get<1>();
+            qz_[index] = q.template get<2>();
+        }
+
+        std::span<value_type> frequencies() noexcept { return {omega_.data(), size_}; }
+
+        std::span<const value_type> frequencies() const noexcept { return {omega_.data(), size_}; }
+
+        simd::ModeArrays<value_type> arrays() const noexcept {
+            return {kx_.data(), ky_.data(), kz_.data(),
+                    px_.data(), py_.data(), pz_.data(),
+                    qx_.data(), qy_.data(), qz_.data(),
+                    omega_.data(), omega_.size()};
+        }
+
+        /*
+         * sum_n p_n cos(k_n * x + omega_n t) + q_n sin(k_n * x + omega_n t)
+         * with the widest kernel available on the running cpu
+         */
+        Vector<value_type> sum(const Point<value_type>& point, value_type time,
+                               simd::SinCosKernel kernel = simd::best_sincos_kernel()) const noexcept {
+            const auto [ux, uy, uz] = simd::fourier_sum(arrays(),
+                                                        point.template get<0>(), point.template get<1>(), point.template get<2>(),
+                                                        time, kernel);
+            return {static_cast<value_type>(ux), static_cast<value_type>(uy), static_cast<value_type>(uz)};
+        }
+
+        /*
+         * Batched sum for many points, out[i] = sum(points[i], time).
+         * Points are processed in tiles, and every tile runs over the modes tile by tile,
+         * so the mode arrays are read from cache instead of memory for each point
+         */
+        void sum(std::span<const Point<value_type>> points, value_type time, std::span<Vector<value_type>> out,
+                 simd::SinCosKernel kernel = simd::best_sincos_kernel()) const {
+            if (points.size() != out.size()) {
+                throw std::invalid_argument("Points and output spans have different lengths");
+            }
+
+            std::array<std::array<double, 3>, simd::points_tile> accumulator;
+            for (std::size_t tile_begin = 0; tile_begin < points.size(); tile_begin += simd::points_tile) {
+                const auto tile = points.subspan(tile_begin, std::min(simd::points_tile, points.size() - tile_begin));
+                std::ranges::fill(accumulator, std::array<double, 3>{0., 0., 0.});
+                accumulate(tile, time, std::span{accumulator}.first(tile.size()), 1., kernel);
+                for (std::size_t index = 0; index < tile.size(); ++index) {
+                    const auto [ux, uy, uz] = accumulator[index];
+                    out[tile_begin + index] = {static_cast<value_type>(ux), static_cast<value_type>(uy), static_cast<value_type>(uz)};
+                }
+            }
+        }
+
+        /*
+         * accumulator[i] += weight * sum(points[i], time), tiled over modes.
+         * Building block for generators which sum several mode sets per point
+         */
+        void accumulate(std::span<const Point<value_type>> points, value_type time,
+                        std::span<std::array<double, 3>> accumulator, double weight,
+                        simd::SinCosKernel kernel = simd::best_sincos_kernel()) const noexcept {
+            assert(points.size() == accumulator.size());
+            const auto all_modes = arrays();
+            for (std::size_t modes_begin = 0; modes_begin < all_modes.n; modes_begin += simd::modes_tile) {
+                const auto block = simd::mode_block(all_modes, modes_begin, std::min(simd::modes_tile, all_modes.n - modes_begin));
+                for (std::size_t index = 0; index < points.size(); ++index) {
+                    const auto& point = points[index];
+                    const auto [ux, uy, uz] = simd::fourier_sum(block,
+                                                                point.template get<0>(), point.template get<1>(), point.template get<2>(),
+                                                                time, kernel);
+                    accumulator[index][0] += weight * ux;
+                    accumulator[index][1] += weight * uy;
+                    accumulator[index][2] += weight * uz;
+                }
+            }
+        }
+
+        /*
+         * Grid fast path, u[lin_index(i, j, k - k_begin)] += weight * sum({x_i, y_j, z_k}, time)
+         * for the layers k_begin <= k < k_end.
+         * The phase separates along axes, so exp(i (k * x + omega t)) is built from per-axis
+         * tables exp(i (kx x_i + omega t)), exp(i ky y_j), exp(i kz z_k) with two complex products:
+         * (nx + ny + nz) sincos per mode instead of nx * ny * nz.
+         * Modes go by blocks, the per-axis tables of a block stay in cache over all rows
+         */
+        void accumulate_on_grid(const GridAxes<value_type>& axes, std::size_t k_begin, std::size_t k_end, value_type time,
+                                std::span<double> ux, std::span<double> uy, std::span<double> uz, double weight,
+                                simd::SinCosKernel kernel = simd::best_sincos_kernel()) const {
+            const std::size_t nx = axes.x.size(), ny = axes.y.size(), nz = k_end - k_begin;
+            if (k_end > axes.z.size() || k_begin > k_end) {
+                throw std::out_of_range("Grid layers are out of the z axis");
+            }
+            if (ux.size() != nx * ny * nz || uy.size() != ux.size() || uz.size() != ux.size()) {
+                throw std::invalid_argument("Accumulators size is not equal to the number of grid vertices");
+            }
+
+            constexpr std::size_t modes_block = 32;
+            std::vector<double> ex_cos(modes_block * nx), ex_sin(modes_block * nx);
+            std::vector<double> ey_cos(modes_block * ny), ey_sin(modes_block * ny);
+            std::vector<double> ez_cos(modes_block * nz), ez_sin(modes_block * nz);
+            std::array<double, modes_block> yz_cos, yz_sin;
+            std::array<std::array<double, modes_block>, 3> p, q;
+            const auto fill_table = [](const std::vector<value_type>& k, std::size_t mode, std::span<const value_type> axis,
+                                       double shift, double* cos_table, double* sin_table) {
+                for (std::size_t index = 0; index < axis.size(); ++index) {
+                    simd::sincos(static_cast<double>(k[mode]) * axis[index] + shift, sin_table[index], cos_table[index]);
+                }
+            };
+
+            for (std::size_t block_begin = 0; block_begin < size_; block_begin += modes_block) {
+                const std::size_t block_size = std::min(modes_block, size_ - block_begin);
+                for (std::size_t m = 0; m < block_size; ++m) {
+                    const std::size_t mode = block_begin + m;
+                    fill_table(kx_, mode, axes.x, static_cast<double>(omega_[mode]) * time, &ex_cos[m * nx], &ex_sin[m * nx]);
+                    fill_table(ky_, mode, axes.y, 0., &ey_cos[m * ny], &ey_sin[m * ny]);
+                    fill_table(kz_, mode, axes.z.subspan(k_begin, nz), 0., &ez_cos[m * nz], &ez_sin[m * nz]);
+                    p[0][m] = weight * px_[mode], p[1][m] = weight * py_[mode], p[2][m] = weight * pz_[mode];
+                    q[0][m] = weight * qx_[mode], q[1][m] = weight * qy_[mode], q[2][m] = weight * qz_[mode];
+                }
+                const simd::RowRotation rotation{block_size, nx, ex_cos.data(), ex_sin.data(), yz_cos.data(), yz_sin.data(),
+                                                 {p[0].data(), p[1].data(), p[2].data()},
+                                                 {q[0].data(), q[1].data(), q[2].data()}};
+
+                for (std::size_t k = 0; k < nz; ++k) {
+                    for (std::size_t j = 0; j < ny; ++j) {
+                        // exp(i ky y_j) * exp(i kz z_k) for every mode of the block
+                        for (std::size_t m = 0; m < block_size; ++m) {
+                            yz_cos[m] = ey_cos[m * ny + j] * ez_cos[m * nz + k] - ey_sin[m * ny + j] * ez_sin[m * nz + k];
+                            yz_sin[m] = ey_cos[m * ny + j] * ez_sin[m * nz + k] + ey_sin[m * ny + j] * ez_cos[m * nz + k];
+                        }
+                        const std::size_t row = (k * ny + j) * nx;
+                        simd::rotate_accumulate_row(rotation, ux.data() + row, uy.data() + row, uz.data() + row, kernel);
+                    }
+                }
+            }
+        }
+
+        /* out[lin_index(i, j, k - k_begin)] = sum({x_i, y_j, z_k}, time) for k_begin <= k < k_end */
+        void sum_on_grid(const GridAxes<value_type>& axes, std::size_t k_begin, std::size_t k_end, value_type time,
+                         std::span<Vector<value_type>> out) const {
+            std::vector<double> ux(out.size()), uy(out.size()), uz(out.size());
+            accumulate_on_grid(axes, k_begin, k_end, time, ux, uy, uz, 1.);
+            for (std::size_t index = 0; index < out.size(); ++index) {
+                out[index] = {static_cast<value_type>(ux[index]), static_cast<value_type>(uy[index]), static_cast<value_type>(uz[index])};
+            }
+        }
+
+    private:
+        std::size_t size_ = 0;
+        std::vector<value_type> kx_, ky_, kz_;
+        std::vector<value_type> px_, py_, pz_;
+        std::vector<value_type> qx_, qy_, qz_;
+        std::vector<value_type> omega_;
+    };
+}// namespace stg::generators
+
+#endif//STG_FOURIER_MODES_HPP
@@ -0,0 +1,27 @@
+#ifndef STG_GRID_AXES_HPP
+#define STG_GRID_AXES_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+namespace stg::generators {
+
+    /*
+     * Axes of a rectilinear grid, vertex (i, j, k) is {x[i], y[j], z[k]}
+     * and its linear index is i + j * nx + k * nx * ny (as in CubeRelationTable)
+     */
+    template<std::floating_point T>
+    struct GridAxes final {
+        std::span<const T> x;
+        std::span<const T> y;
+        std::span<const T> z;
+
+        std::size_t n_vertices() const noexcept { return x.size() * y.size() * z.size(); }
+
+        /* Number of vertices in layers k_begin <= k < k_end */
+        std::size_t n_vertices(std::size_t k_begin, std::size_t k_end) const noexcept { return x.size() * y.size() * (k_end - k_begin); }
+    };
+}// namespace stg::generators
+
+#endif//STG_GRID_AXES_HPP
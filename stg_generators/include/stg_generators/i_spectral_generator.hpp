@@ -1,7 +1,11 @@
 #ifndef STG_I_SPECTRAL_GENERATOR_HPP
 #define STG_I_SPECTRAL_GENERATOR_HPP
 
+#include "grid_axes.hpp"
 #include "i_fluctuation_generator.hpp"
+#include <span>
+#include <stdexcept>
+#include <vector>
 
 namespace stg::generators {
 
@@ -10,6 +14,44 @@ namespace stg::generators {
   public:
     using typename IVelocityFluctuationGenerator<T>::value_type;
     using IVelocityFluctuationGenerator<T>::operator();
+
+    /*
+     * Batched evaluation out[i] = (*this)(points[i], time).
+     * Default implementation goes point by point, spectral generators
+     * override it to walk their modes once per block of points
+     */
+    virtual void evaluate(std::span<const Point<T>> points, T time, std::span<Vector<T>> out) const {
+      if (points.size() != out.size()) {
+        throw std::invalid_argument("Points and output spans have different lengths");
+      }
+      for (std::size_t index = 0; index < points.size(); ++index) {
+        out[index] = this->operator()(points[index], time);
+      }
+    }
+
+    /*
+     * Evaluation on the layers k_begin <= k < k_end of a rectilinear grid,
+     * out[i + j * nx + (k - k_begin) * nx * ny] = (*this)({x_i, y_j, z_k}, time).
+     * Default implementation lists the vertices and calls evaluate, spectral
+     * generators override it with per-axis phase tables
+     */
+    virtual void evaluate_on_grid(const GridAxes<T>& axes, std::size_t k_begin, std::size_t k_end, T time,
+                                  std::span<Vector<T>> out) const {
+      if (out.size() != axes.n_vertices(k_begin, k_end)) {
+        throw std::invalid_argument("Output span size is not equal to the number of grid vertices");
+      }
+      std::vector<Point<T>> points;
+      points.reserve(out.size());
+      for (std::size_t k = k_begin; k < k_end; ++k) {
+        for (const auto y: axes.y) {
+          for (const auto x: axes.x) {
+            points.emplace_back(x, y, axes.z[k]);
+          }
+        }
+      }
+      evaluate(points, time, out);
+    }
+
     virtual ~ISpectralGenerator() = default;
   };
 }
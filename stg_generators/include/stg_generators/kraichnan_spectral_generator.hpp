@@ -1,9 +1,10 @@
 #ifndef STG_GENERATORS_KRAICHNAN_SPECTRAL_GENERATOR_HPP
 #define STG_GENERATORS_KRAICHNAN_SPECTRAL_GENERATOR_HPP
 
-#include "fluctuation_fourier_sum.hpp"
+#include "fourier_modes.hpp"
 #include "geometry/geometry.hpp"
 #include "i_spectral_generator.hpp"
+#include "phasor_time_stepper.hpp"
 #include "spectras_base.hpp"
 #include "stg_coro_future/coroutine_future.hpp"
 #include "stg_random/generator_engines.hpp"
@@ -23,7 +24,9 @@
 #include <range/v3/view/generate.hpp>
 #include <range/v3/view/take.hpp>
 #include <range/v3/view/transform.hpp>
+#include <range/v3/view/zip.hpp>
 #include <ranges>
+#include <span>
 #include <stg_coro_future.hpp>
 #include <stg_rangom.hpp>
 #include <type_traits>
@@ -50,18 +53,21 @@ namespace stg::generators {
                                        std::vector<Vector<value_type>>&& w,
                                        std::vector<Vector<value_type>>&& k,
                                        std::vector<value_type>&& omega,
-                                       std::size_t seed = std::mt19937_64::default_seed) noexcept(std::is_nothrow_copy_constructible<Vector<value_type>>::value);
+                                       std::size_t seed = std::mt19937_64::default_seed);
 
         Vector<T> operator()(const Point<value_type>& space_point, value_type time_point) const override;
 
+        void evaluate(std::span<const Point<value_type>> points, value_type time_point, std::span<Vector<value_type>> out) const override;
+
+        void evaluate_on_grid(const GridAxes<value_type>& axes, std::size_t k_begin, std::size_t k_end, value_type time_point,
+                              std::span<Vector<value_type>> out) const override;
+
         ~KraichanGeneratorDeltaFunction() override = default;
 
     private:
         std::size_t n_;
         value_type k_0_, w_0_;
-        std::vector<Vector<value_type>> v_, w_;
-        std::vector<Vector<value_type>> k_;
-        std::vector<value_type> omega_;
+        FourierModes<value_type> modes_;
 
 
         static std::vector<Vector<value_type>> generate_wave_vectors(value_type k_0, std::size_t n, std::size_t seed);
@@ -95,18 +101,26 @@ namespace stg::generators {
                                   std::vector<Vector<value_type>>&& v,
                                   std::vector<Vector<value_type>>&& w,
                                   std::vector<Vector<value_type>>&& k,
-                                  std::vector<value_type>&& omega) noexcept(std::is_nothrow_move_constructible_v<Vector<value_type>>&& std::is_nothrow_move_constructible_v<std::vector<Vector<value_type>>>);
+                                  std::vector<value_type>&& omega);
 
 
         Vector<T> operator()(const Point<value_type>& space_point, value_type time_point) const override;
+
+        void evaluate(std::span<const Point<value_type>> points, value_type time_point, std::span<Vector<value_type>> out) const override;
+
+        void evaluate_on_grid(const GridAxes<value_type>& axes, std::size_t k_begin, std::size_t k_end, value_type time_point,
+                              std::span<Vector<value_type>> out) const override;
+
+        // Stepper over fixed points from time with the step time_step, see PhasorTimeStepper
+        PhasorTimeStepper<value_type> time_stepper(std::vector<Point<value_type>> points, value_type time, value_type time_step,
+                                                   std::size_t memory_budget = PhasorTimeStepper<value_type>::default_memory_budget) const;
+
         ~KraichanGeneratorGaussian() override = default;
 
     private:
         std::size_t n_;
         value_type k_0_, w_0_;
-        std::vector<Vector<value_type>> k_;
-        std::vector<Vector<value_type>> v_, w_;
-        std::vector<value_type> omega_;
+        FourierModes<value_type> modes_;
 
         static std::vector<Vector<value_type>> generate_wave_vectors(value_type k_0, std::size_t n, std::size_t seed);
         static std::vector<value_type> generate_frequencies(value_type w_0, std::size_t n, std::size_t seed);
@@ -135,7 +149,7 @@ namespace stg::generators {
     KraichanGeneratorDeltaFunction<T>::KraichanGeneratorDeltaFunction(std::size_t n, value_type k_0, value_type w_0, std::vector<Vector<value_type>> k, std::size_t seed)
         : KraichanGeneratorDeltaFunction{n, k_0, w_0,
                                          generate_ampltudes(k, n, seed),
-                                         generate_ampltudes(k, n, seed),
+                                         generate_ampltudes(k, n, seed + 1),
                                          std::move(k),
                                          generate_frequencies(w_0, n, seed),
                                          seed} {}
@@ -146,18 +160,24 @@ namespace stg::generators {
                                                                       std::vector<Vector<value_type>>&& w,
                                                                       std::vector<Vector<value_type>>&& k,
                                                                       std::vector<value_type>&& omega,
-                                                                      std::size_t seed) noexcept(std::is_nothrow_copy_constructible<Vector<value_type>>::value)
-        : n_{n}, k_0_{k_0}, w_0_{w_0}, v_{std::move(v)}, w_{std::move(w)}, k_{std::move(k)}, omega_{std::move(omega)} {}
+                                                                      std::size_t seed)
+        : n_{n}, k_0_{k_0}, w_0_{w_0}, modes_{k, v, w, omega} {}
 
 
     template<std::floating_point T>
     Vector<T> KraichanGeneratorDeltaFunction<T>::operator()(const Point<value_type>& space_point, value_type time_point) const {
-        return FluctuationFouirerSum<value_type>::calculate_sum(v_ | std::views::all,
-                                                                w_ | std::views::all,
-                                                                k_ | std::views::all,
-                                                                omega_ | std::views::all,
-                                                                space_point,
-                                                                time_point);
+        return modes_.sum(space_point, time_point);
+    }
+
+    template<std::floating_point T>
+    void KraichanGeneratorDeltaFunction<T>::evaluate(std::span<const Point<value_type>> points, value_type time_point, std::span<Vector<value_type>> out) const {
+        modes_.sum(points, time_point, out);
+    }
+
+    template<std::floating_point T>
+    void KraichanGeneratorDeltaFunction<T>::evaluate_on_grid(const GridAxes<value_type>& axes, std::size_t k_begin, std::size_t k_end, value_type time_point,
+                                 std::span<Vector<value_type>> out) const {
+        modes_.sum_on_grid(axes, k_begin, k_end, time_point, out);
     }
 
     template<std::floating_point T>
@@ -165,19 +185,17 @@ namespace stg::generators {
     std::vector<Vector<typename KraichanGeneratorDeltaFunction<T>::value_type>> KraichanGeneratorDeltaFunction<T>::generate_ampltudes(const WaveVectors& wave_vectors, std::size_t n, std::size_t seed,
                                                                                                                                       const Vector<value_type>& mean,
                                                                                                                                       const tensor::Tensor<value_type>& tensor) {
-        random::MultidimenasionalGaussianGenerator<value_type> multidim_generator{mean, tensor};
-        auto generator = [&multidim_generator](const Vector<T>& wave_vector) -> Vector<value_type> {
-            const auto generated_xi = multidim_generator();
-            return cross_product(generated_xi, wave_vector);
-        };
-        return wave_vectors |
-               ranges::views::transform(generator) |
-               ranges::to<std::vector<Vector<typename KraichanGeneratorDeltaFunction<T>::value_type>>>();
+        random::MultidimenasionalGaussianGenerator<value_type> multidim_generator{mean, tensor, seed};
+        auto amplitudes = multidim_generator(static_cast<std::size_t>(ranges::distance(wave_vectors)));
+        for (auto&& [amplitude, wave_vector]: ranges::views::zip(amplitudes, wave_vectors)) {
+            amplitude = cross_product(amplitude, wave_vector);
+        }
+        return amplitudes;
     }
 
     template<std::floating_point T>
     std::vector<Vector<typename KraichanGeneratorDeltaFunction<T>::value_type>> KraichanGeneratorDeltaFunction<T>::generate_wave_vectors(value_type k_0, std::size_t n, std::size_t seed) {
-        RNGenerator generator{generator_engines::get_engine<std::mt19937_64>(seed), std::normal_distribution<>{0, k_0}};
+        RNGenerator generator{generator_engines::get_engine<std::mt19937_64>(seed), std::normal_distribution<value_type>{0, k_0}};
         auto generate_random_vector = [&generator, k_0]() {
             auto x = generator();
             auto y = generator();
@@ -192,8 +210,8 @@ namespace stg::generators {
 
     template<std::floating_point T>
     std::vector<typename KraichanGeneratorDeltaFunction<T>::value_type> KraichanGeneratorDeltaFunction<T>::generate_frequencies(value_type w_0, std::size_t n, std::size_t seed) {
-        RNGenerator<std::mt19937_64, std::normal_distribution<>> gen{generator_engines::get_engine<std::mt19937_64>(seed),
-                                                                     std::normal_distribution<value_type>{0, w_0}};
+        RNGenerator<std::mt19937_64, std::normal_distribution<value_type>> gen{generator_engines::get_engine<std::mt19937_64>(seed),
+                                                                               std::normal_distribution<value_type>{0, w_0}};
         return ranges::views::generate([&gen] {
                    return gen();
                }) |
@@ -214,15 +232,37 @@ namespace stg::generators {
     KraichanGeneratorGaussian<T>::KraichanGeneratorGaussian(std::size_t n, value_type k_0, value_type w_0, std::vector<Vector<value_type>> k,
                                                             std::size_t seed) noexcept(std::is_nothrow_move_constructible_v<Vector<value_type>>&&
                                                                                                std::is_nothrow_move_constructible_v<std::vector<Vector<value_type>>>)
-        : KraichanGeneratorGaussian{n, k_0, w_0, generate_ampltudes(k, n, seed), generate_ampltudes(k, n, seed), std::move(k), generate_frequencies(w_0, n, seed)} {}
+        : KraichanGeneratorGaussian{n, k_0, w_0, generate_ampltudes(k, n, seed), generate_ampltudes(k, n, seed + 1), std::move(k), generate_frequencies(w_0, n, seed)} {}
 
     template<std::floating_point T>
     KraichanGeneratorGaussian<T>::KraichanGeneratorGaussian(std::size_t n, value_type k_0, value_type w_0,
                                                             std::vector<Vector<value_type>>&& v,
                                                             std::vector<Vector<value_type>>&& w,
                                                             std::vector<Vector<value_type>>&& k,
-                                                            std::vector<value_type>&& omega) noexcept(std::is_nothrow_move_constructible_v<Vector<value_type>>&& std::is_nothrow_move_constructible_v<std::vector<Vector<value_type>>>)
-        : n_{n}, k_0_{k_0}, w_0_{w_0}, v_{std::move(v)}, w_{std::move(w)}, k_{std::move(k)}, omega_{std::move(omega)} {}
+                                                            std::vector<value_type>&& omega)
+        : n_{n}, k_0_{k_0}, w_0_{w_0}, modes_{k, v, w, omega} {}
+
+    template<std::floating_point T>
+    Vector<T> KraichanGeneratorGaussian<T>::operator()(const Point<value_type>& space_point, value_type time_point) const {
+        return modes_.sum(space_point, time_point);
+    }
+
+    template<std::floating_point T>
+    void KraichanGeneratorGaussian<T>::evaluate(std::span<const Point<value_type>> points, value_type time_point, std::span<Vector<value_type>> out) const {
+        modes_.sum(points, time_point, out);
+    }
+
+    template<std::floating_point T>
+    void KraichanGeneratorGaussian<T>::evaluate_on_grid(const GridAxes<value_type>& axes, std::size_t k_begin, std::size_t k_end, value_type time_point,
+                                 std::span<Vector<value_type>> out) const {
+        modes_.sum_on_grid(axes, k_begin, k_end, time_point, out);
+    }
+
+    template<std::floating_point T>
+    PhasorTimeStepper<T> KraichanGeneratorGaussian<T>::time_stepper(std::vector<Point<value_type>> points, value_type time, value_type time_step,
+                                                                    std::size_t memory_budget) const {
+        return {modes_, std::move(points), time, time_step, memory_budget};
+    }
 
     template<std::floating_point T>
     template<std::ranges::viewable_range WaveVectors>
@@ -230,17 +270,17 @@ namespace stg::generators {
                                                                             const Vector<value_type>& mean,
                                                                             const tensor::Tensor<value_type>& tensor) {
 
-        random::MultidimenasionalGaussianGenerator<value_type> multidim_generator{mean, tensor};
-        auto generate = [&multidim_generator](const Vector<T>& wave_vector) {
-            const auto generated_xi = multidim_generator.template operator()();
-            return cross_product(generated_xi, wave_vector);
-        };
-        return ranges::views::transform(generate) | ranges::to<std::vector<Vector<value_type>>>();
+        random::MultidimenasionalGaussianGenerator<value_type> multidim_generator{mean, tensor, seed};
+        auto amplitudes = multidim_generator(static_cast<std::size_t>(ranges::distance(wave_vectors)));
+        for (auto&& [amplitude, wave_vector]: ranges::views::zip(amplitudes, wave_vectors)) {
+            amplitude = cross_product(amplitude, wave_vector);
+        }
+        return amplitudes;
     }
 
     template<std::floating_point T>
     std::vector<Vector<typename KraichanGeneratorGaussian<T>::value_type>> KraichanGeneratorGaussian<T>::generate_wave_vectors(value_type k_0, std::size_t n, std::size_t seed) {
-        RNGenerator generator{generator_engines::get_engine<std::mt19937_64>(seed), std::normal_distribution<>{0, k_0}};
+        RNGenerator generator{generator_engines::get_engine<std::mt19937_64>(seed), std::normal_distribution<value_type>{0, k_0}};
         auto generate_random_vector = [&generator, k_0]() {
             auto x = generator();
             auto y = generator();
@@ -250,13 +290,13 @@ namespace stg::generators {
         };
 
         return ranges::views::generate(generate_random_vector) |
-               ranges::views::take(n) | ranges::to<std::vector<value_type>>();
+               ranges::views::take(n) | ranges::to<std::vector<Vector<value_type>>>();
     }
 
     template<std::floating_point T>
     std::vector<typename KraichanGeneratorGaussian<T>::value_type> KraichanGeneratorGaussian<T>::generate_frequencies(value_type w_0, std::size_t n, std::size_t seed) {
-        RNGenerator<std::mt19937_64, std::normal_distribution<>> gen{generator_engines::get_engine<std::mt19937_64>(seed),
-                                                                     std::normal_distribution<value_type>{0, w_0}};
+        RNGenerator<std::mt19937_64, std::normal_distribution<value_type>> gen{generator_engines::get_engine<std::mt19937_64>(seed),
+                                                                               std::normal_distribution<value_type>{0, w_0}};
         return ranges::views::generate([&gen] {
                    return gen();
                }) |
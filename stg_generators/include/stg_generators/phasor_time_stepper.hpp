@@ -0,0 +1,146 @@
+#ifndef STG_PHASOR_TIME_STEPPER_HPP
+#define STG_PHASOR_TIME_STEPPER_HPP
+
+#include "fourier_modes.hpp"
+#include "simd_sincos.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <geometry/geometry.hpp>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace stg::generators {
+
+    /*
+     * Time marching of the mode sum on a fixed set of points.
+     * The phasor exp(i (k_n * x_i + omega_n t)) is the product of the spatial phasor
+     * exp(i k_n * x_i), computed once, and the time phasor exp(i omega_n t), which is
+     * advanced by one complex multiply with exp(i omega_n dt) per mode and step.
+     * A step is then the complex product and the weighted sum of
+     * simd::rotate_accumulate_row, no sincos per (point, mode).
+     * Spatial phasors take 16 bytes per (point, mode); points which do not fit into
+     * the memory budget are evaluated directly by FourierModes::sum every step.
+     * Rotations accumulate rounding in the time phasors, both in the modulus and the
+     * phase, so every renormalization_period steps they are recomputed exactly
+     * (one sincos per mode)
+     */
+    template<std::floating_point T>
+    class PhasorTimeStepper final {
+    public:
+        using value_type = T;
+
+        static constexpr std::size_t default_memory_budget = std::size_t{1} << 30;
+        static constexpr std::size_t default_renormalization_period = 256;
+
+        /*
+         * modes are the scaled modes of a generator, u(x, t) = modes.sum(x, t)
+         */
+        PhasorTimeStepper(FourierModes<value_type> modes, std::vector<Point<value_type>> points,
+                          value_type time, value_type time_step,
+                          std::size_t memory_budget = default_memory_budget,
+                          std::size_t renormalization_period = default_renormalization_period)
+            : modes_{std::move(modes)}, points_{std::move(points)}, start_time_{time}, time_step_{time_step},
+              renormalization_period_{std::max(renormalization_period, std::size_t{1})} {
+            const auto arrays = modes_.arrays();
+            const std::size_t modes_n = arrays.n;
+            const std::size_t phasor_bytes = 2 * sizeof(double) * std::max(modes_n, std::size_t{1});
+            cached_points_ = std::min(points_.size(), memory_budget / phasor_bytes);
+
+            for (auto* component: {&rotation_cos_, &rotation_sin_, &time_cos_, &time_sin_,
+                                   &px_, &py_, &pz_, &qx_, &qy_, &qz_}) {
+                component->resize(modes_n);
+            }
+            for (std::size_t m = 0; m < modes_n; ++m) {
+                simd::sincos(static_cast<double>(arrays.omega[m]) * time_step_, rotation_sin_[m], rotation_cos_[m]);
+                px_[m] = arrays.px[m], py_[m] = arrays.py[m], pz_[m] = arrays.pz[m];
+                qx_[m] = arrays.qx[m], qy_[m] = arrays.qy[m], qz_[m] = arrays.qz[m];
+            }
+
+            // mode major, spatial_cos_[m * cached_points + i], as the x tables of the grid path
+            spatial_cos_.resize(modes_n * cached_points_);
+            spatial_sin_.resize(modes_n * cached_points_);
+            for (std::size_t m = 0; m < modes_n; ++m) {
+                for (std::size_t i = 0; i < cached_points_; ++i) {
+                    const auto& point = points_[i];
+                    const double phase = static_cast<double>(arrays.kx[m]) * point.template get<0>() +
+                                         static_cast<double>(arrays.ky[m]) * point.template get<1>() +
+                                         static_cast<double>(arrays.kz[m]) * point.template get<2>();
+                    simd::sincos(phase, spatial_sin_[m * cached_points_ + i], spatial_cos_[m * cached_points_ + i]);
+                }
+            }
+            ux_.resize(cached_points_);
+            uy_.resize(cached_points_);
+            uz_.resize(cached_points_);
+            renormalize();
+        }
+
+        value_type time() const noexcept { return start_time_ + static_cast<value_type>(step_) * time_step_; }
+
+        std::size_t steps() const noexcept { return step_; }
+
+        std::size_t size() const noexcept { return points_.size(); }
+
+        // Number of points advanced by rotations, the rest is evaluated directly
+        std::size_t cached_points() const noexcept { return cached_points_; }
+
+        /*
+         * out[i] = u(points[i], time()), then the time moves by one step
+         */
+        void step(std::span<Vector<value_type>> out, simd::SinCosKernel kernel = simd::best_sincos_kernel()) {
+            if (out.size() != points_.size()) {
+                throw std::invalid_argument("Output span size is not equal to the number of points");
+            }
+
+            std::ranges::fill(ux_, 0.);
+            std::ranges::fill(uy_, 0.);
+            std::ranges::fill(uz_, 0.);
+            const simd::RowRotation rotation{time_cos_.size(), cached_points_,
+                                             spatial_cos_.data(), spatial_sin_.data(), time_cos_.data(), time_sin_.data(),
+                                             {px_.data(), py_.data(), pz_.data()},
+                                             {qx_.data(), qy_.data(), qz_.data()}};
+            simd::rotate_accumulate_row(rotation, ux_.data(), uy_.data(), uz_.data(), kernel);
+            for (std::size_t i = 0; i < cached_points_; ++i) {
+                out[i] = {static_cast<value_type>(ux_[i]), static_cast<value_type>(uy_[i]), static_cast<value_type>(uz_[i])};
+            }
+            modes_.sum(std::span<const Point<value_type>>{points_}.subspan(cached_points_), time(),
+                       out.subspan(cached_points_), kernel);
+
+            ++step_;
+            if (step_ % renormalization_period_ == 0) {
+                renormalize();
+                return;
+            }
+            for (std::size_t m = 0; m < time_cos_.size(); ++m) {
+                const double c = time_cos_[m], s = time_sin_[m];
+                time_cos_[m] = c * rotation_cos_[m] - s * rotation_sin_[m];
+                time_sin_[m] = c * rotation_sin_[m] + s * rotation_cos_[m];
+            }
+        }
+
+        // Exact time phasors of the current time
+        void renormalize() {
+            const auto arrays = modes_.arrays();
+            const double t = time();
+            for (std::size_t m = 0; m < time_cos_.size(); ++m) {
+                simd::sincos(static_cast<double>(arrays.omega[m]) * t, time_sin_[m], time_cos_[m]);
+            }
+        }
+
+    private:
+        FourierModes<value_type> modes_;
+        std::vector<Point<value_type>> points_;
+        value_type start_time_, time_step_;
+        std::size_t renormalization_period_;
+        std::size_t cached_points_ = 0;
+        std::size_t step_ = 0;
+        std::vector<double> rotation_cos_, rotation_sin_;
+        std::vector<double> time_cos_, time_sin_;
+        std::vector<double> px_, py_, pz_, qx_, qy_, qz_;
+        std::vector<double> spatial_cos_, spatial_sin_;
+        std::vector<double> ux_, uy_, uz_;
+    };
+}// namespace stg::generators
+
+#endif//STG_PHASOR_TIME_STEPPER_HPP
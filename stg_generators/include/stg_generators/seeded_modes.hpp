@@ -0,0 +1,86 @@
+#ifndef STG_SEEDED_MODES_HPP
+#define STG_SEEDED_MODES_HPP
+
+#include "fourier_modes.hpp"
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <geometry/geometry.hpp>
+#include <random>
+
+namespace stg::generators {
+
+    /*
+     * Distributions of a seeded spectral generator. Every spectrum and every fourier
+     * mode draws from its own stream of the engine, see mode_stream_id
+     */
+    template<std::floating_point T>
+    struct ModeDistributions final {
+        std::uint64_t seed;
+        T ampl_mean, ampl_std;
+        T wv_mean, wv_std;
+        T freq_mean, freq_std;
+    };
+
+    // Stream 0 of the spectrum gives its random coefficient, stream m + 1 the mode m
+    inline std::uint64_t mode_stream_id(std::size_t fourier_modes_n, std::size_t spectrum_index, std::size_t mode_stream) noexcept {
+        return static_cast<std::uint64_t>(spectrum_index) * (fourier_modes_n + 1) + mode_stream;
+    }
+
+    /*
+     * Engines of the seeded generators are counter based, Engine{seed, stream}
+     * is the start of an independent stream
+     */
+    template<typename Engine>
+    concept StreamEngine = std::uniform_random_bit_generator<Engine> &&
+                           std::constructible_from<Engine, std::uint64_t, std::uint64_t>;
+
+    template<StreamEngine Engine, std::floating_point T>
+    T seeded_random_coefficient(const ModeDistributions<T>& distributions,
+                                std::size_t fourier_modes_n, std::size_t spectrum_index) {
+        Engine engine{distributions.seed, mode_stream_id(fourier_modes_n, spectrum_index, 0)};
+        return std::uniform_real_distribution<T>{0., 1.}(engine);
+    }
+
+    /*
+     * Modes [first, first + fourier_modes_n) of the spectrum spectrum_index with the energy
+     * E(k_module). Mode m draws frequency, wave vector, xi and zeta from the stream
+     * mode_stream_id(fourier_modes_n, spectrum_index, m + 1)
+     */
+    template<StreamEngine Engine, std::floating_point T>
+    void draw_seeded_modes(FourierModes<T>& modes, std::size_t first,
+                           const ModeDistributions<T>& distributions,
+                           std::size_t fourier_modes_n, std::size_t spectrum_index,
+                           T random_coeff, T energy, T k_module,
+                           T scale_coeff, std::array<T, 3> diagonal) {
+        const auto p_amplitude = std::sqrt(random_coeff * energy * 4 / fourier_modes_n);
+        const auto q_amplitude = std::sqrt((1 - random_coeff) * energy * 4 / fourier_modes_n);
+        for (std::size_t index = 0; index < fourier_modes_n; ++index) {
+            Engine engine{distributions.seed, mode_stream_id(fourier_modes_n, spectrum_index, index + 1)};
+            std::normal_distribution<T> frequency{distributions.freq_mean, distributions.freq_std};
+            std::normal_distribution<T> wave_vector{distributions.wv_mean, distributions.wv_std};
+            std::normal_distribution<T> amplitude{distributions.ampl_mean, distributions.ampl_std};
+            const auto random_vector = [&engine](auto& distribution) {
+                const T x = distribution(engine);
+                const T y = distribution(engine);
+                const T z = distribution(engine);
+                return Vector<T>{x, y, z};
+            };
+
+            modes.frequencies()[first + index] = frequency(engine);
+            const auto generated = scale_to_length(random_vector(wave_vector), k_module);
+            const Vector<T> k{generated.template get<0>() * scale_coeff / diagonal[0],
+                              generated.template get<1>() * scale_coeff / diagonal[1],
+                              generated.template get<2>() * scale_coeff / diagonal[2]};
+            modes.set_wave_vector(first + index, k);
+            const auto xi = random_vector(amplitude);
+            const auto zeta = random_vector(amplitude);
+            modes.set_p_vector(first + index, scale_to_length(cross_product(xi, k), p_amplitude));
+            modes.set_q_vector(first + index, scale_to_length(cross_product(zeta, k), q_amplitude));
+        }
+    }
+}// namespace stg::generators
+
+#endif//STG_SEEDED_MODES_HPP
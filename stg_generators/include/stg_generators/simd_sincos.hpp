@@ -0,0 +1,560 @@
+#ifndef STG_SIMD_SINCOS_HPP
+#define STG_SIMD_SINCOS_HPP
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define STG_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace stg::generators::simd {
+
+    /*
+     * Vectorized evaluation of the Fourier mode sum
+     *     u(x, t) = sum_n p_n cos(k_n * x + omega_n t) + q_n sin(k_n * x + omega_n t)
+     * over structure-of-arrays mode storage.
+     *
+     * sin and cos of the phase are computed together by one polynomial kernel
+     * (Cody-Waite reduction by pi/2 in three parts, fdlibm minimax polynomials
+     * on [-pi/4, pi/4]), the same in the scalar fallback and in the AVX2/AVX-512
+     * paths, so every path differs only by FMA contraction and summation order.
+     *
+     * Accuracy: for |phase| < 2^20 * pi / 2 each sin/cos term is within 2 ULP of
+     * std::sin/std::cos. The whole sum is within 4 * n * eps * sum(|p_n| + |q_n|)
+     * of the sequential std::sin/std::cos loop (lanes are accumulated separately
+     * and reduced at the end).
+     *
+     * Float modes take the mixed precision AVX2/AVX-512 kernels (float phases and
+     * terms on twice the lanes, double accumulation), the scalar fallback stays in double.
+     */
+
+    /* Lanes of the widest kernel; mode arrays are padded with zero modes to a multiple of it */
+    inline constexpr std::size_t max_lanes = 8;
+
+    enum class SinCosKernel {
+        scalar,
+        avx2,
+        avx512
+    };
+
+    /* Pointers to padded contiguous mode arrays, n is a multiple of max_lanes */
+    template<std::floating_point T>
+    struct ModeArrays final {
+        const T* kx;
+        const T* ky;
+        const T* kz;
+        const T* px;
+        const T* py;
+        const T* pz;
+        const T* qx;
+        const T* qy;
+        const T* qz;
+        const T* omega;
+        std::size_t n;
+    };
+
+    /*
+     * Tile sizes of the batched evaluation: 256 modes * 10 arrays of doubles is 20 KiB,
+     * so a tile of modes stays in L1 while a tile of points walks over it
+     */
+    inline constexpr std::size_t modes_tile = 256;
+    inline constexpr std::size_t points_tile = 64;
+
+    /* Subrange [begin, begin + count) of padded mode arrays, begin and count are multiples of max_lanes */
+    template<std::floating_point T>
+    ModeArrays<T> mode_block(const ModeArrays<T>& modes, std::size_t begin, std::size_t count) noexcept {
+        return {modes.kx + begin, modes.ky + begin, modes.kz + begin,
+                modes.px + begin, modes.py + begin, modes.pz + begin,
+                modes.qx + begin, modes.qy + begin, modes.qz + begin,
+                modes.omega + begin, count};
+    }
+
+    namespace detail {
+        inline constexpr double two_over_pi = 6.36619772367581382433e-01;
+        inline constexpr double pio2_1 = 1.57079632673412561417e+00;
+        inline constexpr double pio2_2 = 6.07710050630396597660e-11;
+        inline constexpr double pio2_3 = 2.02226624879595063154e-21;
+
+        inline constexpr double s1 = -1.66666666666666324348e-01;
+        inline constexpr double s2 = 8.33333333332248946124e-03;
+        inline constexpr double s3 = -1.98412698298579493134e-04;
+        inline constexpr double s4 = 2.75573137070700676789e-06;
+        inline constexpr double s5 = -2.50507602534068634195e-08;
+        inline constexpr double s6 = 1.58969099521155010221e-10;
+
+        inline constexpr double c1 = 4.16666666666666019037e-02;
+        inline constexpr double c2 = -1.38888888888741095749e-03;
+        inline constexpr double c3 = 2.48015872894767294178e-05;
+        inline constexpr double c4 = -2.75573143513906633035e-07;
+        inline constexpr double c5 = 2.08757232129817482790e-09;
+        inline constexpr double c6 = -1.13596475577881948265e-11;
+
+        // Single precision kernel: pi / 2 in three floats and cephes sinf / cosf polynomials
+        inline constexpr float two_over_pi_f = 0.636619772367581343f;
+        inline constexpr float pio2_1f = 1.5703125f;
+        inline constexpr float pio2_2f = 4.837512969970703125e-4f;
+        inline constexpr float pio2_3f = 7.54978995489188216e-8f;
+
+        inline constexpr float s1f = -1.6666654611e-1f;
+        inline constexpr float s2f = 8.3321608736e-3f;
+        inline constexpr float s3f = -1.9515295891e-4f;
+
+        inline constexpr float c1f = 4.166664568298827e-2f;
+        inline constexpr float c2f = -1.388731625493765e-3f;
+        inline constexpr float c3f = 2.443315711809948e-5f;
+    }// namespace detail
+
+    inline void sincos(double x, double& sin_value, double& cos_value) noexcept {
+        using namespace detail;
+        const double q = std::nearbyint(x * two_over_pi);
+        const auto quadrant = static_cast<std::int64_t>(q);
+        const double r = ((x - q * pio2_1) - q * pio2_2) - q * pio2_3;
+        const double z = r * r;
+
+        const double s = r + r * z * (s1 + z * (s2 + z * (s3 + z * (s4 + z * (s5 + z * s6)))));
+        const double c = 1. - 0.5 * z + z * z * (c1 + z * (c2 + z * (c3 + z * (c4 + z * (c5 + z * c6)))));
+
+        const bool swap = quadrant & 1;
+        const bool sin_negative = quadrant & 2;
+        const bool cos_negative = (quadrant + 1) & 2;
+        sin_value = swap ? c : s;
+        cos_value = swap ? s : c;
+        if (sin_negative) sin_value = -sin_value;
+        if (cos_negative) cos_value = -cos_value;
+    }
+
+    /* Phases are reduced in double for any T, the reference for the mixed precision float kernels */
+    template<std::floating_point T>
+    std::array<double, 3> fourier_sum_scalar(const ModeArrays<T>& modes, double x, double y, double z, double t) noexcept {
+        double ux = 0., uy = 0., uz = 0.;
+        for (std::size_t n = 0; n < modes.n; ++n) {
+            const double phase = modes.kx[n] * x + modes.ky[n] * y + modes.kz[n] * z + modes.omega[n] * t;
+            double s, c;
+            sincos(phase, s, c);
+            ux += modes.px[n] * c + modes.qx[n] * s;
+            uy += modes.py[n] * c + modes.qy[n] * s;
+            uz += modes.pz[n] * c + modes.qz[n] * s;
+        }
+        return {ux, uy, uz};
+    }
+
+    /*
+     * Row kernel of the separable grid evaluation: for every mode m of a block
+     *     e_i = exp(i (kx x_i + omega t)) * exp(i (ky y + kz z)),
+     *     u_i += p_m Re(e_i) + q_m Im(e_i)
+     * over a row of nx vertices, x tables are stored mode by mode with nx values each
+     */
+    struct RowRotation final {
+        std::size_t modes_n, nx;
+        const double* x_cos;
+        const double* x_sin;
+        const double* yz_cos;
+        const double* yz_sin;
+        const double* p[3];
+        const double* q[3];
+    };
+
+    inline void rotate_accumulate_row_scalar(const RowRotation& row, std::size_t i_begin, double* ux, double* uy, double* uz) noexcept {
+        for (std::size_t m = 0; m < row.modes_n; ++m) {
+            const double* const x_cos = row.x_cos + m * row.nx;
+            const double* const x_sin = row.x_sin + m * row.nx;
+            for (std::size_t i = i_begin; i < row.nx; ++i) {
+                const double c = x_cos[i] * row.yz_cos[m] - x_sin[i] * row.yz_sin[m];
+                const double s = x_cos[i] * row.yz_sin[m] + x_sin[i] * row.yz_cos[m];
+                ux[i] += row.p[0][m] * c + row.q[0][m] * s;
+                uy[i] += row.p[1][m] * c + row.q[1][m] * s;
+                uz[i] += row.p[2][m] * c + row.q[2][m] * s;
+            }
+        }
+    }
+
+#ifdef STG_SIMD_X86
+    __attribute__((target("avx2,fma"))) inline void sincos_avx2(__m256d x, __m256d& sin_value, __m256d& cos_value) noexcept {
+        using namespace detail;
+        const __m256d q = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(two_over_pi)),
+                                          _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256d r = _mm256_fnmadd_pd(q, _mm256_set1_pd(pio2_1), x);
+        r = _mm256_fnmadd_pd(q, _mm256_set1_pd(pio2_2), r);
+        r = _mm256_fnmadd_pd(q, _mm256_set1_pd(pio2_3), r);
+        const __m256d z = _mm256_mul_pd(r, r);
+
+        __m256d ps = _mm256_fmadd_pd(z, _mm256_set1_pd(s6), _mm256_set1_pd(s5));
+        ps = _mm256_fmadd_pd(z, ps, _mm256_set1_pd(s4));
+        ps = _mm256_fmadd_pd(z, ps, _mm256_set1_pd(s3));
+        ps = _mm256_fmadd_pd(z, ps, _mm256_set1_pd(s2));
+        ps = _mm256_fmadd_pd(z, ps, _mm256_set1_pd(s1));
+        const __m256d s = _mm256_fmadd_pd(_mm256_mul_pd(r, z), ps, r);
+
+        __m256d pc = _mm256_fmadd_pd(z, _mm256_set1_pd(c6), _mm256_set1_pd(c5));
+        pc = _mm256_fmadd_pd(z, pc, _mm256_set1_pd(c4));
+        pc = _mm256_fmadd_pd(z, pc, _mm256_set1_pd(c3));
+        pc = _mm256_fmadd_pd(z, pc, _mm256_set1_pd(c2));
+        pc = _mm256_fmadd_pd(z, pc, _mm256_set1_pd(c1));
+        const __m256d c = _mm256_fmadd_pd(_mm256_mul_pd(z, z), pc,
+                                          _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, _mm256_set1_pd(1.)));
+
+        const __m256i quadrant = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(q));
+        const __m256i one = _mm256_set1_epi64x(1);
+        const __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(quadrant, one), one));
+        const __m256d sin_sign = _mm256_castsi256_pd(_mm256_slli_epi64(quadrant, 62));
+        const __m256d cos_sign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(quadrant, one), 62));
+        const __m256d sign_bit = _mm256_set1_pd(-0.);
+
+        sin_value = _mm256_xor_pd(_mm256_blendv_pd(s, c, swap), _mm256_and_pd(sin_sign, sign_bit));
+        cos_value = _mm256_xor_pd(_mm256_blendv_pd(c, s, swap), _mm256_and_pd(cos_sign, sign_bit));
+    }
+
+    __attribute__((target("avx2,fma"))) inline std::array<double, 3> fourier_sum_avx2(const ModeArrays<double>& modes, double x, double y, double z, double t) noexcept {
+        const __m256d vx = _mm256_set1_pd(x);
+        const __m256d vy = _mm256_set1_pd(y);
+        const __m256d vz = _mm256_set1_pd(z);
+        const __m256d vt = _mm256_set1_pd(t);
+        __m256d ux = _mm256_setzero_pd(), uy = _mm256_setzero_pd(), uz = _mm256_setzero_pd();
+
+        for (std::size_t n = 0; n < modes.n; n += 4) {
+            __m256d phase = _mm256_mul_pd(_mm256_loadu_pd(modes.omega + n), vt);
+            phase = _mm256_fmadd_pd(_mm256_loadu_pd(modes.kx + n), vx, phase);
+            phase = _mm256_fmadd_pd(_mm256_loadu_pd(modes.ky + n), vy, phase);
+            phase = _mm256_fmadd_pd(_mm256_loadu_pd(modes.kz + n), vz, phase);
+            __m256d s, c;
+            sincos_avx2(phase, s, c);
+            ux = _mm256_fmadd_pd(_mm256_loadu_pd(modes.px + n), c, _mm256_fmadd_pd(_mm256_loadu_pd(modes.qx + n), s, ux));
+            uy = _mm256_fmadd_pd(_mm256_loadu_pd(modes.py + n), c, _mm256_fmadd_pd(_mm256_loadu_pd(modes.qy + n), s, uy));
+            uz = _mm256_fmadd_pd(_mm256_loadu_pd(modes.pz + n), c, _mm256_fmadd_pd(_mm256_loadu_pd(modes.qz + n), s, uz));
+        }
+
+        alignas(32) double lanes[3][4];
+        _mm256_store_pd(lanes[0], ux);
+        _mm256_store_pd(lanes[1], uy);
+        _mm256_store_pd(lanes[2], uz);
+        return {(lanes[0][0] + lanes[0][1]) + (lanes[0][2] + lanes[0][3]),
+                (lanes[1][0] + lanes[1][1]) + (lanes[1][2] + lanes[1][3]),
+                (lanes[2][0] + lanes[2][1]) + (lanes[2][2] + lanes[2][3])};
+    }
+
+    /*
+     * Mixed precision kernels for float modes: phases, sincos and the terms of the sum are
+     * computed in float over 8 (16) lanes, the terms are accumulated in double.
+     * sin and cos are within 2 ULP (float) of the exact values of the float phase, the
+     * phase itself is rounded to float, so the error of a term grows as |phase| * 2^-24
+     */
+    __attribute__((target("avx2,fma"))) inline void sincos_avx2(__m256 x, __m256& sin_value, __m256& cos_value) noexcept {
+        using namespace detail;
+        const __m256 q = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(two_over_pi_f)),
+                                         _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256 r = _mm256_fnmadd_ps(q, _mm256_set1_ps(pio2_1f), x);
+        r = _mm256_fnmadd_ps(q, _mm256_set1_ps(pio2_2f), r);
+        r = _mm256_fnmadd_ps(q, _mm256_set1_ps(pio2_3f), r);
+        const __m256 z = _mm256_mul_ps(r, r);
+
+        __m256 ps = _mm256_fmadd_ps(z, _mm256_set1_ps(s3f), _mm256_set1_ps(s2f));
+        ps = _mm256_fmadd_ps(z, ps, _mm256_set1_ps(s1f));
+        const __m256 s = _mm256_fmadd_ps(_mm256_mul_ps(r, z), ps, r);
+
+        __m256 pc = _mm256_fmadd_ps(z, _mm256_set1_ps(c3f), _mm256_set1_ps(c2f));
+        pc = _mm256_fmadd_ps(z, pc, _mm256_set1_ps(c1f));
+        const __m256 c = _mm256_fmadd_ps(_mm256_mul_ps(z, z), pc,
+                                         _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, _mm256_set1_ps(1.f)));
+
+        const __m256i quadrant = _mm256_cvtps_epi32(q);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+        const __m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(quadrant, 30));
+        const __m256 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(quadrant, one), 30));
+        const __m256 sign_bit = _mm256_set1_ps(-0.f);
+
+        sin_value = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), _mm256_and_ps(sin_sign, sign_bit));
+        cos_value = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), _mm256_and_ps(cos_sign, sign_bit));
+    }
+
+    __attribute__((target("avx2,fma"))) inline std::array<double, 3> fourier_sum_avx2(const ModeArrays<float>& modes, double x, double y, double z, double t) noexcept {
+        const __m256 vx = _mm256_set1_ps(static_cast<float>(x));
+        const __m256 vy = _mm256_set1_ps(static_cast<float>(y));
+        const __m256 vz = _mm256_set1_ps(static_cast<float>(z));
+        const __m256 vt = _mm256_set1_ps(static_cast<float>(t));
+        __m256d u[3][2];
+        for (auto& component: u) {
+            component[0] = component[1] = _mm256_setzero_pd();
+        }
+
+        for (std::size_t n = 0; n < modes.n; n += 8) {
+            __m256 phase = _mm256_mul_ps(_mm256_loadu_ps(modes.omega + n), vt);
+            phase = _mm256_fmadd_ps(_mm256_loadu_ps(modes.kx + n), vx, phase);
+            phase = _mm256_fmadd_ps(_mm256_loadu_ps(modes.ky + n), vy, phase);
+            phase = _mm256_fmadd_ps(_mm256_loadu_ps(modes.kz + n), vz, phase);
+            __m256 s, c;
+            sincos_avx2(phase, s, c);
+            const float* const p[3] = {modes.px + n, modes.py + n, modes.pz + n};
+            const float* const q[3] = {modes.qx + n, modes.qy + n, modes.qz + n};
+            for (std::size_t component = 0; component < 3; ++component) {
+                const __m256 term = _mm256_fmadd_ps(_mm256_loadu_ps(p[component]), c, _mm256_mul_ps(_mm256_loadu_ps(q[component]), s));
+                u[component][0] = _mm256_add_pd(u[component][0], _mm256_cvtps_pd(_mm256_castps256_ps128(term)));
+                u[component][1] = _mm256_add_pd(u[component][1], _mm256_cvtps_pd(_mm256_extractf128_ps(term, 1)));
+            }
+        }
+
+        std::array<double, 3> result;
+        for (std::size_t component = 0; component < 3; ++component) {
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, _mm256_add_pd(u[component][0], u[component][1]));
+            result[component] = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        }
+        return result;
+    }
+
+    /* gcc 12 avx512 intrinsics headers trigger false -Wuninitialized (_mm512_undefined_*) */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    __attribute__((target("avx512f"))) inline void sincos_avx512(__m512d x, __m512d& sin_value, __m512d& cos_value) noexcept {
+        using namespace detail;
+        const __m512d q = _mm512_roundscale_pd(_mm512_mul_pd(x, _mm512_set1_pd(two_over_pi)),
+                                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m512d r = _mm512_fnmadd_pd(q, _mm512_set1_pd(pio2_1), x);
+        r = _mm512_fnmadd_pd(q, _mm512_set1_pd(pio2_2), r);
+        r = _mm512_fnmadd_pd(q, _mm512_set1_pd(pio2_3), r);
+        const __m512d z = _mm512_mul_pd(r, r);
+
+        __m512d ps = _mm512_fmadd_pd(z, _mm512_set1_pd(s6), _mm512_set1_pd(s5));
+        ps = _mm512_fmadd_pd(z, ps, _mm512_set1_pd(s4));
+        ps = _mm512_fmadd_pd(z, ps, _mm512_set1_pd(s3));
+        ps = _mm512_fmadd_pd(z, ps, _mm512_set1_pd(s2));
+        ps = _mm512_fmadd_pd(z, ps, _mm512_set1_pd(s1));
+        const __m512d s = _mm512_fmadd_pd(_mm512_mul_pd(r, z), ps, r);
+
+        __m512d pc = _mm512_fmadd_pd(z, _mm512_set1_pd(c6), _mm512_set1_pd(c5));
+        pc = _mm512_fmadd_pd(z, pc, _mm512_set1_pd(c4));
+        pc = _mm512_fmadd_pd(z, pc, _mm512_set1_pd(c3));
+        pc = _mm512_fmadd_pd(z, pc, _mm512_set1_pd(c2));
+        pc = _mm512_fmadd_pd(z, pc, _mm512_set1_pd(c1));
+        const __m512d c = _mm512_fmadd_pd(_mm512_mul_pd(z, z), pc,
+                                          _mm512_fnmadd_pd(_mm512_set1_pd(0.5), z, _mm512_set1_pd(1.)));
+
+        const __m512i quadrant = _mm512_cvtepi32_epi64(_mm512_cvtpd_epi32(q));
+        const __m512i one = _mm512_set1_epi64(1);
+        const __mmask8 swap = _mm512_test_epi64_mask(quadrant, one);
+        const __m512i sign_bit = _mm512_set1_epi64(std::int64_t{1} << 63);
+        const __m512i sin_sign = _mm512_and_si512(_mm512_slli_epi64(quadrant, 62), sign_bit);
+        const __m512i cos_sign = _mm512_and_si512(_mm512_slli_epi64(_mm512_add_epi64(quadrant, one), 62), sign_bit);
+
+        sin_value = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(_mm512_mask_blend_pd(swap, s, c)), sin_sign));
+        cos_value = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(_mm512_mask_blend_pd(swap, c, s)), cos_sign));
+    }
+
+    __attribute__((target("avx512f"))) inline std::array<double, 3> fourier_sum_avx512(const ModeArrays<double>& modes, double x, double y, double z, double t) noexcept {
+        const __m512d vx = _mm512_set1_pd(x);
+        const __m512d vy = _mm512_set1_pd(y);
+        const __m512d vz = _mm512_set1_pd(z);
+        const __m512d vt = _mm512_set1_pd(t);
+        __m512d ux = _mm512_setzero_pd(), uy = _mm512_setzero_pd(), uz = _mm512_setzero_pd();
+
+        for (std::size_t n = 0; n < modes.n; n += 8) {
+            __m512d phase = _mm512_mul_pd(_mm512_loadu_pd(modes.omega + n), vt);
+            phase = _mm512_fmadd_pd(_mm512_loadu_pd(modes.kx + n), vx, phase);
+            phase = _mm512_fmadd_pd(_mm512_loadu_pd(modes.ky + n), vy, phase);
+            phase = _mm512_fmadd_pd(_mm512_loadu_pd(modes.kz + n), vz, phase);
+            __m512d s, c;
+            sincos_avx512(phase, s, c);
+            ux = _mm512_fmadd_pd(_mm512_loadu_pd(modes.px + n), c, _mm512_fmadd_pd(_mm512_loadu_pd(modes.qx + n), s, ux));
+            uy = _mm512_fmadd_pd(_mm512_loadu_pd(modes.py + n), c, _mm512_fmadd_pd(_mm512_loadu_pd(modes.qy + n), s, uy));
+            uz = _mm512_fmadd_pd(_mm512_loadu_pd(modes.pz + n), c, _mm512_fmadd_pd(_mm512_loadu_pd(modes.qz + n), s, uz));
+        }
+
+        return {_mm512_reduce_add_pd(ux), _mm512_reduce_add_pd(uy), _mm512_reduce_add_pd(uz)};
+    }
+
+    __attribute__((target("avx512f"))) inline void sincos_avx512(__m512 x, __m512& sin_value, __m512& cos_value) noexcept {
+        using namespace detail;
+        const __m512 q = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(two_over_pi_f)),
+                                              _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m512 r = _mm512_fnmadd_ps(q, _mm512_set1_ps(pio2_1f), x);
+        r = _mm512_fnmadd_ps(q, _mm512_set1_ps(pio2_2f), r);
+        r = _mm512_fnmadd_ps(q, _mm512_set1_ps(pio2_3f), r);
+        const __m512 z = _mm512_mul_ps(r, r);
+
+        __m512 ps = _mm512_fmadd_ps(z, _mm512_set1_ps(s3f), _mm512_set1_ps(s2f));
+        ps = _mm512_fmadd_ps(z, ps, _mm512_set1_ps(s1f));
+        const __m512 s = _mm512_fmadd_ps(_mm512_mul_ps(r, z), ps, r);
+
+        __m512 pc = _mm512_fmadd_ps(z, _mm512_set1_ps(c3f), _mm512_set1_ps(c2f));
+        pc = _mm512_fmadd_ps(z, pc, _mm512_set1_ps(c1f));
+        const __m512 c = _mm512_fmadd_ps(_mm512_mul_ps(z, z), pc,
+                                         _mm512_fnmadd_ps(_mm512_set1_ps(0.5f), z, _mm512_set1_ps(1.f)));
+
+        const __m512i quadrant = _mm512_cvtps_epi32(q);
+        const __m512i one = _mm512_set1_epi32(1);
+        const __mmask16 swap = _mm512_test_epi32_mask(quadrant, one);
+        const __m512i sign_bit = _mm512_set1_epi32(std::int32_t{1} << 31);
+        const __m512i sin_sign = _mm512_and_si512(_mm512_slli_epi32(quadrant, 30), sign_bit);
+        const __m512i cos_sign = _mm512_and_si512(_mm512_slli_epi32(_mm512_add_epi32(quadrant, one), 30), sign_bit);
+
+        sin_value = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_mask_blend_ps(swap, s, c)), sin_sign));
+        cos_value = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_mask_blend_ps(swap, c, s)), cos_sign));
+    }
+
+    /* 16 modes per iteration, the last 8 of a padded block are read by a masked load */
+    __attribute__((target("avx512f"))) inline std::array<double, 3> fourier_sum_avx512(const ModeArrays<float>& modes, double x, double y, double z, double t) noexcept {
+        const __m512 vx = _mm512_set1_ps(static_cast<float>(x));
+        const __m512 vy = _mm512_set1_ps(static_cast<float>(y));
+        const __m512 vz = _mm512_set1_ps(static_cast<float>(z));
+        const __m512 vt = _mm512_set1_ps(static_cast<float>(t));
+        __m512d u[3][2];
+        for (auto& component: u) {
+            component[0] = component[1] = _mm512_setzero_pd();
+        }
+
+        for (std::size_t n = 0; n < modes.n; n += 16) {
+            const __mmask16 mask = modes.n - n >= 16 ? __mmask16(0xFFFF) : __mmask16(0x00FF);
+            __m512 phase = _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, modes.omega + n), vt);
+            phase = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, modes.kx + n), vx, phase);
+            phase = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, modes.ky + n), vy, phase);
+            phase = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, modes.kz + n), vz, phase);
+            __m512 s, c;
+            sincos_avx512(phase, s, c);
+            const float* const p[3] = {modes.px + n, modes.py + n, modes.pz + n};
+            const float* const q[3] = {modes.qx + n, modes.qy + n, modes.qz + n};
+            for (std::size_t component = 0; component < 3; ++component) {
+                const __m512 term = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, p[component]), c,
+                                                    _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, q[component]), s));
+                const __m512d halves = _mm512_castps_pd(term);
+                u[component][0] = _mm512_add_pd(u[component][0], _mm512_cvtps_pd(_mm512_castps512_ps256(term)));
+                u[component][1] = _mm512_add_pd(u[component][1], _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(halves, 1))));
+            }
+        }
+
+        return {_mm512_reduce_add_pd(_mm512_add_pd(u[0][0], u[0][1])),
+                _mm512_reduce_add_pd(_mm512_add_pd(u[1][0], u[1][1])),
+                _mm512_reduce_add_pd(_mm512_add_pd(u[2][0], u[2][1]))};
+    }
+
+    /*
+     * Accumulators of 4 vectors (32 vertices) stay in registers over all modes of the block,
+     * the row tail is handled by masked loads and stores
+     */
+    __attribute__((target("avx512f"))) inline void rotate_accumulate_row_avx512(const RowRotation& row, double* ux, double* uy, double* uz) noexcept {
+        constexpr std::size_t vectors = 4;
+        for (std::size_t i = 0; i < row.nx; i += 8 * vectors) {
+            __mmask8 mask[vectors];
+            __m512d acc_x[vectors], acc_y[vectors], acc_z[vectors];
+            for (std::size_t v = 0; v < vectors; ++v) {
+                const std::size_t begin = i + 8 * v;
+                const std::size_t left = row.nx > begin ? row.nx - begin : 0;
+                mask[v] = left >= 8 ? __mmask8(0xFF) : __mmask8((1u << left) - 1);
+                acc_x[v] = _mm512_maskz_loadu_pd(mask[v], ux + begin);
+                acc_y[v] = _mm512_maskz_loadu_pd(mask[v], uy + begin);
+                acc_z[v] = _mm512_maskz_loadu_pd(mask[v], uz + begin);
+            }
+            for (std::size_t m = 0; m < row.modes_n; ++m) {
+                const double* const x_cos = row.x_cos + m * row.nx + i;
+                const double* const x_sin = row.x_sin + m * row.nx + i;
+                const __m512d rotation_cos = _mm512_set1_pd(row.yz_cos[m]), rotation_sin = _mm512_set1_pd(row.yz_sin[m]);
+                const __m512d px = _mm512_set1_pd(row.p[0][m]), py = _mm512_set1_pd(row.p[1][m]), pz = _mm512_set1_pd(row.p[2][m]);
+                const __m512d qx = _mm512_set1_pd(row.q[0][m]), qy = _mm512_set1_pd(row.q[1][m]), qz = _mm512_set1_pd(row.q[2][m]);
+                for (std::size_t v = 0; v < vectors; ++v) {
+                    const __m512d xc = _mm512_maskz_loadu_pd(mask[v], x_cos + 8 * v);
+                    const __m512d xs = _mm512_maskz_loadu_pd(mask[v], x_sin + 8 * v);
+                    const __m512d c = _mm512_fmsub_pd(xc, rotation_cos, _mm512_mul_pd(xs, rotation_sin));
+                    const __m512d s = _mm512_fmadd_pd(xc, rotation_sin, _mm512_mul_pd(xs, rotation_cos));
+                    acc_x[v] = _mm512_fmadd_pd(px, c, _mm512_fmadd_pd(qx, s, acc_x[v]));
+                    acc_y[v] = _mm512_fmadd_pd(py, c, _mm512_fmadd_pd(qy, s, acc_y[v]));
+                    acc_z[v] = _mm512_fmadd_pd(pz, c, _mm512_fmadd_pd(qz, s, acc_z[v]));
+                }
+            }
+            for (std::size_t v = 0; v < vectors; ++v) {
+                const std::size_t begin = i + 8 * v;
+                _mm512_mask_storeu_pd(ux + begin, mask[v], acc_x[v]);
+                _mm512_mask_storeu_pd(uy + begin, mask[v], acc_y[v]);
+                _mm512_mask_storeu_pd(uz + begin, mask[v], acc_z[v]);
+            }
+        }
+    }
+#pragma GCC diagnostic pop
+
+    __attribute__((target("avx2,fma"))) inline void rotate_accumulate_row_avx2(const RowRotation& row, double* ux, double* uy, double* uz) noexcept {
+        const std::size_t vector_end = row.nx / 4 * 4;
+        for (std::size_t m = 0; m < row.modes_n; ++m) {
+            const double* const x_cos = row.x_cos + m * row.nx;
+            const double* const x_sin = row.x_sin + m * row.nx;
+            const __m256d rotation_cos = _mm256_set1_pd(row.yz_cos[m]), rotation_sin = _mm256_set1_pd(row.yz_sin[m]);
+            const __m256d px = _mm256_set1_pd(row.p[0][m]), py = _mm256_set1_pd(row.p[1][m]), pz = _mm256_set1_pd(row.p[2][m]);
+            const __m256d qx = _mm256_set1_pd(row.q[0][m]), qy = _mm256_set1_pd(row.q[1][m]), qz = _mm256_set1_pd(row.q[2][m]);
+            for (std::size_t i = 0; i < vector_end; i += 4) {
+                const __m256d xc = _mm256_loadu_pd(x_cos + i), xs = _mm256_loadu_pd(x_sin + i);
+                const __m256d c = _mm256_fmsub_pd(xc, rotation_cos, _mm256_mul_pd(xs, rotation_sin));
+                const __m256d s = _mm256_fmadd_pd(xc, rotation_sin, _mm256_mul_pd(xs, rotation_cos));
+                _mm256_storeu_pd(ux + i, _mm256_fmadd_pd(px, c, _mm256_fmadd_pd(qx, s, _mm256_loadu_pd(ux + i))));
+                _mm256_storeu_pd(uy + i, _mm256_fmadd_pd(py, c, _mm256_fmadd_pd(qy, s, _mm256_loadu_pd(uy + i))));
+                _mm256_storeu_pd(uz + i, _mm256_fmadd_pd(pz, c, _mm256_fmadd_pd(qz, s, _mm256_loadu_pd(uz + i))));
+            }
+        }
+        rotate_accumulate_row_scalar(row, vector_end, ux, uy, uz);
+    }
+#endif
+
+    /* Widest kernel supported by the running cpu, detected once */
+    inline SinCosKernel best_sincos_kernel() noexcept {
+#ifdef STG_SIMD_X86
+        static const SinCosKernel kernel = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return SinCosKernel::avx512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SinCosKernel::avx2;
+            return SinCosKernel::scalar;
+        }();
+        return kernel;
+#else
+        return SinCosKernel::scalar;
+#endif
+    }
+
+    inline bool is_supported(SinCosKernel kernel) noexcept {
+        switch (kernel) {
+            case SinCosKernel::avx512:
+                return best_sincos_kernel() == SinCosKernel::avx512;
+            case SinCosKernel::avx2:
+                return best_sincos_kernel() != SinCosKernel::scalar;
+            case SinCosKernel::scalar:
+                break;
+        }
+        return true;
+    }
+
+    inline void rotate_accumulate_row(const RowRotation& row, double* ux, double* uy, double* uz,
+                                      SinCosKernel kernel = best_sincos_kernel()) noexcept {
+#ifdef STG_SIMD_X86
+        switch (kernel) {
+            case SinCosKernel::avx512:
+                return rotate_accumulate_row_avx512(row, ux, uy, uz);
+            case SinCosKernel::avx2:
+                return rotate_accumulate_row_avx2(row, ux, uy, uz);
+            case SinCosKernel::scalar:
+                break;
+        }
+#endif
+        rotate_accumulate_row_scalar(row, 0, ux, uy, uz);
+    }
+
+    template<std::floating_point T>
+    std::array<double, 3> fourier_sum(const ModeArrays<T>& modes, double x, double y, double z, double t,
+                                      SinCosKernel kernel = best_sincos_kernel()) noexcept {
+#ifdef STG_SIMD_X86
+        if constexpr (std::same_as<T, double> || std::same_as<T, float>) {
+            switch (kernel) {
+                case SinCosKernel::avx512:
+                    return fourier_sum_avx512(modes, x, y, z, t);
+                case SinCosKernel::avx2:
+                    return fourier_sum_avx2(modes, x, y, z, t);
+                case SinCosKernel::scalar:
+                    break;
+            }
+        }
+#endif
+        return fourier_sum_scalar(modes, x, y, z, t);
+    }
+}// namespace stg::generators::simd
+
+#endif//STG_SIMD_SINCOS_HPP
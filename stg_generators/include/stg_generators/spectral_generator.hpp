@@ -1,20 +1,27 @@
 #ifndef STG_SPECTRAL_GENERATOR_HPP
 #define STG_SPECTRAL_GENERATOR_HPP
 
+#include "fourier_modes.hpp"
 #include "i_spectral_generator.hpp"
+#include "phasor_time_stepper.hpp"
+#include "seeded_modes.hpp"
 #include "spectral_generator_config.hpp"
 #include "spectras_base.hpp"
 #include <algorithm>
-#include <execution>
 #include <filesystem>
 #include <geometry/geometry.hpp>
 #include <memory>
+#include <optional>
 #include <range/v3/all.hpp>
 #include <range/v3/view/iota.hpp>
 #include <ranges>
+#include <span>
+#include <stdexcept>
+#include <stg_random/counter_based_engine.hpp>
 #include <stg_random/generator_engines.hpp>
 #include <stg_random/rn_generator_impl.hpp>
 #include <stg_tensor/tensor.hpp>
+#include <stg_thread_pool/parallel_for.hpp>
 #include <vector>
 
 namespace stg::generators {
@@ -47,13 +54,13 @@ namespace stg::generators {
      * Create generator using only config values
      */
         explicit SpectralGenerator(SpectralGeneratorConfig<T> config)
-            : SpectralGenerator(std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<>>>(
+            : SpectralGenerator(std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<value_type>>>(
                                         engines::get_engine<std::mt19937_64>(seed),
                                         std::normal_distribution(config.amplitudes_generator_mean_, config.amplitudes_generator_std_)),
-                                std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<>>>(
+                                std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<value_type>>>(
                                         engines::get_engine<std::mt19937_64>(seed),
                                         std::normal_distribution(config.wave_vectors_generator_mean_, config.wave_vectors_generator_std_)),
-                                std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<>>>(
+                                std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<value_type>>>(
                                         engines::get_engine<std::mt19937_64>(seed),
                                         std::normal_distribution(config.frequencies_generator_mean_, config.frequencies_generator_std_)),
                                 std::move(config)) {}
@@ -78,6 +85,20 @@ namespace stg::generators {
             return result_fluctuation;
         }
 
+        /*
+         * Amplitudes are drawn anew on every evaluation, so modes can't be
+         * shared across a block of points without changing the random stream;
+         * only the virtual dispatch per point is saved here
+         */
+        void evaluate(std::span<const Point<value_type>> points, value_type time, std::span<Vector<value_type>> out) const override {
+            if (points.size() != out.size()) {
+                throw std::invalid_argument("Points and output spans have different lengths");
+            }
+            for (std::size_t index = 0; index < points.size(); ++index) {
+                out[index] = SpectralGenerator::operator()(points[index], time);
+            }
+        }
+
         ~SpectralGenerator() override = default;
 
     private:
@@ -114,8 +135,9 @@ namespace stg::generators {
                 return Vector<value_type>{x, y, z};
             };
 
+            // The wave vector generator is stateful, the draws are sequential to keep it reproducible
             std::vector<Vector<value_type>> result(size);
-            std::transform(std::execution::par_unseq, begin, end, result.begin(), get_k_vector);
+            std::transform(begin, end, result.begin(), get_k_vector);
 
             return result;
         }
@@ -134,7 +156,12 @@ namespace stg::generators {
     class KolmogorovSpectra final : public ISpectra<T> {
     public:
         using value_type = T;
-        value_type operator()(value_type k) const override {
+
+        value_type operator()(value_type k_x, value_type k_y, value_type k_z) const noexcept override {
+            return operator()(std::sqrt(k_x * k_x + k_y * k_y + k_z * k_z));
+        }
+
+        value_type operator()(value_type k) const noexcept override {
             value_type logkappa = log10(k);
             value_type logE;
             if (logkappa < 0.0) {
@@ -158,7 +185,11 @@ namespace stg::generators {
         VonKarmanSpectra(value_type k_e, value_type k_eta, value_type k_cut) noexcept
             : k_e_{k_e}, k_eta_{k_eta}, k_cut_{k_cut} {}
 
-        value_type operator()(value_type k) const override {
+        value_type operator()(value_type k_x, value_type k_y, value_type k_z) const noexcept override {
+            return operator()(std::sqrt(k_x * k_x + k_y * k_y + k_z * k_z));
+        }
+
+        value_type operator()(value_type k) const noexcept override {
             const auto numerator = std::pow(k / k_e_, 4);
             const auto inner_denumerator_braces = std::pow(k / k_e_, 2);
             const auto denumerator = std::pow(1 + 2.4 * inner_denumerator_braces, 17. / 6.);
@@ -173,7 +204,7 @@ namespace stg::generators {
         }
 
         value_type f_cut(value_type k) const {
-            const auto exp_arg = -std::pow(4 * std::max(k - k_cut_, 0.) / k_cut_, 3);
+            const auto exp_arg = -std::pow(4 * std::max(k - k_cut_, value_type{0}) / k_cut_, 3);
             return std::pow(std::numbers::e, exp_arg);
         }
     };
@@ -191,6 +222,7 @@ namespace stg::generators {
         std::size_t edge_points = 21;
         fs::path save_data_dir_path = fs::path{"./spectral_result/"};
         T cube_edge_len = 10.;
+        bool grid_phase_tables = true; // generate on cube grids with per-axis phase tables
         stg::tensor::Tensor<T> reynolds_tensor_{
                 1., 0., 0.,
                 0., 1., 0.,
@@ -205,6 +237,9 @@ namespace stg::generators {
             std::vector<T> q_;
         };
 
+        // Distributions of the seeded generator, every spectrum and mode draws from its own philox stream
+        using RandomStreams = ModeDistributions<T>;
+
     public:
         using value_type = T;
 
@@ -222,20 +257,22 @@ namespace stg::generators {
                             value_type length_scale, value_type time_scale,
                             stg::tensor::Tensor<value_type> reynolds_tensor,
                             std::size_t spectra_n, std::size_t fourier_n)
-            : SpectralGeneratorV2(std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<>>>(
+            : SpectralGeneratorV2(std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<value_type>>>(
                                           engines::get_engine<std::mt19937_64>(seed_for_generators),
                                           std::normal_distribution(ampl_mean, ampl_std)),
-                                  std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<>>>(
+                                  std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<value_type>>>(
                                           engines::get_engine<std::mt19937_64>(seed_for_generators),
                                           std::normal_distribution(wv_mean, wv_std)),
-                                  std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<>>>(
+                                  std::make_shared<RNGenerator<std::mt19937_64, std::normal_distribution<value_type>>>(
                                           engines::get_engine<std::mt19937_64>(seed_for_generators),
                                           std::normal_distribution(freq_mean, freq_std)),
-                                  std::make_shared<RNGenerator<std::mt19937_64, std::uniform_real_distribution<>>>(
+                                  std::make_shared<RNGenerator<std::mt19937_64, std::uniform_real_distribution<value_type>>>(
                                           engines::get_engine<std::mt19937_64>(seed_for_generators),
-                                          std::uniform_real_distribution(0., 1.)),
+                                          std::uniform_real_distribution<value_type>(0., 1.)),
                                   std::move(reynolds_tensor), length_scale, time_scale,
-                                  spectra_n, fourier_n) {}
+                                  spectra_n, fourier_n) {
+            streams_ = RandomStreams{seed_for_generators, ampl_mean, ampl_std, wv_mean, wv_std, freq_mean, freq_std};
+        }
 
         template<concepts::GeneratorConcept AmplitudeGenerator,
                  concepts::GeneratorConcept FrequenciesGenerator,
@@ -252,8 +289,7 @@ namespace stg::generators {
         void initialize_wave_vector_amplitudes(value_type k_min, value_type k_max, std::size_t n) {
             k_modules_.resize(n);
             const auto dk = (k_max - k_min) / (n - 1);
-            std::ranges::generate(k_modules_, [k_m = k_min, dk]() {
-                static std::size_t index = 0;
+            std::ranges::generate(k_modules_, [k_m = k_min, dk, index = std::size_t{0}]() mutable {
                 return k_m + dk * index++;
             });
         }
@@ -264,10 +300,21 @@ namespace stg::generators {
             ranges::copy(values, ranges::back_inserter(k_modules_));
         }
 
+        /*
+         * Generator created from the seed draws every coefficient from its own stream on the global pool,
+         * the values do not depend on the partition of the modes. Shared generators are called in order
+         */
         void initialize_random_coefficients() {
             random_coeffs_.resize(spectra_n_);
-            std::generate(std::execution::par, random_coeffs_.begin(), random_coeffs_.end(),
-                          [this] { return rand_param_generator_->operator()(); });
+            if (!streams_) {
+                rand_param_generator_->fill(random_coeffs_);
+                return;
+            }
+            utility::parallel_for(utility::ThreadPool::global(), 0, random_coeffs_.size(), 1, [this](std::size_t begin, std::size_t end) {
+                for (std::size_t spectrum_index = begin; spectrum_index < end; ++spectrum_index) {
+                    random_coeffs_[spectrum_index] = seeded_random_coefficient<random::Philox4x32>(*streams_, fourier_modes_n_, spectrum_index);
+                }
+            });
         }
 
         auto initialize_spectra(std::shared_ptr<ISpectra<value_type>> spectra) {
@@ -278,6 +325,20 @@ namespace stg::generators {
             assert(spectra_n_ == static_cast<std::size_t>(ranges::distance(k_modules_)));
             mode_fluctuations_generators_.resize(spectra_n_);
 
+            if (streams_) {
+                const std::array<value_type, 3> diagonal{lower_triangular_.get(0, 0), lower_triangular_.get(1, 1), lower_triangular_.get(2, 2)};
+                utility::parallel_for(utility::ThreadPool::global(), 0, mode_fluctuations_generators_.size(), 1,
+                                      [this, diagonal](std::size_t begin, std::size_t end) {
+                                          for (std::size_t index = begin; index < end; ++index) {
+                                              mode_fluctuations_generators_[index] = SpectralModeFluctuationGenerator::create(
+                                                      fourier_modes_n_, *streams_, index,
+                                                      random_coeffs_[index], spectra_->operator()(k_modules_[index]), k_modules_[index],
+                                                      scale_factor_, diagonal);
+                                          }
+                                      });
+                return;
+            }
+
             for (const auto [index, k_module]: k_modules_ | ranges::views::enumerate) {
                 const auto a_coeff = random_coeffs_[index];
 
@@ -305,15 +366,99 @@ namespace stg::generators {
             return result;
         }
 
+        /*
+         * Points are taken by tiles, every tile is passed through all mode
+         * generators, each of them walks its modes tile by tile
+         */
+        void evaluate(std::span<const Point<T>> points, T time, std::span<Vector<T>> out) const override {
+            if (points.size() != out.size()) {
+                throw std::invalid_argument("Points and output spans have different lengths");
+            }
+            time /= time_scale_;
+
+            std::array<Point<T>, simd::points_tile> scaled_points;
+            std::array<std::array<double, 3>, simd::points_tile> accumulator;
+            for (std::size_t tile_begin = 0; tile_begin < points.size(); tile_begin += simd::points_tile) {
+                const std::size_t tile_size = std::min(simd::points_tile, points.size() - tile_begin);
+                for (std::size_t index = 0; index < tile_size; ++index) {
+                    scaled_points[index] = points[tile_begin + index] / length_scale_;
+                }
+                std::ranges::fill(accumulator, std::array<double, 3>{0., 0., 0.});
+
+                const auto tile_points = std::span<const Point<T>>{scaled_points}.first(tile_size);
+                const auto tile_accumulator = std::span{accumulator}.first(tile_size);
+                for (const auto& inner_generator: mode_fluctuations_generators_) {
+                    inner_generator.accumulate(tile_points, time, tile_accumulator);
+                }
+
+                for (std::size_t index = 0; index < tile_size; ++index) {
+                    const auto [ux, uy, uz] = accumulator[index];
+                    out[tile_begin + index] = {static_cast<T>(ux), static_cast<T>(uy), static_cast<T>(uz)};
+                }
+            }
+        }
+
+        /*
+         * Per-axis phase tables, see FourierModes::accumulate_on_grid
+         */
+        void evaluate_on_grid(const GridAxes<T>& axes, std::size_t k_begin, std::size_t k_end, T time,
+                              std::span<Vector<T>> out) const override {
+            if (out.size() != axes.n_vertices(k_begin, k_end)) {
+                throw std::invalid_argument("Output span size is not equal to the number of grid vertices");
+            }
+            const auto scale_axis = [this](std::span<const T> axis) {
+                std::vector<T> scaled(axis.size());
+                std::ranges::transform(axis, scaled.begin(), [this](T value) { return value / length_scale_; });
+                return scaled;
+            };
+            const auto x = scale_axis(axes.x), y = scale_axis(axes.y), z = scale_axis(axes.z);
+            const GridAxes<T> scaled_axes{x, y, z};
+            time /= time_scale_;
+
+            std::vector<double> ux(out.size()), uy(out.size()), uz(out.size());
+            for (const auto& inner_generator: mode_fluctuations_generators_) {
+                inner_generator.accumulate_on_grid(scaled_axes, k_begin, k_end, time, ux, uy, uz);
+            }
+            for (std::size_t index = 0; index < out.size(); ++index) {
+                out[index] = {static_cast<T>(ux[index]), static_cast<T>(uy[index]), static_cast<T>(uz[index])};
+            }
+        }
+
         value_type max_period() const {
             const auto min_omega = std::ranges::min(mode_fluctuations_generators_ | std::views::transform([](const auto& gen) {
-                                                        return std::ranges::min(gen.frequencies_ | std::views::transform([](auto value) {
+                                                        return std::ranges::min(gen.modes_.frequencies() | std::views::transform([](auto value) {
                                                                                     return std::fabs(value);
                                                                                 }));
                                                     }));
             return 2 * std::numbers::pi / min_omega;
         }
 
+        /*
+         * Stepper over fixed points from time with the step time_step, see PhasorTimeStepper.
+         * Modes of all inner generators are merged into one set with the weights
+         * sqrt(2 / n) and the length and time scales folded in
+         */
+        PhasorTimeStepper<T> time_stepper(std::vector<Point<T>> points, T time, T time_step,
+                                          std::size_t memory_budget = PhasorTimeStepper<T>::default_memory_budget) const {
+            std::size_t total_modes = 0;
+            for (const auto& generator: mode_fluctuations_generators_) {
+                total_modes += generator.modes_.size();
+            }
+
+            FourierModes<T> modes{total_modes};
+            std::size_t index = 0;
+            for (const auto& generator: mode_fluctuations_generators_) {
+                const auto weight = static_cast<T>(std::sqrt(2. / generator.fourier_modes_n_));
+                for (std::size_t mode = 0; mode < generator.modes_.size(); ++mode, ++index) {
+                    modes.set_wave_vector(index, generator.modes_.wave_vector(mode) / length_scale_);
+                    modes.set_p_vector(index, generator.modes_.p_vector(mode) * weight);
+                    modes.set_q_vector(index, generator.modes_.q_vector(mode) * weight);
+                    modes.frequencies()[index] = generator.modes_.frequencies()[mode] / time_scale_;
+                }
+            }
+            return {std::move(modes), std::move(points), time, time_step, memory_budget};
+        }
+
         ~SpectralGeneratorV2() override = default;
 
     private:
@@ -325,20 +470,20 @@ namespace stg::generators {
             friend SpectralGeneratorV2;
 
             std::size_t fourier_modes_n_;
-            std::vector<Vector<value_type>> wave_vectors_;
-            std::vector<Vector<value_type>> p_vectors_;
-            std::vector<Vector<value_type>> q_vectors_;
-            std::vector<value_type> frequencies_;
+            FourierModes<value_type> modes_;
 
             Vector<value_type> operator()(const Point<value_type>& point, value_type time) const {
-                Vector<value_type> result{0., 0., 0};
+                return modes_.sum(point, time) * static_cast<value_type>(std::sqrt(2. / fourier_modes_n_));
+            }
 
-                for (const std::size_t node: std::views::iota(0ull, fourier_modes_n_)) {
-                    const auto phase = dot_product(wave_vectors_[node], point) + frequencies_[node] * time;
-                    result += p_vectors_[node] * std::cos(phase) + q_vectors_[node] * std::sin(phase);
-                }
+            void accumulate(std::span<const Point<value_type>> points, value_type time,
+                            std::span<std::array<double, 3>> accumulator) const noexcept {
+                modes_.accumulate(points, time, accumulator, std::sqrt(2. / fourier_modes_n_));
+            }
 
-                return result * std::sqrt(2. / fourier_modes_n_);
+            void accumulate_on_grid(const GridAxes<value_type>& axes, std::size_t k_begin, std::size_t k_end, value_type time,
+                                    std::span<double> ux, std::span<double> uy, std::span<double> uz) const {
+                modes_.accumulate_on_grid(axes, k_begin, k_end, time, ux, uy, uz, std::sqrt(2. / fourier_modes_n_));
             }
 
             template<stg::concepts::GeneratorConcept AmplitudeGenerator,
@@ -356,74 +501,81 @@ namespace stg::generators {
                     value_type scale_coeff, std::array<value_type, 3> diagonal) {
                 SpectralModeFluctuationGenerator generator;
                 generator.fourier_modes_n_ = fourier_modes_n;
+                generator.modes_.resize(fourier_modes_n);
                 generator.initialize_frequencies(frequencies_generator);
                 generator.initialize_wave_vectors(wave_vectors_generator, k_module, scale_coeff, diagonal);
                 generator.initialize_amplitudes(ampl_generator, energy, random_coeff);
                 return generator;
             }
 
+            // Modes of the spectrum spectrum_index drawn by draw_seeded_modes
+            static SpectralModeFluctuationGenerator create(
+                    std::size_t fourier_modes_n, const RandomStreams& streams, std::size_t spectrum_index,
+                    value_type random_coeff, value_type energy, value_type k_module,
+                    value_type scale_coeff, std::array<value_type, 3> diagonal) {
+                SpectralModeFluctuationGenerator generator;
+                generator.fourier_modes_n_ = fourier_modes_n;
+                generator.modes_.resize(fourier_modes_n);
+                draw_seeded_modes<random::Philox4x32>(generator.modes_, 0, streams, fourier_modes_n, spectrum_index,
+                                                      random_coeff, energy, k_module, scale_coeff, diagonal);
+                return generator;
+            }
+
             template<stg::concepts::GeneratorConcept FrequenciesGenerator>
             void initialize_frequencies(std::shared_ptr<FrequenciesGenerator> freq_generator) {
-                frequencies_.resize(fourier_modes_n_);
-                std::generate(std::execution::par, frequencies_.begin(), frequencies_.end(),
-                              [gen = std::forward<std::shared_ptr<FrequenciesGenerator>>(freq_generator)] { return gen->operator()(); });
+                const auto frequencies = draw(*freq_generator, fourier_modes_n_);
+                std::ranges::copy(frequencies, modes_.frequencies().begin());
             }
 
             template<stg::concepts::GeneratorConcept AmplitudesGenerator>
             void initialize_amplitudes(std::shared_ptr<AmplitudesGenerator> ampl_generator,
                                        value_type energy_value, value_type rand_coeff) {
-                assert(!wave_vectors_.empty());
-                p_vectors_.resize(fourier_modes_n_);
-                q_vectors_.resize(fourier_modes_n_);
+                assert(!modes_.empty());
 
                 const auto p_amplitude = std::sqrt(rand_coeff * energy_value * 4 / fourier_modes_n_);
                 const auto q_amplitude = std::sqrt((1 - rand_coeff) * energy_value * 4 / fourier_modes_n_);
 
-                auto createRandVector = [ampl_generator] {
-                    const value_type x = ampl_generator->operator()();
-                    const value_type y = ampl_generator->operator()();
-                    const value_type z = ampl_generator->operator()();
-                    return Vector<value_type>{x, y, z};
-                };
-
+                // xi and zeta of every mode, six values per mode in the order of the sequential draws
+                const auto values = draw(*ampl_generator, 6 * fourier_modes_n_);
                 for (const std::size_t index: std::views::iota(0ull, fourier_modes_n_)) {
-                    auto xi = createRandVector();
-                    auto zeta = createRandVector();
+                    const auto* value = values.data() + 6 * index;
+                    const Vector<value_type> xi{value[0], value[1], value[2]};
+                    const Vector<value_type> zeta{value[3], value[4], value[5]};
 
-                    auto p_vector = cross_product(xi, wave_vectors_[index]);
-                    auto q_vector = cross_product(zeta, wave_vectors_[index]);
+                    const auto wave_vector = modes_.wave_vector(index);
+                    auto p_vector = cross_product(xi, wave_vector);
+                    auto q_vector = cross_product(zeta, wave_vector);
 
-                    p_vector = scale_to_length(p_vector, p_amplitude);
-                    q_vector = scale_to_length(q_vector, q_amplitude);
-
-                    p_vectors_[index] = std::move(p_vector);
-                    q_vectors_[index] = std::move(q_vector);
+                    modes_.set_p_vector(index, scale_to_length(p_vector, p_amplitude));
+                    modes_.set_q_vector(index, scale_to_length(q_vector, q_amplitude));
                 }
             }
 
             template<stg::concepts::GeneratorConcept WaveVectorsGenerator>
             void initialize_wave_vectors(std::shared_ptr<WaveVectorsGenerator> wave_vectors_generator, value_type k_module,
                                          value_type scale_coeff, std::array<value_type, 3> diagonal) {
-                wave_vectors_.resize(fourier_modes_n_);
-                std::ranges::generate(wave_vectors_, [gen = std::move(wave_vectors_generator), k_module,
-                                                      scale_coeff, diagonal, this]() {
-                    auto generated = generate_vector_with_length(gen, k_module);
-                    generated = {generated.template get<0>() * scale_coeff / diagonal[0],
-                                 generated.template get<1>() * scale_coeff / diagonal[1],
-                                 generated.template get<2>() * scale_coeff / diagonal[2]};
-                    return generated;
-                });
+                assert(k_module > 0.);
+                const auto values = draw(*wave_vectors_generator, 3 * fourier_modes_n_);
+                for (const std::size_t index: std::views::iota(0ull, fourier_modes_n_)) {
+                    const auto* value = values.data() + 3 * index;
+                    const auto generated = scale_to_length(Vector<value_type>{value[0], value[1], value[2]}, k_module);
+                    modes_.set_wave_vector(index, {generated.template get<0>() * scale_coeff / diagonal[0],
+                                                   generated.template get<1>() * scale_coeff / diagonal[1],
+                                                   generated.template get<2>() * scale_coeff / diagonal[2]});
+                }
             }
 
+            // n values by one bulk call when the generator provides fill
             template<stg::concepts::GeneratorConcept Generator>
-            Vector<value_type> generate_vector_with_length(std::shared_ptr<Generator> gen, value_type len) {
-                assert(len > 0.);
-                value_type x = gen->operator()();
-                value_type y = gen->operator()();
-                value_type z = gen->operator()();
-                Vector<value_type> vec{x, y, z};
-                return scale_to_length(vec, len);
-            };
+            static std::vector<value_type> draw(Generator& generator, std::size_t n) {
+                std::vector<value_type> values(n);
+                if constexpr (requires { generator.fill(std::span<value_type>{values}); }) {
+                    generator.fill(values);
+                } else {
+                    std::ranges::generate(values, [&generator] { return static_cast<value_type>(generator()); });
+                }
+                return values;
+            }
         };
 
         const std::size_t spectra_n_;
@@ -440,6 +592,7 @@ namespace stg::generators {
         std::vector<value_type> random_coeffs_;
 
         std::vector<SpectralModeFluctuationGenerator> mode_fluctuations_generators_;
+        std::optional<RandomStreams> streams_;
     };
 }// namespace stg::generators
 
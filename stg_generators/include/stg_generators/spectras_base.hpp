@@ -6,6 +6,7 @@
 #include <concepts>
 #include <cstddef>
 #include <limits>
+#include <numbers>
 
 namespace stg::generators {
 
@@ -43,14 +44,33 @@ namespace stg::generators {
         const value_type k_0_;
     };
 
+    /*
+     * Kraichnan gaussian spectrum E(k) = 16 sqrt(2 / pi) v_0^2 k^4 / k_0^5 exp(-2 k^2 / k_0^2),
+     * integral over k equals 3 / 2 v_0^2
+     */
     template<std::floating_point T>
     class GaussianSpectra final : public ISpectra<T> {
     public:
         using value_type = T;
 
-        value_type operator()(value_type k_x, value_type k_y, value_type k_z) const noexcept override;
-        value_type operator()(value_type k_mod) const noexcept override;
+        explicit GaussianSpectra(value_type v_0, value_type k_0) noexcept
+            : v_0_{v_0}, k_0_{k_0} {}
+
+        value_type operator()(value_type k_x, value_type k_y, value_type k_z) const noexcept override {
+            return operator()(std::sqrt(k_x * k_x + k_y * k_y + k_z * k_z));
+        }
+
+        value_type operator()(value_type k_mod) const noexcept override {
+            const value_type ratio = k_mod / k_0_;
+            return 16 * std::sqrt(2 / std::numbers::pi_v<value_type>) * v_0_ * v_0_ / k_0_ *
+                   std::pow(ratio, 4) * std::exp(-2 * ratio * ratio);
+        }
+
         ~GaussianSpectra() override = default;
+
+    private:
+        const value_type v_0_;
+        const value_type k_0_;
     };
 }// namespace stg::generators
 
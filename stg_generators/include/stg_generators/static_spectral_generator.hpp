@@ -0,0 +1,145 @@
+#ifndef STG_STATIC_SPECTRAL_GENERATOR_HPP
+#define STG_STATIC_SPECTRAL_GENERATOR_HPP
+
+#include "fourier_modes.hpp"
+#include "i_spectral_generator.hpp"
+#include "phasor_time_stepper.hpp"
+#include "seeded_modes.hpp"
+#include "simd_sincos.hpp"
+#include "spectral_generator.hpp"
+#include "spectras_base.hpp"
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <stg_random/counter_based_engine.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace stg::generators {
+
+    /*
+     * Seeded spectral generator with the spectrum and the engine fixed at compile time.
+     * The spectrum is held by value and called through its final type, the modes of all
+     * spectra are merged into one FourierModes with the weight sqrt(2 / n) and the length
+     * and time scales folded in, so a point costs one non virtual mode sum instead of
+     * a virtual call and a sum per spectrum. The modes are those of SpectralGeneratorV2
+     * created from the same parameters when Engine is random::Philox4x32.
+     * The virtual interface is StaticSpectralGeneratorAdapter
+     */
+    template<typename Spectra, StreamEngine Engine, std::floating_point T>
+        requires std::derived_from<Spectra, ISpectra<T>> && std::is_final_v<Spectra>
+    class StaticSpectralGenerator final {
+    public:
+        using value_type = T;
+        using spectra_type = Spectra;
+        using engine_type = Engine;
+
+        StaticSpectralGenerator(const SpectralParameters<value_type>& parameters, Spectra spectra)
+            : spectra_{std::move(spectra)},
+              spectra_n_{parameters.n_spectra},
+              fourier_modes_n_{parameters.n_fourier},
+              modes_{spectra_n_ * fourier_modes_n_} {
+            if (spectra_n_ < 2 || fourier_modes_n_ == 0) {
+                throw std::invalid_argument("Generator needs at least two spectra and one fourier mode");
+            }
+
+            const ModeDistributions<value_type> distributions{parameters.seed,
+                                                               parameters.ampl_mean, parameters.ampl_std,
+                                                               parameters.wv_mean, parameters.wv_std,
+                                                               parameters.freq_mean, parameters.freq_std};
+            const auto lower_triangular = parameters.reynolds_tensor_.cholesky();
+            const std::array<value_type, 3> diagonal{lower_triangular.get(0, 0), lower_triangular.get(1, 1), lower_triangular.get(2, 2)};
+            const value_type scale_factor = parameters.length_scale / parameters.time_scale;
+            const value_type dk = (parameters.k_max - parameters.k_min) / (spectra_n_ - 1);
+            for (std::size_t spectrum = 0; spectrum < spectra_n_; ++spectrum) {
+                const value_type k_module = parameters.k_min + dk * spectrum;
+                const value_type random_coeff = seeded_random_coefficient<Engine>(distributions, fourier_modes_n_, spectrum);
+                draw_seeded_modes<Engine>(modes_, spectrum * fourier_modes_n_, distributions, fourier_modes_n_, spectrum,
+                                          random_coeff, spectra_(k_module), k_module, scale_factor, diagonal);
+            }
+
+            const auto weight = static_cast<value_type>(std::sqrt(2. / fourier_modes_n_));
+            for (std::size_t index = 0; index < modes_.size(); ++index) {
+                modes_.set_wave_vector(index, modes_.wave_vector(index) / parameters.length_scale);
+                modes_.set_p_vector(index, modes_.p_vector(index) * weight);
+                modes_.set_q_vector(index, modes_.q_vector(index) * weight);
+                modes_.frequencies()[index] /= parameters.time_scale;
+            }
+        }
+
+        std::size_t spectra_n() const noexcept { return spectra_n_; }
+
+        std::size_t fourier_modes_n() const noexcept { return fourier_modes_n_; }
+
+        const Spectra& spectra() const noexcept { return spectra_; }
+
+        // Merged and scaled modes, u(x, t) = modes().sum(x, t)
+        const FourierModes<value_type>& modes() const noexcept { return modes_; }
+
+        Vector<value_type> operator()(const Point<value_type>& point, value_type time) const noexcept {
+            return modes_.sum(point, time, kernel_);
+        }
+
+        void evaluate(std::span<const Point<value_type>> points, value_type time, std::span<Vector<value_type>> out) const {
+            modes_.sum(points, time, out, kernel_);
+        }
+
+        void evaluate_on_grid(const GridAxes<value_type>& axes, std::size_t k_begin, std::size_t k_end, value_type time,
+                              std::span<Vector<value_type>> out) const {
+            if (out.size() != axes.n_vertices(k_begin, k_end)) {
+                throw std::invalid_argument("Output span size is not equal to the number of grid vertices");
+            }
+            modes_.sum_on_grid(axes, k_begin, k_end, time, out);
+        }
+
+        PhasorTimeStepper<value_type> time_stepper(std::vector<Point<value_type>> points, value_type time, value_type time_step,
+                                                   std::size_t memory_budget = PhasorTimeStepper<value_type>::default_memory_budget) const {
+            return {modes_, std::move(points), time, time_step, memory_budget};
+        }
+
+    private:
+        Spectra spectra_;
+        std::size_t spectra_n_;
+        std::size_t fourier_modes_n_;
+        FourierModes<value_type> modes_;
+        simd::SinCosKernel kernel_ = simd::best_sincos_kernel();
+    };
+
+    /*
+     * ISpectralGenerator over a StaticSpectralGenerator, for the code working with
+     * the virtual interface. Only the entry points are virtual
+     */
+    template<typename Generator>
+    class StaticSpectralGeneratorAdapter final : public ISpectralGenerator<typename Generator::value_type> {
+    public:
+        using value_type = typename Generator::value_type;
+
+        explicit StaticSpectralGeneratorAdapter(Generator generator)
+            : generator_{std::move(generator)} {}
+
+        Vector<value_type> operator()(const Point<value_type>& point, value_type time) const override {
+            return generator_(point, time);
+        }
+
+        void evaluate(std::span<const Point<value_type>> points, value_type time, std::span<Vector<value_type>> out) const override {
+            generator_.evaluate(points, time, out);
+        }
+
+        void evaluate_on_grid(const GridAxes<value_type>& axes, std::size_t k_begin, std::size_t k_end, value_type time,
+                              std::span<Vector<value_type>> out) const override {
+            generator_.evaluate_on_grid(axes, k_begin, k_end, time, out);
+        }
+
+        const Generator& generator() const noexcept { return generator_; }
+
+        ~StaticSpectralGeneratorAdapter() override = default;
+
+    private:
+        Generator generator_;
+    };
+}// namespace stg::generators
+
+#endif//STG_STATIC_SPECTRAL_GENERATOR_HPP
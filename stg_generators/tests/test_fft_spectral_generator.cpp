@@ -0,0 +1,120 @@
+#include "common.hpp"
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <mesh_builders.hpp>
+#include <numeric>
+#include <stg_generators/fft_spectral_generator.hpp>
+
+using namespace stg::mesh;
+using namespace Catch::Matchers;
+
+struct FFTSpectralGeneratorFixture {
+    const std::size_t n = 24;
+    // period of the field n * h equals 2 pi, so the wave numbers step is 1
+    const double l = 2 * std::numbers::pi * (n - 1) / n;
+    const double v_0 = 1.;
+    const double k_0 = 4.;
+
+    CubeMeshBuilder<double> builder{l, n};
+    std::shared_ptr<CubeRelationTable<double>> space = builder.build_relation_table();
+    std::shared_ptr<ISpectra<double>> spectra = std::make_shared<GaussianSpectra<double>>(v_0, k_0);
+
+    FFTSpectralGenerator<double> generator{space, spectra, 2};
+
+    static double kinetic_energy(const FFTSpectralGenerator<double>::velocity_components& field) {
+        double energy = 0.;
+        for (std::size_t index = 0; index < field[0].size(); ++index) {
+            energy += field[0][index] * field[0][index] + field[1][index] * field[1][index] + field[2][index] * field[2][index];
+        }
+        return energy / 2 / field[0].size();
+    }
+};
+
+SCENARIO_METHOD(FFTSpectralGeneratorFixture, "Synthesized field is reproducible and has zero mean") {
+    GIVEN("Two realizations with the same seed and one with another seed") {
+        // The cache is process wide, other tests may have planned other shapes
+        FftwPlanCache::instance().clear();
+        const auto field = generator(42);
+        const auto same_seed_field = generator(42);
+        const auto another_field = generator(43);
+
+        THEN("Fields of the same seed are equal") {
+            for (std::size_t component = 0; component < 3; ++component) {
+                REQUIRE(field[component] == same_seed_field[component]);
+            }
+            REQUIRE(field[0] != another_field[0]);
+        }
+
+        THEN("Mean of every component is zero") {
+            for (const auto& values: field) {
+                REQUIRE(values.size() == generator.n_vertices());
+                const double mean = std::accumulate(values.begin(), values.end(), 0.) / values.size();
+                REQUIRE_THAT(mean, WithinAbs(0., 1e-12));
+            }
+        }
+
+        THEN("Plan is created once and reused") {
+            REQUIRE(FftwPlanCache::instance().size() == 1);
+        }
+
+        THEN("A plan held by a user outlives the clear of the cache") {
+            const int side = static_cast<int>(n);
+            const auto plan = FftwPlanCache::instance().c2r_3d({side, side, side}, 2);
+            FftwPlanCache::instance().clear();
+            REQUIRE(FftwPlanCache::instance().size() == 0);
+            REQUIRE(plan.use_count() == 1);
+            REQUIRE(generator(42)[0] == field[0]);
+        }
+    }
+}
+
+SCENARIO_METHOD(FFTSpectralGeneratorFixture, "Synthesized field is divergence free") {
+    GIVEN("Realization and its forward fourier image") {
+        const auto field = generator(7);
+        const std::size_t half = n / 2 + 1;
+        const int size = static_cast<int>(n);
+
+        std::array<std::vector<std::array<double, 2>>, 3> images;
+        for (std::size_t component = 0; component < 3; ++component) {
+            std::vector<double> values = field[component];
+            images[component].resize(n * n * half);
+            auto* output = reinterpret_cast<fftw_complex*>(images[component].data());
+            fftw_plan plan = fftw_plan_dft_r2c_3d(size, size, size, values.data(), output, FFTW_ESTIMATE);
+            fftw_execute(plan);
+            fftw_destroy_plan(plan);
+        }
+
+        THEN("Every wave vector is orthogonal to the velocity image") {
+            const auto wave_number = [&](std::size_t index) {
+                return index <= n / 2 ? static_cast<double>(index) : static_cast<double>(index) - n;
+            };
+            for (std::size_t c = 0; c < n; ++c) {
+                for (std::size_t b = 0; b < n; ++b) {
+                    for (std::size_t a = 0; a < half; ++a) {
+                        const std::size_t index = (c * n + b) * half + a;
+                        for (std::size_t part = 0; part < 2; ++part) {
+                            const double divergence = wave_number(a) * images[0][index][part]
+                                                      + wave_number(b) * images[1][index][part]
+                                                      + wave_number(c) * images[2][index][part];
+                            REQUIRE_THAT(divergence, WithinAbs(0., 1e-8));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(FFTSpectralGeneratorFixture, "Kinetic energy of synthesized field follows the spectrum") {
+    GIVEN("Gaussian spectrum with the energy 3 / 2 v_0^2") {
+        double energy = 0.;
+        const std::size_t realizations = 4;
+        for (std::size_t seed = 0; seed < realizations; ++seed) {
+            energy += kinetic_energy(generator(seed));
+        }
+        energy /= realizations;
+
+        THEN("Mean kinetic energy is close to the integral of the spectrum") {
+            REQUIRE_THAT(energy, WithinRel(1.5 * v_0 * v_0, 0.1));
+        }
+    }
+}
@@ -0,0 +1,176 @@
+#include "common.hpp"
+#include <cmath>
+#include <random>
+
+struct FourierModesFixture {
+    static constexpr std::size_t modes_n = 1001;
+
+    FourierModesFixture() : modes{modes_n} {
+        std::mt19937_64 engine{seed};
+        std::normal_distribution<double> distribution{0., 1.};
+        const auto random_vector = [&](double scale) {
+            return Vector<double>{scale * distribution(engine), scale * distribution(engine), scale * distribution(engine)};
+        };
+        for (const std::size_t index: ranges::views::iota(0ul, modes_n)) {
+            modes.set_wave_vector(index, random_vector(30.));
+            modes.set_p_vector(index, random_vector(1.));
+            modes.set_q_vector(index, random_vector(1.));
+            modes.frequencies()[index] = distribution(engine);
+        }
+    }
+
+    Vector<double> reference_sum(const Point<double>& point, double time) const {
+        Vector<double> result{0., 0., 0.};
+        for (const std::size_t index: ranges::views::iota(0ul, modes_n)) {
+            const auto phase = dot_product(modes.wave_vector(index), point) + modes.frequencies()[index] * time;
+            result += modes.p_vector(index) * std::cos(phase) + modes.q_vector(index) * std::sin(phase);
+        }
+        return result;
+    }
+
+    FourierModes<double> modes;
+};
+
+SCENARIO("Polynomial sincos kernel matches std::sin and std::cos within 2 ULP") {
+    GIVEN("Phases spread over several thousands of periods") {
+        std::mt19937_64 engine{seed};
+        std::uniform_real_distribution<double> distribution{-5000., 5000.};
+
+        THEN("Every value differs from the std one by at most 2 ULP") {
+            for (std::size_t i = 0; i < 100000; ++i) {
+                const double phase = distribution(engine);
+                double sin_value, cos_value;
+                simd::sincos(phase, sin_value, cos_value);
+                const double sin_ulp = std::nextafter(std::fabs(std::sin(phase)), INFINITY) - std::fabs(std::sin(phase));
+                const double cos_ulp = std::nextafter(std::fabs(std::cos(phase)), INFINITY) - std::fabs(std::cos(phase));
+                REQUIRE(std::fabs(sin_value - std::sin(phase)) <= 2 * sin_ulp);
+                REQUIRE(std::fabs(cos_value - std::cos(phase)) <= 2 * cos_ulp);
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(FourierModesFixture, "Every available sum kernel agrees with the sequential std::sin/std::cos sum") {
+    GIVEN("Random modes, the number of modes is not a multiple of simd lanes") {
+        const Point<double> point{1.7, -4.2, 8.9};
+        const double time = 0.35;
+        const auto expected = reference_sum(point, time);
+        const double tolerance = 1e-11;
+
+        for (const auto kernel: {simd::SinCosKernel::scalar, simd::SinCosKernel::avx2, simd::SinCosKernel::avx512}) {
+            if (!simd::is_supported(kernel)) {
+                continue;
+            }
+            DYNAMIC_SECTION("Sum is calculated with kernel " << static_cast<int>(kernel)) {
+                const auto result = modes.sum(point, time, kernel);
+                THEN("Result matches the reference") {
+                    using Catch::Matchers::WithinAbs;
+                    REQUIRE_THAT(result.get<0>(), WithinAbs(expected.get<0>(), tolerance));
+                    REQUIRE_THAT(result.get<1>(), WithinAbs(expected.get<1>(), tolerance));
+                    REQUIRE_THAT(result.get<2>(), WithinAbs(expected.get<2>(), tolerance));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(FourierModesFixture, "Batched sum over points matches the pointwise sum") {
+    GIVEN("Number of points which is not a multiple of the points tile") {
+        std::mt19937_64 engine{seed};
+        std::uniform_real_distribution<double> distribution{-10., 10.};
+        std::vector<Point<double>> points(simd::points_tile * 3 + 5);
+        for (auto& point: points) {
+            point = {distribution(engine), distribution(engine), distribution(engine)};
+        }
+
+        WHEN("Velocities are evaluated with one batched call") {
+            std::vector<Vector<double>> velocities(points.size());
+            modes.sum(points, 0.5, velocities);
+
+            THEN("Every value equals the one of the single point call") {
+                using Catch::Matchers::WithinAbs;
+                for (const std::size_t index: ranges::views::iota(0ul, points.size())) {
+                    const auto expected = modes.sum(points[index], 0.5);
+                    REQUIRE_THAT(velocities[index].get<0>(), WithinAbs(expected.get<0>(), 1e-11));
+                    REQUIRE_THAT(velocities[index].get<1>(), WithinAbs(expected.get<1>(), 1e-11));
+                    REQUIRE_THAT(velocities[index].get<2>(), WithinAbs(expected.get<2>(), 1e-11));
+                }
+            }
+        }
+
+        WHEN("Output span has another length") {
+            std::vector<Vector<double>> velocities(points.size() - 1);
+            THEN("Exception is thrown") {
+                REQUIRE_THROWS_AS(modes.sum(points, 0.5, velocities), std::invalid_argument);
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(FourierModesFixture, "Grid sum with per-axis phase tables matches the pointwise sum") {
+    GIVEN("Rectilinear grid with different axes") {
+        const std::vector<double> x{-2., -1., 0., 1.5, 2., 3., 4., 5.5, 6., 7., 8.};
+        const std::vector<double> y{-1., 0., 1., 2., 3.};
+        const std::vector<double> z{0., 0.25, 0.5, 0.75, 1., 1.25, 1.5};
+        const GridAxes<double> axes{x, y, z};
+        const double time = 1.25;
+
+        WHEN("Velocities are evaluated on the layers 2 <= k < 6") {
+            std::vector<Vector<double>> velocities(axes.n_vertices(2, 6));
+            modes.sum_on_grid(axes, 2, 6, time, velocities);
+
+            THEN("Every vertex value equals the one of the single point call") {
+                using Catch::Matchers::WithinAbs;
+                for (const std::size_t k: ranges::views::iota(2ul, 6ul)) {
+                    for (const std::size_t j: ranges::views::iota(0ul, y.size())) {
+                        for (const std::size_t i: ranges::views::iota(0ul, x.size())) {
+                            const auto expected = modes.sum(Point<double>{x[i], y[j], z[k]}, time);
+                            const auto& value = velocities[i + j * x.size() + (k - 2) * x.size() * y.size()];
+                            REQUIRE_THAT(value.get<0>(), WithinAbs(expected.get<0>(), 1e-10));
+                            REQUIRE_THAT(value.get<1>(), WithinAbs(expected.get<1>(), 1e-10));
+                            REQUIRE_THAT(value.get<2>(), WithinAbs(expected.get<2>(), 1e-10));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(FourierModesFixture, "Mixed precision float kernels follow the double sum") {
+    GIVEN("The modes rounded to float") {
+        FourierModes<float> float_modes{modes_n};
+        double amplitudes = 0.;
+        for (const std::size_t index: ranges::views::iota(0ul, modes_n)) {
+            const auto narrow = [](const Vector<double>& vector) {
+                return Vector<float>{static_cast<float>(vector.get<0>()), static_cast<float>(vector.get<1>()), static_cast<float>(vector.get<2>())};
+            };
+            float_modes.set_wave_vector(index, narrow(modes.wave_vector(index)));
+            float_modes.set_p_vector(index, narrow(modes.p_vector(index)));
+            float_modes.set_q_vector(index, narrow(modes.q_vector(index)));
+            float_modes.frequencies()[index] = static_cast<float>(modes.frequencies()[index]);
+            amplitudes += std::sqrt(dot_product(modes.p_vector(index), modes.p_vector(index))) +
+                          std::sqrt(dot_product(modes.q_vector(index), modes.q_vector(index)));
+        }
+        const Point<double> point{1.7, -4.2, 8.9};
+        const double time = 0.35;
+        const auto expected = reference_sum(point, time);
+        // float phases of |k| |x| ~ 300 are rounded by ~ 300 * 2^-24 each
+        const double tolerance = 1e-6 * amplitudes;
+
+        for (const auto kernel: {simd::SinCosKernel::scalar, simd::SinCosKernel::avx2, simd::SinCosKernel::avx512}) {
+            if (!simd::is_supported(kernel)) {
+                continue;
+            }
+            DYNAMIC_SECTION("Sum is calculated with kernel " << static_cast<int>(kernel)) {
+                const auto result = float_modes.sum({1.7f, -4.2f, 8.9f}, 0.35f, kernel);
+                THEN("Result matches the double reference within the float accuracy") {
+                    using Catch::Matchers::WithinAbs;
+                    REQUIRE_THAT(result.get<0>(), WithinAbs(expected.get<0>(), tolerance));
+                    REQUIRE_THAT(result.get<1>(), WithinAbs(expected.get<1>(), tolerance));
+                    REQUIRE_THAT(result.get<2>(), WithinAbs(expected.get<2>(), tolerance));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include "common.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+struct PhasorTimeStepperFixture {
+    static constexpr std::size_t modes_n = 203;
+    static constexpr std::size_t points_n = 40;
+
+    PhasorTimeStepperFixture() : modes{modes_n}, points(points_n) {
+        std::mt19937_64 engine{seed};
+        std::normal_distribution<double> distribution{0., 1.};
+        const auto random_vector = [&](double scale) {
+            return Vector<double>{scale * distribution(engine), scale * distribution(engine), scale * distribution(engine)};
+        };
+        for (const std::size_t index: ranges::views::iota(0ul, modes_n)) {
+            modes.set_wave_vector(index, random_vector(5.));
+            modes.set_p_vector(index, random_vector(1.));
+            modes.set_q_vector(index, random_vector(1.));
+            modes.frequencies()[index] = 3. * distribution(engine);
+        }
+        for (auto& point: points) {
+            point = random_vector(2.);
+        }
+    }
+
+    FourierModes<double> modes;
+    std::vector<Point<double>> points;
+};
+
+SCENARIO_METHOD(PhasorTimeStepperFixture, "Phasor time stepper follows the direct mode sum") {
+    GIVEN("Stepper whose memory budget holds phasors of half of the points") {
+        const double start_time = 0.5, time_step = 1e-3;
+        const std::size_t budget = points_n / 2 * 2 * sizeof(double) * modes.arrays().n;
+        PhasorTimeStepper<double> stepper{modes, points, start_time, time_step, budget, 16};
+        REQUIRE(stepper.cached_points() == points_n / 2);
+
+        WHEN("Thousands of steps are made") {
+            std::vector<Vector<double>> velocities(points_n);
+            std::vector<Vector<double>> expected(points_n);
+            double max_error = 0.;
+            for (const std::size_t step: ranges::views::iota(0ul, 5000ul)) {
+                const double time = stepper.time();
+                stepper.step(velocities);
+                if (step % 1000 != 999) {
+                    continue;
+                }
+                modes.sum(points, time, expected);
+                for (const std::size_t index: ranges::views::iota(0ul, points_n)) {
+                    max_error = std::max({max_error,
+                                          std::fabs(velocities[index].get<0>() - expected[index].get<0>()),
+                                          std::fabs(velocities[index].get<1>() - expected[index].get<1>()),
+                                          std::fabs(velocities[index].get<2>() - expected[index].get<2>())});
+                }
+            }
+
+            THEN("Every point matches the direct sum at the same time") {
+                REQUIRE(stepper.steps() == 5000);
+                REQUIRE(max_error < 1e-9);
+            }
+        }
+
+        WHEN("Output span has another length") {
+            std::vector<Vector<double>> velocities(points_n + 1);
+            THEN("Exception is thrown") {
+                REQUIRE_THROWS_AS(stepper.step(velocities), std::invalid_argument);
+            }
+        }
+    }
+}
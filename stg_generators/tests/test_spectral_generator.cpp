@@ -29,4 +29,38 @@ SCENARIO_METHOD(SpectralGeneratorFixture, "Smirnov generator tests with default
         SpectralGenerator<double, seed> spectral_generator{std::move(config)};
         // const auto generated_value = spectral_generator({0, 0, 0}, 0);
     }
-}
\ No newline at end of file
+}
+SCENARIO("Seeded spectral generator is reproducible") {
+    GIVEN("Two generators created from the same parameters") {
+        SpectralParameters<double> parameters;
+        parameters.n_spectra = 20;
+        parameters.n_fourier = 50;
+
+        const auto make_generator = [&parameters] {
+            SpectralGeneratorV2<double> generator{parameters};
+            generator.initialize_wave_vector_amplitudes(parameters.k_min, parameters.k_max, parameters.n_spectra);
+            generator.initialize_random_coefficients();
+            generator.initialize_spectra(std::make_shared<VonKarmanSpectra<double>>(1, 100, 40));
+            generator.initialize_inner_generators();
+            return generator;
+        };
+        const auto first = make_generator();
+        const auto second = make_generator();
+
+        THEN("Generated velocities are equal bit by bit") {
+            for (const Point<double>& point: {Point<double>{0., 0., 0.}, Point<double>{1.5, -2., 0.25}}) {
+                const auto first_value = first(point, 0.5);
+                const auto second_value = second(point, 0.5);
+                REQUIRE(first_value.get<0>() == second_value.get<0>());
+                REQUIRE(first_value.get<1>() == second_value.get<1>());
+                REQUIRE(first_value.get<2>() == second_value.get<2>());
+            }
+        }
+
+        THEN("Another seed gives another field") {
+            parameters.seed += 1;
+            const auto other = make_generator();
+            REQUIRE(first({1.5, -2., 0.25}, 0.5).get<0>() != other({1.5, -2., 0.25}, 0.5).get<0>());
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#include "common.hpp"
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cmath>
+#include <random>
+
+struct StaticSpectralGeneratorFixture {
+    using Static = StaticSpectralGenerator<VonKarmanSpectra<double>, random::Philox4x32, double>;
+
+    StaticSpectralGeneratorFixture() : points(points_n) {
+        parameters.n_spectra = 20;
+        parameters.n_fourier = 50;
+        parameters.length_scale = 2.;
+        parameters.time_scale = 0.5;
+
+        std::mt19937_64 engine{seed};
+        std::uniform_real_distribution<double> distribution{-2., 2.};
+        for (auto& point: points) {
+            point = {distribution(engine), distribution(engine), distribution(engine)};
+        }
+    }
+
+    static constexpr std::size_t points_n = 256;
+    SpectralParameters<double> parameters;
+    std::vector<Point<double>> points;
+
+    SpectralGeneratorV2<double> make_virtual_generator() const {
+        SpectralGeneratorV2<double> generator{parameters};
+        generator.initialize_spectra(std::make_shared<VonKarmanSpectra<double>>(1., 50., 40.));
+        generator.initialize_wave_vector_amplitudes(parameters.k_min, parameters.k_max, parameters.n_spectra);
+        generator.initialize_random_coefficients();
+        generator.initialize_inner_generators();
+        return generator;
+    }
+
+    Static make_static_generator() const {
+        return {parameters, VonKarmanSpectra<double>{1., 50., 40.}};
+    }
+
+    // Max difference of the components relative to the max component of expected
+    static double relative_difference(std::span<const Vector<double>> values, std::span<const Vector<double>> expected) {
+        double difference = 0., scale = 0.;
+        for (std::size_t index = 0; index < values.size(); ++index) {
+            difference = std::max({difference,
+                                   std::fabs(values[index].get<0>() - expected[index].get<0>()),
+                                   std::fabs(values[index].get<1>() - expected[index].get<1>()),
+                                   std::fabs(values[index].get<2>() - expected[index].get<2>())});
+            scale = std::max({scale,
+                              std::fabs(expected[index].get<0>()),
+                              std::fabs(expected[index].get<1>()),
+                              std::fabs(expected[index].get<2>())});
+        }
+        return difference / scale;
+    }
+};
+
+SCENARIO_METHOD(StaticSpectralGeneratorFixture, "Static spectral generator reproduces the virtual one") {
+    GIVEN("Virtual and static generators of the same seed") {
+        const auto virtual_generator = make_virtual_generator();
+        const auto static_generator = make_static_generator();
+        REQUIRE(static_generator.modes().size() == parameters.n_spectra * parameters.n_fourier);
+
+        std::vector<Vector<double>> expected(points_n), velocities(points_n);
+        virtual_generator.evaluate(points, 0.3, expected);
+
+        THEN("Velocities agree up to rounding of the folded scales") {
+            static_generator.evaluate(points, 0.3, velocities);
+            REQUIRE(relative_difference(velocities, expected) < 1e-10);
+
+            const auto single = static_generator(points.front(), 0.3);
+            REQUIRE_THAT(single.get<0>(), Catch::Matchers::WithinRel(expected.front().get<0>(), 1e-10));
+        }
+
+        THEN("Adapter gives the same velocities through the virtual interface") {
+            const StaticSpectralGeneratorAdapter adapter{static_generator};
+            const ISpectralGenerator<double>& generator = adapter;
+            generator.evaluate(points, 0.3, velocities);
+            REQUIRE(relative_difference(velocities, expected) < 1e-10);
+        }
+    }
+
+    GIVEN("Parameters without fourier modes") {
+        parameters.n_fourier = 0;
+        THEN("Construction fails") {
+            REQUIRE_THROWS_AS(make_static_generator(), std::invalid_argument);
+        }
+    }
+}
+
+SCENARIO_METHOD(StaticSpectralGeneratorFixture, "Static and virtual spectral generators benchmark", "[.][benchmark]") {
+    const auto virtual_generator = make_virtual_generator();
+    const auto static_generator = make_static_generator();
+    const ISpectralGenerator<double>& generator = virtual_generator;
+    std::vector<Vector<double>> velocities(points_n);
+
+    BENCHMARK("Virtual generator, point by point") {
+        for (std::size_t index = 0; index < points_n; ++index) {
+            velocities[index] = generator(points[index], 0.3);
+        }
+        return velocities.back().get<0>();
+    };
+
+    BENCHMARK("Static generator, point by point") {
+        for (std::size_t index = 0; index < points_n; ++index) {
+            velocities[index] = static_generator(points[index], 0.3);
+        }
+        return velocities.back().get<0>();
+    };
+
+    BENCHMARK("Virtual generator, batched") {
+        generator.evaluate(points, 0.3, velocities);
+        return velocities.back().get<0>();
+    };
+
+    BENCHMARK("Static generator, batched") {
+        static_generator.evaluate(points, 0.3, velocities);
+        return velocities.back().get<0>();
+    };
+}
@@ -72,8 +72,9 @@ namespace stg::tensor {
             const value_type a_31 = values_[6] / a_11;
             const value_type a_32 = (values_[7] - a_31 * a_21) / a_22;
             const value_type a_33 = std::sqrt(values_[8] - a_31 * a_31 - a_32 * a_32);
-            return Tensor{std::array{a_11, 0., 0.,
-                                     a_21, a_22, 0.,
+            constexpr value_type zero{0};
+            return Tensor{std::array{a_11, zero, zero,
+                                     a_21, a_22, zero,
                                      a_31, a_32, a_33}};
         }
 
@@ -2,5 +2,7 @@
 #define STG_UTILITY_COROUTINE_FUTURE_BASED_HPP
 
 #include "stg_coro_future/coroutine_future.hpp"
+#include "stg_coro_future/task.hpp"
+#include "stg_coro_future/when_all.hpp"
 
-#endif
\ No newline at end of file
+#endif
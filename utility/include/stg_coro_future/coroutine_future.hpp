@@ -1,11 +1,18 @@
 #ifndef STG_UTILITY_FUTURE_COROUTINE_HPP
 #define STG_UTILITY_FUTURE_COROUTINE_HPP
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <coroutine>
 #include <exception>
+#include <functional>
 #include <future>
+#include <mutex>
+#include <stg_thread_pool/stg_thread_pool.hpp>
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 /*
 
@@ -22,6 +29,9 @@
             co_return main_result
         }
 
+    The awaited future is waited for on the shared thread pool, for the pipelines
+    without std::future at all see task.hpp
+
 */
 
 struct as_coroutine {};
@@ -34,7 +44,7 @@ namespace {
 
 namespace std {
     template<FutureTypeConcept T, typename... Args>
-    struct std::coroutine_traits<std::future<T>, as_coroutine, Args...> {
+    struct coroutine_traits<std::future<T>, as_coroutine, Args...> {
         struct promise_type : std::promise<T> {
             std::future<T> get_return_object() { return this->get_future(); }
             std::suspend_never initial_suspend() noexcept { return {}; }
@@ -53,7 +63,7 @@ namespace std {
 
     // std::future<void>
     template<typename... Args>
-    struct std::coroutine_traits<std::future<void>, as_coroutine, Args...> {
+    struct coroutine_traits<std::future<void>, as_coroutine, Args...> {
         struct promise_type : std::promise<void> {
             std::future<void> get_return_object() { return this->get_future(); }
             std::suspend_never initial_suspend() noexcept { return {}; }
@@ -66,7 +76,98 @@ namespace std {
 }// namespace std
 
 namespace stg::utils {
-    // future awaiter
+    namespace detail {
+        /*
+         * One process wide thread serving all the awaited futures. A future can't notify, so
+         * the pending ones are polled with wait_for(0), the poll interval grows while nothing
+         * gets ready. Every ready continuation is posted to the global pool
+         */
+        class FutureWaiter final {
+        public:
+            static FutureWaiter& instance() {
+                static FutureWaiter waiter;
+                return waiter;
+            }
+
+            FutureWaiter(const FutureWaiter&) = delete;
+            FutureWaiter& operator=(const FutureWaiter&) = delete;
+
+            ~FutureWaiter() {
+                {
+                    std::lock_guard lock{mutex_};
+                    stop_ = true;
+                }
+                wake_.notify_one();
+                thread_.join();
+            }
+
+            void add(std::function<bool()> ready, std::coroutine_handle<> continuation) {
+                {
+                    std::lock_guard lock{mutex_};
+                    pending_.push_back({std::move(ready), continuation});
+                    interval_ = min_interval;
+                }
+                wake_.notify_one();
+            }
+
+        private:
+            static constexpr std::chrono::microseconds min_interval{50};
+            static constexpr std::chrono::microseconds max_interval{2000};
+
+            struct Pending {
+                std::function<bool()> ready;
+                std::coroutine_handle<> continuation;
+            };
+
+            // The pool is created first, so it outlives the waiter
+            utility::ThreadPool& pool_ = utility::ThreadPool::global();
+            std::mutex mutex_;
+            std::condition_variable wake_;
+            std::vector<Pending> pending_;
+            std::chrono::microseconds interval_ = min_interval;
+            bool stop_ = false;
+            std::thread thread_{[this] { run(); }};
+
+            FutureWaiter() = default;
+
+            void run() {
+                std::vector<std::coroutine_handle<>> ready;
+                std::unique_lock lock{mutex_};
+                while (true) {
+                    wake_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+                    if (stop_) {
+                        return;
+                    }
+                    std::erase_if(pending_, [&ready](const Pending& pending) {
+                        if (!pending.ready()) {
+                            return false;
+                        }
+                        ready.push_back(pending.continuation);
+                        return true;
+                    });
+                    if (!ready.empty()) {
+                        interval_ = min_interval;
+                        lock.unlock();
+                        for (const auto continuation: ready) {
+                            pool_.post([continuation] { continuation.resume(); });
+                        }
+                        ready.clear();
+                        lock.lock();
+                    } else if (!pending_.empty()) {
+                        const auto interval = interval_;
+                        interval_ = std::min(2 * interval_, max_interval);
+                        wake_.wait_for(lock, interval);
+                    }
+                }
+            }
+        };
+    }// namespace detail
+
+    /*
+     * future awaiter, resumes the coroutine on a thread of the global pool once the future
+     * is ready. The future is polled by the shared detail::FutureWaiter thread: no pool worker
+     * and no thread per future is held by the wait
+     */
     template<typename T>
     struct future_awaiter final : public std::future<T> {
         bool await_ready() noexcept {
@@ -77,10 +178,9 @@ namespace stg::utils {
             return this->get();
         }
         void await_suspend(std::coroutine_handle<> coro_handle) {
-            std::thread([this, coro_handle] {
-                this->wait();
-                coro_handle();
-            }).detach();
+            detail::FutureWaiter::instance().add(
+                    [this] { return this->wait_for(std::chrono::seconds{0}) != std::future_status::timeout; },
+                    coro_handle);
         }
     };
 }// namespace stg::utils
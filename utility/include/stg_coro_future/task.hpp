@@ -0,0 +1,334 @@
+#ifndef STG_UTILITY_CORO_TASK_HPP
+#define STG_UTILITY_CORO_TASK_HPP
+
+#include <stg_thread_pool/stg_thread_pool.hpp>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/*
+
+    Lazy coroutine task on the thread pool
+
+    usage:
+
+        task<Field> load(std::string path) {
+            co_await schedule_on(pool);          // continue on a pool thread
+            co_return read_field(path);
+        }
+
+        task<Statistics> pipeline() {
+            auto [first, second] = co_await when_all(load("first.vtk"), load("second.vtk"));
+            co_return compute_statistics(first, second);
+        }
+
+        auto statistics = sync_wait(pipeline());
+
+    A task starts when it is awaited, a finished task resumes its awaiter directly
+    (symmetric transfer), so a chain of co_await costs neither a thread nor stack
+    depth. The threads are switched only by schedule_on
+
+*/
+
+namespace stg::utility {
+
+    template<typename T = void>
+    class task;
+
+    namespace detail {
+        class TaskPromiseBase {
+        public:
+            struct FinalAwaiter final {
+                bool await_ready() const noexcept { return false; }
+
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> coroutine) noexcept {
+                    return coroutine.promise().continuation_;
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+
+            void set_continuation(std::coroutine_handle<> continuation) noexcept {
+                continuation_ = continuation;
+            }
+
+        private:
+            std::coroutine_handle<> continuation_ = std::noop_coroutine();
+        };
+
+        template<typename T>
+        class TaskPromise final : public TaskPromiseBase {
+        public:
+            task<T> get_return_object() noexcept;
+
+            template<std::convertible_to<T> U>
+            void return_value(U&& value) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
+                result_.template emplace<1>(std::forward<U>(value));
+            }
+
+            void unhandled_exception() noexcept {
+                result_.template emplace<2>(std::current_exception());
+            }
+
+            T result() {
+                if (result_.index() == 2) {
+                    std::rethrow_exception(std::get<2>(result_));
+                }
+                return std::move(std::get<1>(result_));
+            }
+
+        private:
+            std::variant<std::monostate, T, std::exception_ptr> result_;
+        };
+
+        template<>
+        class TaskPromise<void> final : public TaskPromiseBase {
+        public:
+            task<void> get_return_object() noexcept;
+
+            void return_void() const noexcept {}
+
+            void unhandled_exception() noexcept {
+                exception_ = std::current_exception();
+            }
+
+            void result() const {
+                if (exception_) {
+                    std::rethrow_exception(exception_);
+                }
+            }
+
+        private:
+            std::exception_ptr exception_;
+        };
+    }// namespace detail
+
+    /*
+     * Lazily started coroutine returning T, the result or the exception of the
+     * coroutine is handed over by co_await. Owns the coroutine frame
+     */
+    template<typename T>
+    class [[nodiscard]] task final {
+    public:
+        using promise_type = detail::TaskPromise<T>;
+        using value_type = T;
+
+        task() noexcept = default;
+
+        explicit task(std::coroutine_handle<promise_type> coroutine) noexcept
+            : coroutine_{coroutine} {}
+
+        task(task&& other) noexcept
+            : coroutine_{std::exchange(other.coroutine_, nullptr)} {}
+
+        task& operator=(task&& other) noexcept {
+            if (this != &other) {
+                destroy();
+                coroutine_ = std::exchange(other.coroutine_, nullptr);
+            }
+            return *this;
+        }
+
+        task(const task&) = delete;
+        task& operator=(const task&) = delete;
+
+        ~task() { destroy(); }
+
+        [[nodiscard]] bool done() const noexcept {
+            return !coroutine_ || coroutine_.done();
+        }
+
+        auto operator co_await() && noexcept {
+            struct Awaiter final : ReadyAwaiter {
+                T await_resume() { return this->coroutine_.promise().result(); }
+            };
+            return Awaiter{{coroutine_}};
+        }
+
+        /*
+         * Awaits completion without taking the result, used by the combinators
+         * which take the result afterwards with result()
+         */
+        auto when_ready() noexcept {
+            return ReadyAwaiter{coroutine_};
+        }
+
+        // The result of the finished task, rethrows its exception
+        T result() {
+            return coroutine_.promise().result();
+        }
+
+    private:
+        struct ReadyAwaiter {
+            std::coroutine_handle<promise_type> coroutine_;
+
+            bool await_ready() const noexcept { return !coroutine_ || coroutine_.done(); }
+
+            // Starts the task, the task resumes the awaiter once it finishes
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+                coroutine_.promise().set_continuation(awaiter);
+                return coroutine_;
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        std::coroutine_handle<promise_type> coroutine_ = nullptr;
+
+        void destroy() noexcept {
+            if (coroutine_) {
+                coroutine_.destroy();
+            }
+        }
+    };
+
+    template<typename T>
+    task<T> detail::TaskPromise<T>::get_return_object() noexcept {
+        return task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+    }
+
+    inline task<void> detail::TaskPromise<void>::get_return_object() noexcept {
+        return task<void>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+    }
+
+    // co_await schedule_on(pool) continues the coroutine on a thread of the pool
+    class ScheduleAwaiter final {
+    public:
+        explicit ScheduleAwaiter(ThreadPool& pool) noexcept
+            : pool_{pool} {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> coroutine) {
+            pool_.post([coroutine] { coroutine.resume(); });
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        ThreadPool& pool_;
+    };
+
+    inline ScheduleAwaiter schedule_on(ThreadPool& pool = ThreadPool::global()) noexcept {
+        return ScheduleAwaiter{pool};
+    }
+
+    // Task running function on the pool, the awaiter continues on that pool thread
+    template<std::invocable Function>
+    task<std::invoke_result_t<Function>> async(Function function, ThreadPool& pool = ThreadPool::global()) {
+        co_await schedule_on(pool);
+        co_return function();
+    }
+
+    namespace detail {
+        /*
+         * Eagerly owned coroutine awaiting a task for a combinator, notifies the
+         * combinator's latch when the task is finished. The latch returns the
+         * coroutine to continue with
+         */
+        template<typename Latch>
+        class LatchedJob final {
+        public:
+            struct promise_type final {
+                Latch* latch = nullptr;
+
+                LatchedJob get_return_object() noexcept {
+                    return LatchedJob{std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+
+                std::suspend_always initial_suspend() const noexcept { return {}; }
+
+                auto final_suspend() const noexcept {
+                    struct Notify final {
+                        bool await_ready() const noexcept { return false; }
+                        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept {
+                            return coroutine.promise().latch->notify();
+                        }
+                        void await_resume() const noexcept {}
+                    };
+                    return Notify{};
+                }
+
+                void return_void() const noexcept {}
+
+                // The awaited tasks keep their exceptions to themselves
+                void unhandled_exception() const noexcept { std::terminate(); }
+            };
+
+            explicit LatchedJob(std::coroutine_handle<promise_type> coroutine) noexcept
+                : coroutine_{coroutine} {}
+
+            LatchedJob(LatchedJob&& other) noexcept
+                : coroutine_{std::exchange(other.coroutine_, nullptr)} {}
+
+            LatchedJob(const LatchedJob&) = delete;
+            LatchedJob& operator=(const LatchedJob&) = delete;
+            LatchedJob& operator=(LatchedJob&&) = delete;
+
+            ~LatchedJob() {
+                if (coroutine_) {
+                    coroutine_.destroy();
+                }
+            }
+
+            void start(Latch& latch) {
+                coroutine_.promise().latch = &latch;
+                coroutine_.resume();
+            }
+
+        private:
+            std::coroutine_handle<promise_type> coroutine_;
+        };
+
+        template<typename Latch, typename T>
+        LatchedJob<Latch> make_latched_job(task<T>& awaited) {
+            co_await awaited.when_ready();
+        }
+
+        // Blocks the waiting thread, notified under the lock so it can't be gone mid notify
+        class SyncWaitEvent final {
+        public:
+            std::coroutine_handle<> notify() noexcept {
+                std::lock_guard lock{mutex_};
+                ready_ = true;
+                ready_condition_.notify_all();
+                return std::noop_coroutine();
+            }
+
+            void wait() {
+                std::unique_lock lock{mutex_};
+                ready_condition_.wait(lock, [this] { return ready_; });
+            }
+
+        private:
+            std::mutex mutex_;
+            std::condition_variable ready_condition_;
+            bool ready_ = false;
+        };
+    }// namespace detail
+
+    /*
+     * Runs the task and blocks the calling thread until it's finished, the bridge from
+     * the synchronous code. Must not be called from the pool threads, await there
+     */
+    template<typename T>
+    T sync_wait(task<T> awaited) {
+        detail::SyncWaitEvent event;
+        auto job = detail::make_latched_job<detail::SyncWaitEvent>(awaited);
+        job.start(event);
+        event.wait();
+        return awaited.result();
+    }
+}// namespace stg::utility
+
+#endif
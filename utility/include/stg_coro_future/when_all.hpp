@@ -0,0 +1,125 @@
+#ifndef STG_UTILITY_CORO_WHEN_ALL_HPP
+#define STG_UTILITY_CORO_WHEN_ALL_HPP
+
+#include "task.hpp"
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace stg::utility {
+
+    namespace detail {
+        /*
+         * Counts the finished tasks of when_all, the awaiting coroutine holds one more count
+         * while it starts the tasks. Whoever counts down last continues the awaiting coroutine
+         */
+        class WhenAllLatch final {
+        public:
+            explicit WhenAllLatch(std::size_t tasks) noexcept
+                : count_{tasks + 1} {}
+
+            std::coroutine_handle<> notify() noexcept {
+                if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    return awaiting_;
+                }
+                return std::noop_coroutine();
+            }
+
+            // False if all the tasks are already finished and the awaiting coroutine goes on
+            bool try_await(std::coroutine_handle<> awaiting) noexcept {
+                awaiting_ = awaiting;
+                return count_.fetch_sub(1, std::memory_order_acq_rel) > 1;
+            }
+
+        private:
+            std::atomic<std::size_t> count_;
+            std::coroutine_handle<> awaiting_;
+        };
+
+        template<typename Jobs>
+        class WhenAllAwaiter final {
+        public:
+            WhenAllAwaiter(WhenAllLatch& latch, Jobs& jobs) noexcept
+                : latch_{latch}, jobs_{jobs} {}
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> awaiting) {
+                if constexpr (requires { jobs_.begin(); }) {
+                    for (auto& job: jobs_) {
+                        job.start(latch_);
+                    }
+                } else {
+                    std::apply([this](auto&... jobs) { (jobs.start(latch_), ...); }, jobs_);
+                }
+                return latch_.try_await(awaiting);
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            WhenAllLatch& latch_;
+            Jobs& jobs_;
+        };
+
+        template<typename T>
+        using WhenAllValue = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        template<typename T>
+        WhenAllValue<T> when_all_result(task<T>& finished) {
+            if constexpr (std::is_void_v<T>) {
+                finished.result();
+                return {};
+            } else {
+                return finished.result();
+            }
+        }
+    }// namespace detail
+
+    /*
+     * Awaits all the tasks and gives their results as a tuple, void results are std::monostate.
+     * The tasks are started one after another on the awaiting thread and run concurrently from
+     * their first suspension on, so the tasks meant to run in parallel begin with schedule_on
+     * (or are made with async). The first exception in the order of the tasks is rethrown after
+     * all of them are finished
+     */
+    template<typename... Ts>
+    task<std::tuple<detail::WhenAllValue<Ts>...>> when_all(task<Ts>... tasks) {
+        detail::WhenAllLatch latch{sizeof...(Ts)};
+        auto jobs = std::make_tuple(detail::make_latched_job<detail::WhenAllLatch>(tasks)...);
+        co_await detail::WhenAllAwaiter{latch, jobs};
+        co_return std::tuple<detail::WhenAllValue<Ts>...>{detail::when_all_result(tasks)...};
+    }
+
+    // when_all over a run time number of tasks of the same type
+    template<typename T>
+    task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> when_all(std::vector<task<T>> tasks) {
+        detail::WhenAllLatch latch{tasks.size()};
+        std::vector<detail::LatchedJob<detail::WhenAllLatch>> jobs;
+        jobs.reserve(tasks.size());
+        for (auto& awaited: tasks) {
+            jobs.push_back(detail::make_latched_job<detail::WhenAllLatch>(awaited));
+        }
+        co_await detail::WhenAllAwaiter{latch, jobs};
+
+        if constexpr (std::is_void_v<T>) {
+            for (auto& finished: tasks) {
+                finished.result();
+            }
+        } else {
+            std::vector<T> results;
+            results.reserve(tasks.size());
+            for (auto& finished: tasks) {
+                results.push_back(finished.result());
+            }
+            co_return results;
+        }
+    }
+}// namespace stg::utility
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef STG_UTILITY_MAIN_STG_DISTRIBUTED_HPP
+#define STG_UTILITY_MAIN_STG_DISTRIBUTED_HPP
+
+#include "stg_distributed/communicator.hpp"
+#include "stg_distributed/local_launcher.hpp"
+#include "stg_distributed/tree_reduce.hpp"
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef STG_UTILITY_COMMUNICATOR_HPP
+#define STG_UTILITY_COMMUNICATOR_HPP
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace stg::utility {
+
+    /*
+     * Point to point transport between the ranks of a distributed run, MPI style: the
+     * messages between two ranks arrive in order, a receive blocks until the whole buffer
+     * is filled and must have the size of the matching send
+     */
+    class ICommunicator {
+    public:
+        [[nodiscard]] virtual std::size_t rank() const noexcept = 0;
+
+        [[nodiscard]] virtual std::size_t size() const noexcept = 0;
+
+        virtual void send(std::size_t to, std::span<const std::byte> data) = 0;
+
+        virtual void receive(std::size_t from, std::span<std::byte> data) = 0;
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        void send(std::size_t to, std::span<const T> values) {
+            send(to, std::as_bytes(values));
+        }
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        void receive(std::size_t from, std::span<T> values) {
+            receive(from, std::as_writable_bytes(values));
+        }
+
+        virtual ~ICommunicator() = default;
+    };
+
+    // The only rank of a single process run, nothing to send to
+    class SingleProcessCommunicator final : public ICommunicator {
+    public:
+        [[nodiscard]] std::size_t rank() const noexcept override { return 0; }
+
+        [[nodiscard]] std::size_t size() const noexcept override { return 1; }
+
+        void send(std::size_t, std::span<const std::byte>) override {}
+
+        void receive(std::size_t, std::span<std::byte>) override {}
+    };
+}// namespace stg::utility
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef STG_UTILITY_LOCAL_LAUNCHER_HPP
+#define STG_UTILITY_LOCAL_LAUNCHER_HPP
+
+#include "communicator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fmt/core.h>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace stg::utility {
+
+    namespace detail {
+        // One way mailbox between two ranks in the shared memory, one chunk in flight
+        struct alignas(64) SharedChannel {
+            static constexpr std::size_t capacity = std::size_t{1} << 16;
+
+            std::atomic<std::uint32_t> full{0};
+            std::uint32_t size = 0;
+            std::byte data[capacity];
+        };
+
+        struct alignas(64) SharedHeader {
+            std::atomic<std::uint32_t> aborted{0};
+        };
+
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "Shared memory transport needs lock free atomics");
+
+        // Anonymous shared mapping inherited by the forked ranks
+        class SharedRegion final {
+        public:
+            explicit SharedRegion(std::size_t ranks)
+                : ranks_{ranks}, bytes_{sizeof(SharedHeader) + ranks * ranks * sizeof(SharedChannel)} {
+                memory_ = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+                if (memory_ == MAP_FAILED) {
+                    throw std::system_error(errno, std::generic_category(), "Shared memory for the ranks isn't mapped");
+                }
+                new (memory_) SharedHeader{};
+                for (std::size_t index = 0; index < ranks * ranks; ++index) {
+                    new (channels() + index) SharedChannel{};
+                }
+            }
+
+            SharedRegion(const SharedRegion&) = delete;
+            SharedRegion& operator=(const SharedRegion&) = delete;
+
+            ~SharedRegion() { munmap(memory_, bytes_); }
+
+            SharedHeader& header() noexcept { return *static_cast<SharedHeader*>(memory_); }
+
+            SharedChannel& channel(std::size_t from, std::size_t to) noexcept {
+                return channels()[from * ranks_ + to];
+            }
+
+        private:
+            std::size_t ranks_;
+            std::size_t bytes_;
+            void* memory_;
+
+            SharedChannel* channels() noexcept {
+                return reinterpret_cast<SharedChannel*>(static_cast<std::byte*>(memory_) + sizeof(SharedHeader));
+            }
+        };
+    }// namespace detail
+
+    /*
+     * Communicator of the ranks forked by launch_local, the messages go through the shared
+     * memory mailboxes in chunks. The waits spin and then back off to short sleeps, a failed
+     * rank sets the abort flag and the waiting ranks throw instead of hanging
+     */
+    class SharedMemoryCommunicator final : public ICommunicator {
+    public:
+        SharedMemoryCommunicator(detail::SharedRegion& region, std::size_t rank, std::size_t size) noexcept
+            : region_{region}, rank_{rank}, size_{size} {}
+
+        [[nodiscard]] std::size_t rank() const noexcept override { return rank_; }
+
+        [[nodiscard]] std::size_t size() const noexcept override { return size_; }
+
+        void send(std::size_t to, std::span<const std::byte> data) override {
+            detail::SharedChannel& channel = region_.channel(rank_, to);
+            do {
+                wait_until([&channel] { return channel.full.load(std::memory_order_acquire) == 0; });
+                const std::size_t chunk = std::min(data.size(), detail::SharedChannel::capacity);
+                std::memcpy(channel.data, data.data(), chunk);
+                channel.size = static_cast<std::uint32_t>(chunk);
+                channel.full.store(1, std::memory_order_release);
+                data = data.subspan(chunk);
+            } while (!data.empty());
+        }
+
+        void receive(std::size_t from, std::span<std::byte> data) override {
+            detail::SharedChannel& channel = region_.channel(from, rank_);
+            do {
+                wait_until([&channel] { return channel.full.load(std::memory_order_acquire) == 1; });
+                if (channel.size > data.size()) {
+                    abort();
+                    throw std::logic_error("Received message is longer than the buffer");
+                }
+                std::memcpy(data.data(), channel.data, channel.size);
+                data = data.subspan(channel.size);
+                channel.full.store(0, std::memory_order_release);
+            } while (!data.empty());
+        }
+
+        // Makes the other ranks fail their waits
+        void abort() noexcept {
+            region_.header().aborted.store(1, std::memory_order_release);
+        }
+
+    private:
+        detail::SharedRegion& region_;
+        std::size_t rank_;
+        std::size_t size_;
+
+        template<typename Condition>
+        void wait_until(Condition&& condition) const {
+            for (std::size_t attempt = 0; !condition(); ++attempt) {
+                if (region_.header().aborted.load(std::memory_order_acquire) != 0) {
+                    throw std::runtime_error("Peer rank failed");
+                }
+                if (attempt < 1024) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds{50});
+                }
+            }
+        }
+    };
+
+    /*
+     * Runs body on ranks processes of this machine: the calling process is the rank 0, the
+     * others are forked and exit when their body returns. Returns when all the ranks are done,
+     * rethrows the exception of the rank 0 or throws if another rank failed.
+     * Forking copies only the calling thread: the ranks must not use the thread pools created
+     * before the launch (ThreadPool::global included), they create their own
+     */
+    inline void launch_local(std::size_t ranks, const std::function<void(ICommunicator&)>& body) {
+        if (ranks == 0) {
+            throw std::invalid_argument("Local launch needs at least one rank");
+        }
+        detail::SharedRegion region{ranks};
+        std::vector<pid_t> children;
+        children.reserve(ranks - 1);
+        for (std::size_t rank = 1; rank < ranks; ++rank) {
+            const pid_t pid = fork();
+            if (pid == 0) {
+                SharedMemoryCommunicator communicator{region, rank, ranks};
+                int status = 0;
+                try {
+                    body(communicator);
+                } catch (const std::exception& error) {
+                    communicator.abort();
+                    fmt::print(stderr, "Rank {} failed: {}\n", rank, error.what());
+                    status = 1;
+                } catch (...) {
+                    communicator.abort();
+                    status = 1;
+                }
+                std::fflush(nullptr);
+                _exit(status);
+            }
+            if (pid < 0) {
+                region.header().aborted.store(1);
+                for (const pid_t child: children) {
+                    waitpid(child, nullptr, 0);
+                }
+                throw std::system_error(errno, std::generic_category(), "Rank process isn't forked");
+            }
+            children.push_back(pid);
+        }
+
+        SharedMemoryCommunicator communicator{region, 0, ranks};
+        std::exception_ptr error;
+        try {
+            body(communicator);
+        } catch (...) {
+            communicator.abort();
+            error = std::current_exception();
+        }
+
+        bool children_failed = false;
+        for (const pid_t child: children) {
+            int status = 0;
+            waitpid(child, &status, 0);
+            children_failed = children_failed || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        if (children_failed) {
+            throw std::runtime_error("Rank process failed");
+        }
+    }
+}// namespace stg::utility
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef STG_UTILITY_TREE_REDUCE_HPP
+#define STG_UTILITY_TREE_REDUCE_HPP
+
+#include "communicator.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace stg::utility {
+
+    namespace detail {
+        // The fixed split of the blocks [begin, end) in the reduction tree
+        constexpr std::size_t tree_middle(std::size_t begin, std::size_t end) noexcept {
+            return begin + (end - begin) / 2;
+        }
+
+        template<typename V, typename Leaf, typename Combine>
+        std::vector<V> tree_reduce_local(std::size_t begin, std::size_t end, Leaf& leaf, Combine& combine) {
+            if (end - begin == 1) {
+                return leaf(begin);
+            }
+            const std::size_t middle = tree_middle(begin, end);
+            std::vector<V> left = tree_reduce_local<V>(begin, middle, leaf, combine);
+            const std::vector<V> right = tree_reduce_local<V>(middle, end, leaf, combine);
+            combine(left, right);
+            return left;
+        }
+
+        /*
+         * The ranks [first_rank, last_rank) reduce the blocks [begin, end): the ranks are split
+         * in proportion to the halves of the blocks and the first rank of the right half sends
+         * its partial to the first rank of the left half, the result is on first_rank
+         */
+        template<typename V, typename Leaf, typename Combine>
+        std::optional<std::vector<V>> tree_reduce_ranks(ICommunicator& communicator,
+                                                        std::size_t begin, std::size_t end,
+                                                        std::size_t first_rank, std::size_t last_rank,
+                                                        std::size_t length, Leaf& leaf, Combine& combine) {
+            const std::size_t rank = communicator.rank();
+            if (last_rank - first_rank == 1 || end - begin == 1) {
+                if (rank != first_rank) {
+                    return std::nullopt;
+                }
+                return tree_reduce_local<V>(begin, end, leaf, combine);
+            }
+
+            const std::size_t middle = tree_middle(begin, end);
+            const std::size_t ranks = last_rank - first_rank;
+            const std::size_t left_ranks = std::clamp<std::size_t>((ranks * (middle - begin) + (end - begin) / 2) / (end - begin), 1, ranks - 1);
+            const std::size_t middle_rank = first_rank + left_ranks;
+
+            if (rank >= middle_rank) {
+                auto right = tree_reduce_ranks<V>(communicator, middle, end, middle_rank, last_rank, length, leaf, combine);
+                if (right) {
+                    communicator.send(first_rank, std::span<const V>{*right});
+                }
+                return std::nullopt;
+            }
+
+            auto left = tree_reduce_ranks<V>(communicator, begin, middle, first_rank, middle_rank, length, leaf, combine);
+            if (left) {
+                std::vector<V> right(length);
+                communicator.receive(middle_rank, std::span<V>{right});
+                combine(*left, right);
+            }
+            return left;
+        }
+    }// namespace detail
+
+    /*
+     * Reduces the partials of the blocks [0, blocks) over a fixed binary tree: the blocks
+     * range is halved down to single blocks, leaf(block) gives the partial of a block (a
+     * vector of length values) and combine(left, right) adds the right partial to the left one.
+     * The ranks share the subtrees and send the partials up the same tree, so every addition
+     * is made in the same order for any number of ranks and the result is bit for bit the
+     * single process one. The result is on the rank 0, the other ranks get none
+     */
+    template<typename V, typename Leaf, typename Combine>
+        requires std::is_trivially_copyable_v<V>
+    std::optional<std::vector<V>> tree_reduce(ICommunicator& communicator, std::size_t blocks, std::size_t length,
+                                              Leaf&& leaf, Combine&& combine) {
+        if (blocks == 0) {
+            throw std::invalid_argument("Nothing to reduce");
+        }
+        return detail::tree_reduce_ranks<V>(communicator, 0, blocks, 0, communicator.size(), length, leaf, combine);
+    }
+
+    template<typename V, typename Leaf, typename Combine>
+        requires std::is_trivially_copyable_v<V>
+    std::vector<V> tree_reduce(std::size_t blocks, Leaf&& leaf, Combine&& combine) {
+        if (blocks == 0) {
+            throw std::invalid_argument("Nothing to reduce");
+        }
+        return detail::tree_reduce_local<V>(0, blocks, leaf, combine);
+    }
+}// namespace stg::utility
+
+#endif
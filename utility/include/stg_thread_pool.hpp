@@ -1,6 +1,12 @@
 #ifndef STG_UTILITY_MAIN_STG_THREAD_POOL_HPP
 #define STG_UTILITY_MAIN_STG_THREAD_POOL_HPP
 
+#include "stg_thread_pool/affinity.hpp"
+#include "stg_thread_pool/bounded_queue.hpp"
+#include "stg_thread_pool/first_touch.hpp"
+#include "stg_thread_pool/parallel_for.hpp"
 #include "stg_thread_pool/stg_thread_pool.hpp"
+#include "stg_thread_pool/task_graph.hpp"
+#include "stg_thread_pool/task_group.hpp"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef STG_UTILITY_AFFINITY_HPP
+#define STG_UTILITY_AFFINITY_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace stg::utility {
+
+    /*
+     * none   - the workers float over the CPUs as the OS schedules them
+     * pinned - worker i is bound to the i-th CPU of the process ordered by NUMA node,
+     *          so the workers of a node are neighbours and keep their memory local
+     */
+    enum class Affinity {
+        none,
+        pinned
+    };
+
+    // NUMA node of the CPU from sysfs, 0 if unknown (single node machines, not Linux)
+    inline std::size_t numa_node_of_cpu(std::size_t cpu) {
+        namespace fs = std::filesystem;
+        std::error_code error;
+        const fs::path cpu_path = fs::path{"/sys/devices/system/cpu"} / ("cpu" + std::to_string(cpu));
+        for (fs::directory_iterator entry{cpu_path, error}, end; !error && entry != end; entry.increment(error)) {
+            const std::string name = entry->path().filename().string();
+            if (name.starts_with("node") && name.size() > 4 && std::isdigit(static_cast<unsigned char>(name[4]))) {
+                return std::stoul(name.substr(4));
+            }
+        }
+        return 0;
+    }
+
+    // CPUs the process may run on ordered by (NUMA node, CPU)
+    inline std::vector<std::size_t> available_cpus() {
+        std::vector<std::size_t> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (std::size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) { cpus.push_back(cpu); }
+            }
+        }
+#endif
+        if (cpus.empty()) {
+            cpus.resize(std::max(1u, std::thread::hardware_concurrency()));
+            std::iota(cpus.begin(), cpus.end(), std::size_t{0});
+        }
+        std::vector<std::pair<std::size_t, std::size_t>> by_node;
+        by_node.reserve(cpus.size());
+        for (const std::size_t cpu: cpus) {
+            by_node.emplace_back(numa_node_of_cpu(cpu), cpu);
+        }
+        std::ranges::sort(by_node);
+        std::ranges::transform(by_node, cpus.begin(), [](const auto& node_cpu) { return node_cpu.second; });
+        return cpus;
+    }
+
+    // Binds the calling thread to the CPU, false if it's not possible
+    inline bool pin_current_thread(std::size_t cpu) noexcept {
+#ifdef __linux__
+        if (cpu >= CPU_SETSIZE) { return false; }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+}// namespace stg::utility
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef STG_UTILITY_BOUNDED_QUEUE_HPP
+#define STG_UTILITY_BOUNDED_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace stg::utility {
+
+    /*
+     * Blocking multi producer multi consumer queue of a fixed capacity, links the stages
+     * of a pipeline on dedicated threads: a producer waits while the queue is full, so a
+     * slow consumer holds the producers back instead of letting the queue grow.
+     * After close the pushes fail and the pops drain what's left
+     */
+    template<typename T>
+    class BoundedQueue final {
+    public:
+        explicit BoundedQueue(std::size_t capacity)
+            : capacity_{capacity == 0 ? 1 : capacity} {}
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // Waits for a free place, false if the queue is closed
+        bool push(T value) {
+            std::unique_lock lock{mutex_};
+            not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+            if (closed_) {
+                return false;
+            }
+            items_.push_back(std::move(value));
+            lock.unlock();
+            not_empty_.notify_one();
+            return true;
+        }
+
+        // Waits for an item, none once the queue is closed and empty
+        std::optional<T> pop() {
+            std::unique_lock lock{mutex_};
+            not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+            if (items_.empty()) {
+                return std::nullopt;
+            }
+            std::optional<T> value{std::move(items_.front())};
+            items_.pop_front();
+            lock.unlock();
+            not_full_.notify_one();
+            return value;
+        }
+
+        // An item if there is one, never waits
+        std::optional<T> try_pop() {
+            std::unique_lock lock{mutex_};
+            if (items_.empty()) {
+                return std::nullopt;
+            }
+            std::optional<T> value{std::move(items_.front())};
+            items_.pop_front();
+            lock.unlock();
+            not_full_.notify_one();
+            return value;
+        }
+
+        void close() {
+            {
+                std::lock_guard lock{mutex_};
+                closed_ = true;
+            }
+            not_full_.notify_all();
+            not_empty_.notify_all();
+        }
+
+        [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+    private:
+        const std::size_t capacity_;
+        std::mutex mutex_;
+        std::condition_variable not_full_;
+        std::condition_variable not_empty_;
+        std::deque<T> items_;
+        bool closed_ = false;
+    };
+}// namespace stg::utility
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef STG_UTILITY_FIRST_TOUCH_HPP
+#define STG_UTILITY_FIRST_TOUCH_HPP
+
+#include "parallel_for.hpp"
+#include "stg_thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace stg::utility {
+
+    /*
+     * Places the pages of a buffer on the NUMA nodes of the workers processing them. A page
+     * lives on the node of the thread touching it first, and the buffers of std::vector are
+     * first touched by the constructing thread when it zeroes them. The whole pages of the
+     * buffer are given back (madvise MADV_DONTNEED, they read as zeros again) and zeroed anew
+     * by the worker of their Partition::per_worker block, so a pinned pool running
+     * parallel_for with Partition::per_worker over [0, buffer.size()) finds its data local.
+     * The content is lost: for freshly allocated buffers, before they are filled.
+     * Without Linux only the zeroing is left
+     */
+    template<typename T>
+        requires std::is_trivially_copyable_v<T>
+    void first_touch(ThreadPool& pool, std::span<T> buffer) {
+#ifdef __linux__
+        const auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+        const auto first = reinterpret_cast<std::uintptr_t>(buffer.data());
+        const auto last = first + buffer.size_bytes();
+        const std::uintptr_t pages_begin = (first + page - 1) / page * page;
+        const std::uintptr_t pages_end = last / page * page;
+        if (pages_begin < pages_end) {
+            madvise(reinterpret_cast<void*>(pages_begin), pages_end - pages_begin, MADV_DONTNEED);
+        }
+#endif
+        parallel_for(pool, 0, buffer.size(), 1, [buffer](std::size_t begin, std::size_t end) {
+            std::fill(buffer.begin() + begin, buffer.begin() + end, T{});
+        }, Partition::per_worker);
+    }
+}// namespace stg::utility
+
+#endif
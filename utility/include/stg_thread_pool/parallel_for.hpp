@@ -0,0 +1,214 @@
+#ifndef STG_UTILITY_PARALLEL_FOR_HPP
+#define STG_UTILITY_PARALLEL_FOR_HPP
+
+#include "stg_thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace stg::utility {
+
+    // Index range [begin, end)
+    struct IndexRange final {
+        std::size_t begin;
+        std::size_t end;
+
+        [[nodiscard]] std::size_t size() const noexcept { return end > begin ? end - begin : 0; }
+    };
+
+    /*
+     * static - the range is cut into one chunk per participating thread (but not smaller
+     *          than the grain), for the iterations of the same cost.
+     * guided - every claimed chunk is remaining / (2 * threads) but not smaller than the
+     *          grain, the chunks shrink to the end of the range and balance uneven iterations
+     * per_worker - block w of pool.size() equal blocks is run by the worker w (the grain is
+     *          not used), the same index always goes to the same worker, so the data
+     *          placed by first_touch stays on the NUMA node of the pinned worker
+     */
+    enum class Partition {
+        static_chunks,
+        guided,
+        per_worker
+    };
+
+    namespace detail {
+        template<typename Function>
+        class ParallelForState final {
+        public:
+            ParallelForState(IndexRange range, std::size_t grain, std::size_t threads,
+                             Partition partition, Function& function)
+                : range_{range},
+                  grain_{std::max<std::size_t>(1, grain)},
+                  threads_{threads},
+                  partition_{partition},
+                  static_chunk_{std::max(grain_, (range_.size() + threads_ - 1) / threads_)},
+                  function_{function},
+                  next_{range.begin} {}
+
+            /*
+             * Claims and runs chunks until the range is exhausted. After a failure the
+             * remaining chunks are claimed and counted as done without being run
+             */
+            void run(ThreadPool& pool) noexcept {
+                for (IndexRange chunk = claim(); chunk.size() != 0; chunk = claim()) {
+                    if (!failed_.load(std::memory_order_relaxed)) {
+                        try {
+                            function_(chunk.begin, chunk.end);
+                        } catch (...) {
+                            std::lock_guard lock{exception_mutex_};
+                            if (!exception_) { exception_ = std::current_exception(); }
+                            failed_.store(true, std::memory_order_relaxed);
+                        }
+                    }
+                    if (done_.fetch_add(chunk.size(), std::memory_order_acq_rel) + chunk.size() == range_.size()) {
+                        pool.notify_waiters();
+                    }
+                }
+            }
+
+            /*
+             * Runs the pending tasks of the pool until every chunk is done, the participants
+             * still running may outlive the call
+             */
+            void wait(ThreadPool& pool) const {
+                pool.run_until([this] { return done_.load(std::memory_order_acquire) == range_.size(); });
+                if (exception_) {
+                    std::rethrow_exception(exception_);
+                }
+            }
+
+        private:
+            const IndexRange range_;
+            const std::size_t grain_;
+            const std::size_t threads_;
+            const Partition partition_;
+            const std::size_t static_chunk_;
+            Function& function_;
+
+            std::atomic<std::size_t> next_;
+            std::atomic<std::size_t> done_{0};
+            std::atomic<bool> failed_{false};
+            std::mutex exception_mutex_;
+            std::exception_ptr exception_;
+
+            IndexRange claim() noexcept {
+                std::size_t begin = next_.load(std::memory_order_relaxed);
+                std::size_t end;
+                do {
+                    if (begin >= range_.end) {
+                        return {range_.end, range_.end};
+                    }
+                    const std::size_t remaining = range_.end - begin;
+                    const std::size_t chunk = partition_ == Partition::static_chunks
+                                                      ? static_chunk_
+                                                      : std::max(grain_, remaining / (2 * threads_));
+                    end = begin + std::min(chunk, remaining);
+                } while (!next_.compare_exchange_weak(begin, end, std::memory_order_relaxed));
+                return {begin, end};
+            }
+        };
+
+        // Block worker of the Partition::per_worker split of the range between workers
+        inline IndexRange worker_block(IndexRange range, std::size_t worker, std::size_t workers) noexcept {
+            return {range.begin + range.size() * worker / workers, range.begin + range.size() * (worker + 1) / workers};
+        }
+
+        template<typename Function>
+        void parallel_for_per_worker(ThreadPool& pool, IndexRange range, Function& function) {
+            struct State {
+                std::atomic<std::size_t> remaining;
+                std::mutex mutex;
+                std::exception_ptr exception;
+            };
+            const std::size_t workers = pool.size();
+            const auto caller = pool.current_worker();
+            auto state = std::make_shared<State>();
+            state->remaining.store(workers, std::memory_order_relaxed);
+
+            const auto run = [state, range, workers, &pool, &function](std::size_t worker) noexcept {
+                const IndexRange block = worker_block(range, worker, workers);
+                if (block.size() != 0) {
+                    try {
+                        function(block.begin, block.end);
+                    } catch (...) {
+                        std::lock_guard lock{state->mutex};
+                        if (!state->exception) { state->exception = std::current_exception(); }
+                    }
+                }
+                if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    pool.notify_waiters();
+                }
+            };
+            for (std::size_t worker = 0; worker < workers; ++worker) {
+                if (worker != caller) {
+                    pool.post_to(worker, [run, worker] { run(worker); });
+                }
+            }
+            if (caller) {
+                run(*caller);
+            }
+            // Waits on the pool, not on remaining: the caller may be a worker another
+            // per worker loop posts to, it has to run that block while it waits
+            pool.run_until([&state] { return state->remaining.load(std::memory_order_acquire) == 0; });
+            if (state->exception) {
+                std::rethrow_exception(state->exception);
+            }
+        }
+    }// namespace detail
+
+    /*
+     * Calls function(chunk_begin, chunk_end) for disjoint chunks covering the range, on the
+     * pool threads and the calling thread. Chunks are at least grain indices long (except the
+     * last one), so a chunk can write its own slice of the output without synchronization.
+     * Returns when the whole range is processed, the first exception thrown by the function
+     * is rethrown and the chunks not started by then are skipped.
+     * The calling thread takes part in the loop and waits only for the claimed chunks, so
+     * a parallel_for started from a pool task doesn't deadlock when all threads are busy
+     */
+    template<std::invocable<std::size_t, std::size_t> Function>
+    void parallel_for(ThreadPool& pool, IndexRange range, std::size_t grain, Function&& function,
+                      Partition partition = Partition::guided) {
+        if (range.size() == 0) {
+            return;
+        }
+        if (partition == Partition::per_worker) {
+            detail::parallel_for_per_worker(pool, range, function);
+            return;
+        }
+        const std::size_t threads = pool.size() + 1;
+        if (range.size() <= std::max<std::size_t>(1, grain)) {
+            function(range.begin, range.end);
+            return;
+        }
+
+        using State = detail::ParallelForState<std::remove_reference_t<Function>>;
+        auto state = std::make_shared<State>(range, grain, threads, partition, function);
+        const std::size_t chunks = (range.size() + std::max<std::size_t>(1, grain) - 1) / std::max<std::size_t>(1, grain);
+        const std::size_t helpers = std::min(pool.size(), chunks - 1);
+        for (std::size_t helper = 0; helper < helpers; ++helper) {
+            pool.post([state, &pool] { state->run(pool); });
+        }
+        state->run(pool);
+        state->wait(pool);
+    }
+
+    template<std::invocable<std::size_t, std::size_t> Function>
+    void parallel_for(ThreadPool& pool, std::size_t begin, std::size_t end, std::size_t grain, Function&& function,
+                      Partition partition = Partition::guided) {
+        parallel_for(pool, IndexRange{begin, end}, grain, std::forward<Function>(function), partition);
+    }
+
+    // parallel_for on the process wide pool
+    template<std::invocable<std::size_t, std::size_t> Function>
+    void parallel_for(IndexRange range, std::size_t grain, Function&& function,
+                      Partition partition = Partition::guided) {
+        parallel_for(ThreadPool::global(), range, grain, std::forward<Function>(function), partition);
+    }
+}// namespace stg::utility
+
+#endif
@@ -1,27 +1,86 @@
 #ifndef STG_UTILITY_STG_THREAD_POOL_HPP
 #define STG_UTILITY_STG_THREAD_POOL_HPP
 
+#include "affinity.hpp"
 #include <algorithm>
-#include <boost/asio/execution_context.hpp>
-#include <boost/asio/io_context.hpp>
-#include <boost/asio/post.hpp>
-#include <boost/asio/thread_pool.hpp>
+#include <atomic>
 #include <concepts>
-#include <ranges>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace stg::utility {
-    namespace net = boost::asio;
+
+    namespace detail {
+        // Type erased move only task of the pool
+        class PoolTask final {
+        public:
+            PoolTask() noexcept = default;
+
+            template<std::invocable Function>
+                requires(!std::same_as<std::decay_t<Function>, PoolTask>)
+            explicit PoolTask(Function&& function)
+                : callable_{std::make_unique<Callable<std::decay_t<Function>>>(std::forward<Function>(function))} {}
+
+            void operator()() { callable_->call(); }
+
+            explicit operator bool() const noexcept { return callable_ != nullptr; }
+
+        private:
+            struct ICallable {
+                virtual void call() = 0;
+                virtual ~ICallable() = default;
+            };
+
+            template<typename Function>
+            struct Callable final : ICallable {
+                template<typename F>
+                explicit Callable(F&& f) : function{std::forward<F>(f)} {}
+                void call() override { function(); }
+                Function function;
+            };
+
+            std::unique_ptr<ICallable> callable_;
+        };
+    }// namespace detail
+
+    /*
+     * Work stealing thread pool. Every worker owns a deque: tasks posted from a worker go
+     * to the back of its deque and are taken back LIFO, so nested work stays hot in cache,
+     * idle workers steal from the front of the other deques. Tasks posted from the other
+     * threads go to a shared injection queue.
+     * Threads waiting for the tasks they submitted (TaskGroup::sync, parallel_for) run
+     * the pending tasks in run_until instead of blocking, so nested parallelism
+     * doesn't need more threads than the pool has.
+     * Exceptions must not escape a posted task, TaskGroup and parallel_for take care of it.
+     * With Affinity::pinned the workers are bound to the CPUs (see available_cpus), post_to
+     * gives a task to one worker only, the base of the NUMA placement (first_touch.hpp)
+     */
     class ThreadPool final {
     public:
-        explicit ThreadPool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
-            : thread_amount_{threads} {
-            std::ranges::for_each(std::views::iota(0ull, threads),
-                                  [this](std::size_t) {
-                                      workers_.emplace_back([this] { io_.run(); });
-                                  });
+        explicit ThreadPool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()),
+                            Affinity affinity = Affinity::none)
+            : queues_(threads), worker_cpus_(threads) {
+            for (auto& queue: queues_) {
+                queue = std::make_unique<WorkerQueue>();
+            }
+            if (affinity == Affinity::pinned) {
+                const auto cpus = available_cpus();
+                for (std::size_t index = 0; index < threads; ++index) {
+                    worker_cpus_[index] = cpus[index % cpus.size()];
+                }
+            }
+            workers_.reserve(threads);
+            for (std::size_t index = 0; index < threads; ++index) {
+                workers_.emplace_back([this, index] { work(index); });
+            }
         }
 
         ThreadPool(const ThreadPool&) = delete;
@@ -30,20 +89,207 @@ namespace stg::utility {
         ThreadPool(ThreadPool&&) = delete;
         ThreadPool& operator=(ThreadPool&&) = delete;
 
-        net::io_context& get_context() {
-            return io_;
+        // Finishes the posted tasks and joins the threads
+        ~ThreadPool() {
+            {
+                std::lock_guard lock{sleep_mutex_};
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            workers_.clear();
+        }
+
+        /*
+         * Process wide pool all the modules submit to, one thread less than the hardware
+         * threads as the submitting thread takes part in the work while it waits
+         */
+        static ThreadPool& global() {
+            static ThreadPool pool{std::max(2u, std::thread::hardware_concurrency()) - 1};
+            return pool;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return queues_.size();
+        }
+
+        // Index of the calling thread in the pool, none for the threads of the other pools
+        [[nodiscard]] std::optional<std::size_t> current_worker() const noexcept {
+            if (current_pool_ != this) { return std::nullopt; }
+            return current_index_;
+        }
+
+        // CPU the worker is pinned to, none if the pool isn't pinned
+        [[nodiscard]] std::optional<std::size_t> worker_cpu(std::size_t worker) const noexcept {
+            return worker_cpus_[worker];
+        }
+
+        // NUMA node of the worker, 0 if the pool isn't pinned
+        [[nodiscard]] std::size_t worker_node(std::size_t worker) const {
+            return worker_cpus_[worker] ? numa_node_of_cpu(*worker_cpus_[worker]) : 0;
         }
 
-        template<typename Task>
+        template<std::invocable Task>
         void post(Task&& task) {
-            net::post(io_, std::forward<Task>(task));
+            detail::PoolTask pool_task{std::forward<Task>(task)};
+            pending_.fetch_add(1, std::memory_order_release);
+            if (current_pool_ == this) {
+                std::lock_guard lock{queues_[current_index_]->mutex};
+                queues_[current_index_]->tasks.push_back(std::move(pool_task));
+            } else {
+                std::lock_guard lock{injection_mutex_};
+                injection_.push_back(std::move(pool_task));
+            }
+            {
+                std::lock_guard lock{sleep_mutex_};
+            }
+            wake_.notify_one();
+        }
+
+        /*
+         * Posts a task only the worker runs, it can't be stolen. A thread waiting for it
+         * must not be the worker itself unless it waits in run_until
+         */
+        template<std::invocable Task>
+        void post_to(std::size_t worker, Task&& task) {
+            detail::PoolTask pool_task{std::forward<Task>(task)};
+            WorkerQueue& queue = *queues_[worker];
+            {
+                std::lock_guard lock{queue.mutex};
+                queue.affine.push_back(std::move(pool_task));
+                queue.affine_pending.fetch_add(1, std::memory_order_release);
+            }
+            {
+                std::lock_guard lock{sleep_mutex_};
+            }
+            wake_.notify_all();
+        }
+
+        /*
+         * Runs one pending task on the calling thread: the back of the own deque for a worker,
+         * then the injection queue, then the front of the other deques. False if there was none
+         */
+        bool try_run_one() {
+            detail::PoolTask task = take();
+            if (!task) {
+                return false;
+            }
+            task();
+            return true;
+        }
+
+        /*
+         * Runs the pending tasks until done() holds and sleeps on the pool while there are
+         * none. A waiting worker wakes up for the tasks posted to it, so a post_to never waits
+         * for a worker blocked in a join. Who makes done() hold calls notify_waiters after it
+         */
+        template<std::predicate Done>
+        void run_until(Done&& done) {
+            while (!done()) {
+                if (try_run_one()) {
+                    continue;
+                }
+                std::unique_lock lock{sleep_mutex_};
+                wake_.wait(lock, [this, &done] { return done() || has_work(); });
+            }
+        }
+
+        // Wakes up the threads in run_until to check their condition
+        void notify_waiters() {
+            {
+                std::lock_guard lock{sleep_mutex_};
+            }
+            wake_.notify_all();
         }
 
     private:
-        const std::size_t thread_amount_;
-        net::io_context io_{static_cast<int>(thread_amount_)};
-        std::vector<std::jthread> workers_{thread_amount_};
+        struct alignas(64) WorkerQueue {
+            std::mutex mutex;
+            std::deque<detail::PoolTask> tasks;
+            // Tasks of post_to, out of pending_ so the other workers don't wake up for them
+            std::deque<detail::PoolTask> affine;
+            std::atomic<std::size_t> affine_pending{0};
+        };
+
+        static inline thread_local const ThreadPool* current_pool_ = nullptr;
+        static inline thread_local std::size_t current_index_ = 0;
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues_;
+        std::vector<std::optional<std::size_t>> worker_cpus_;
+        std::mutex injection_mutex_;
+        std::deque<detail::PoolTask> injection_;
+
+        std::atomic<std::size_t> pending_{0};
+        std::mutex sleep_mutex_;
+        std::condition_variable wake_;
+        bool stopping_ = false;
+
+        std::vector<std::jthread> workers_;
+
+        void work(std::size_t index) {
+            current_pool_ = this;
+            current_index_ = index;
+            if (worker_cpus_[index]) {
+                pin_current_thread(*worker_cpus_[index]);
+            }
+            while (true) {
+                if (try_run_one()) {
+                    continue;
+                }
+                std::unique_lock lock{sleep_mutex_};
+                wake_.wait(lock, [this] { return stopping_ || has_work(); });
+                if (stopping_ && !has_work()) {
+                    return;
+                }
+            }
+        }
+
+        // Tasks the calling thread could take: the shared ones and, for a worker, the affine ones
+        [[nodiscard]] bool has_work() const noexcept {
+            return pending_.load(std::memory_order_acquire) != 0 ||
+                   (current_pool_ == this && queues_[current_index_]->affine_pending.load(std::memory_order_acquire) != 0);
+        }
+
+        detail::PoolTask take() {
+            const bool is_worker = current_pool_ == this;
+            if (is_worker) {
+                WorkerQueue& own = *queues_[current_index_];
+                std::lock_guard lock{own.mutex};
+                if (!own.affine.empty()) {
+                    detail::PoolTask task = std::move(own.affine.front());
+                    own.affine.pop_front();
+                    own.affine_pending.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+                if (!own.tasks.empty()) {
+                    detail::PoolTask task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    pending_.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+            {
+                std::lock_guard lock{injection_mutex_};
+                if (!injection_.empty()) {
+                    detail::PoolTask task = std::move(injection_.front());
+                    injection_.pop_front();
+                    pending_.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+            const std::size_t first = is_worker ? current_index_ + 1 : 0;
+            for (std::size_t offset = 0; offset < queues_.size(); ++offset) {
+                WorkerQueue& victim = *queues_[(first + offset) % queues_.size()];
+                std::lock_guard lock{victim.mutex};
+                if (!victim.tasks.empty()) {
+                    detail::PoolTask task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    pending_.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+            return {};
+        }
     };
 }// namespace stg::utility
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,177 @@
+#ifndef STG_UTILITY_TASK_GRAPH_HPP
+#define STG_UTILITY_TASK_GRAPH_HPP
+
+#include "stg_thread_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stg::utility {
+
+    // Data a stage reads and writes, by name
+    struct StageData final {
+        std::vector<std::string> inputs = {};
+        std::vector<std::string> outputs = {};
+    };
+
+    // Times of a stage from the start of the graph run
+    struct StageTiming final {
+        std::string name;
+        std::chrono::nanoseconds start{};
+        std::chrono::nanoseconds duration{};
+    };
+
+    /*
+     * Graph of the stages of a run over the pool. A stage declares the data it reads
+     * and writes and the edges follow in the order of add: a stage waits for the last
+     * writer of its inputs and outputs and for the readers of its outputs since then.
+     * So the stages without a hazard between them overlap, e.g. saving a field while
+     * the next one is generated into another buffer.
+     * run starts the stages without dependencies, every finished stage starts the
+     * successors it was the last dependency of, the caller runs the pool tasks while
+     * it waits. After a failed stage the stages left are skipped and run rethrows
+     */
+    class TaskGraph final {
+    public:
+        using NodeId = std::size_t;
+
+        explicit TaskGraph(ThreadPool& pool = ThreadPool::global())
+            : pool_{pool} {}
+
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator=(const TaskGraph&) = delete;
+
+        NodeId add(std::string name, const StageData& data, std::function<void()> work) {
+            const NodeId id = nodes_.size();
+            nodes_.push_back(std::make_unique<Node>(std::move(name), std::move(work)));
+            for (const auto& input: data.inputs) {
+                auto& access = data_[input];
+                if (access.writer) { precede(*access.writer, id); }
+                access.readers.push_back(id);
+            }
+            for (const auto& output: data.outputs) {
+                auto& access = data_[output];
+                if (access.writer) { precede(*access.writer, id); }
+                for (const NodeId reader: access.readers) {
+                    if (reader != id) { precede(reader, id); }
+                }
+                access.writer = id;
+                access.readers.clear();
+            }
+            return id;
+        }
+
+        // Explicit edge for an order not given by the data
+        void precede(NodeId before, NodeId after) {
+            if (before >= after || after >= nodes_.size()) {
+                throw std::invalid_argument("Stage may only follow the stages added before it");
+            }
+            auto& successors = nodes_[before]->successors;
+            if (successors.empty() || successors.back() != after) {
+                successors.push_back(after);
+                ++nodes_[after]->dependencies;
+            }
+        }
+
+        void run() {
+            if (nodes_.empty()) { return; }
+            pending_->store(nodes_.size(), std::memory_order_relaxed);
+            failed_.store(false, std::memory_order_relaxed);
+            exception_ = nullptr;
+            for (const auto& node: nodes_) {
+                node->remaining.store(node->dependencies, std::memory_order_relaxed);
+            }
+            start_ = std::chrono::steady_clock::now();
+            for (NodeId id = 0; id < nodes_.size(); ++id) {
+                if (nodes_[id]->dependencies == 0) { post(id); }
+            }
+            pool_.run_until([this] { return pending_->load(std::memory_order_acquire) == 0; });
+            if (exception_) {
+                std::rethrow_exception(exception_);
+            }
+        }
+
+        // Timings of the stages run by the last run, in the order of add
+        [[nodiscard]] std::vector<StageTiming> timings() const {
+            std::vector<StageTiming> result;
+            result.reserve(nodes_.size());
+            for (const auto& node: nodes_) {
+                result.push_back(node->timing);
+            }
+            return result;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return nodes_.size(); }
+
+    private:
+        struct Node {
+            Node(std::string name, std::function<void()> work)
+                : work{std::move(work)}, timing{.name = std::move(name)} {}
+
+            std::function<void()> work;
+            std::vector<NodeId> successors;
+            std::size_t dependencies = 0;
+            std::atomic<std::size_t> remaining{0};
+            StageTiming timing;
+        };
+
+        struct DataAccess {
+            std::optional<NodeId> writer;
+            std::vector<NodeId> readers;
+        };
+
+        ThreadPool& pool_;
+        std::vector<std::unique_ptr<Node>> nodes_;
+        std::map<std::string, DataAccess, std::less<>> data_;
+        // Shared with the stages, the last one notifies after the graph may be gone
+        std::shared_ptr<std::atomic<std::size_t>> pending_ = std::make_shared<std::atomic<std::size_t>>(0);
+        std::atomic<bool> failed_{false};
+        std::mutex mutex_;
+        std::exception_ptr exception_;
+        std::chrono::steady_clock::time_point start_;
+
+        void post(NodeId id) {
+            pool_.post([this, id, &pool = pool_, pending = pending_]() noexcept {
+                execute(id);
+                if (pending->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    pool.notify_waiters();
+                }
+            });
+        }
+
+        void execute(NodeId id) noexcept {
+            Node& node = *nodes_[id];
+            const auto start = std::chrono::steady_clock::now();
+            if (!failed_.load(std::memory_order_acquire)) {
+                try {
+                    node.work();
+                } catch (...) {
+                    std::lock_guard lock{mutex_};
+                    if (!exception_) { exception_ = std::current_exception(); }
+                    failed_.store(true, std::memory_order_release);
+                }
+            }
+            const auto end = std::chrono::steady_clock::now();
+            node.timing.start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - start_);
+            node.timing.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+            for (const NodeId successor: node.successors) {
+                if (nodes_[successor]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    post(successor);
+                }
+            }
+        }
+    };
+}// namespace stg::utility
+
+#endif
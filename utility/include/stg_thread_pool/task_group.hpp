@@ -0,0 +1,150 @@
+#ifndef STG_UTILITY_TASK_GROUP_HPP
+#define STG_UTILITY_TASK_GROUP_HPP
+
+#include "stg_thread_pool.hpp"
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace stg::utility {
+
+    /*
+     * Fork/join over the pool: spawn forks a task, sync joins all the tasks spawned so far
+     * and rethrows the first exception. The tasks may spawn into the same group.
+     * The thread in sync runs the pending tasks of the pool while it waits
+     */
+    class TaskGroup final {
+    public:
+        explicit TaskGroup(ThreadPool& pool = ThreadPool::global())
+            : pool_{pool} {}
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        // Joins the tasks left, their exception is lost
+        ~TaskGroup() { wait(); }
+
+        template<std::invocable Function>
+        void spawn(Function&& function) {
+            state_->pending.fetch_add(1, std::memory_order_relaxed);
+            pool_.post([&pool = pool_, state = state_, function = std::forward<Function>(function)]() mutable noexcept {
+                try {
+                    function();
+                } catch (...) {
+                    std::lock_guard lock{state->mutex};
+                    if (!state->exception) { state->exception = std::current_exception(); }
+                }
+                if (state->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    pool.notify_waiters();
+                }
+            });
+        }
+
+        void sync() {
+            wait();
+            std::exception_ptr exception;
+            {
+                std::lock_guard lock{state_->mutex};
+                std::swap(exception, state_->exception);
+            }
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+
+    private:
+        struct State {
+            std::atomic<std::size_t> pending{0};
+            std::mutex mutex;
+            std::exception_ptr exception;
+        };
+
+        ThreadPool& pool_;
+        // Shared with the tasks, the last one notifies after the group may be gone
+        std::shared_ptr<State> state_ = std::make_shared<State>();
+
+        void wait() noexcept {
+            pool_.run_until([this] { return state_->pending.load(std::memory_order_acquire) == 0; });
+        }
+    };
+
+    /*
+     * Result of a single task forked with spawn, get joins it. A task not joined
+     * is joined by the destructor like the future of std::async
+     */
+    template<typename T>
+    class SpawnedTask final {
+        using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    public:
+        template<std::invocable Function>
+        SpawnedTask(ThreadPool& pool, Function&& function)
+            : pool_{&pool} {
+            pool.post([&pool, state = state_, function = std::forward<Function>(function)]() mutable noexcept {
+                try {
+                    if constexpr (std::is_void_v<T>) {
+                        function();
+                        state->value.emplace();
+                    } else {
+                        state->value.emplace(function());
+                    }
+                } catch (...) {
+                    state->exception = std::current_exception();
+                }
+                state->ready.store(true, std::memory_order_release);
+                pool.notify_waiters();
+            });
+        }
+
+        SpawnedTask(SpawnedTask&&) noexcept = default;
+        SpawnedTask& operator=(SpawnedTask&&) noexcept = default;
+
+        ~SpawnedTask() {
+            if (state_) { wait(); }
+        }
+
+        T get() {
+            wait();
+            const auto state = std::move(state_);
+            if (state->exception) {
+                std::rethrow_exception(state->exception);
+            }
+            if constexpr (!std::is_void_v<T>) {
+                return std::move(*state->value);
+            }
+        }
+
+        [[nodiscard]] bool ready() const noexcept {
+            return state_->ready.load(std::memory_order_acquire);
+        }
+
+    private:
+        struct State {
+            std::atomic<bool> ready{false};
+            std::optional<Stored> value;
+            std::exception_ptr exception;
+        };
+
+        ThreadPool* pool_;
+        std::shared_ptr<State> state_ = std::make_shared<State>();
+
+        void wait() const noexcept {
+            pool_->run_until([this] { return state_->ready.load(std::memory_order_acquire); });
+        }
+    };
+
+    // Forks function on the pool, a drop in for std::async(std::launch::async, function)
+    template<std::invocable Function>
+    auto spawn(Function&& function, ThreadPool& pool = ThreadPool::global()) {
+        return SpawnedTask<std::invoke_result_t<Function>>{pool, std::forward<Function>(function)};
+    }
+}// namespace stg::utility
+
+#endif
@@ -5,6 +5,7 @@
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
 #include <stg_coro_future.hpp>
+#include <stg_distributed.hpp>
 #include <stg_thread_pool.hpp>
 
 using namespace Catch::Matchers;
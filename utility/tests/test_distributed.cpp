@@ -0,0 +1,89 @@
+#include "common.hpp"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+using namespace stg::utility;
+
+namespace {
+    constexpr std::size_t length = 1000;
+
+    // Partials of very different magnitudes, so a change of the summation order shows up
+    std::vector<double> block_partial(std::size_t block) {
+        std::vector<double> partial(length);
+        for (std::size_t index = 0; index < length; ++index) {
+            partial[index] = std::pow(1.7, static_cast<double>(block % 23)) * std::sin(0.1 * static_cast<double>(index * (block + 1))) + 1e-3 * static_cast<double>(block);
+        }
+        return partial;
+    }
+
+    void add(std::vector<double>& left, const std::vector<double>& right) {
+        for (std::size_t index = 0; index < left.size(); ++index) {
+            left[index] += right[index];
+        }
+    }
+}// namespace
+
+SCENARIO("Ranks exchange messages through the shared memory") {
+    GIVEN("Messages longer than a mailbox chunk") {
+        constexpr std::size_t values = 100'000;
+        launch_local(4, [](ICommunicator& communicator) {
+            if (communicator.rank() != 0) {
+                std::vector<double> message(values, static_cast<double>(communicator.rank()));
+                communicator.send(0, std::span<const double>{message});
+                communicator.send(0, std::span<const double>{message.data(), 1});
+                return;
+            }
+            THEN("Every rank's messages arrive whole and in order") {
+                for (std::size_t from = 1; from < communicator.size(); ++from) {
+                    std::vector<double> message(values);
+                    communicator.receive(from, std::span<double>{message});
+                    REQUIRE(std::ranges::all_of(message, [from](double value) { return value == static_cast<double>(from); }));
+                    double last = 0.;
+                    communicator.receive(from, std::span<double>{&last, 1});
+                    REQUIRE(last == static_cast<double>(from));
+                }
+            }
+        });
+    }
+
+    GIVEN("A rank that fails") {
+        THEN("The launch fails instead of waiting for it") {
+            REQUIRE_THROWS(launch_local(3, [](ICommunicator& communicator) {
+                if (communicator.rank() == 2) {
+                    throw std::runtime_error("Rank failed");
+                }
+                double value = 0.;
+                communicator.receive(2, std::span<double>{&value, 1});
+            }));
+        }
+    }
+}
+
+SCENARIO("Tree reduction doesn't depend on the number of ranks") {
+    for (const std::size_t blocks: {1ul, 7ul, 16ul, 37ul}) {
+        const auto expected = tree_reduce<double>(blocks, block_partial, add);
+
+        for (const std::size_t ranks: {1ul, 2ul, 3ul, 5ul, 8ul}) {
+            launch_local(ranks, [&](ICommunicator& communicator) {
+                const auto result = tree_reduce<double>(communicator, blocks, length, block_partial, add);
+                if (communicator.rank() == 0) {
+                    REQUIRE(result.has_value());
+                    REQUIRE(*result == expected);
+                }
+            });
+        }
+    }
+
+    GIVEN("The single process communicator") {
+        SingleProcessCommunicator communicator;
+        THEN("The result is the local reduction") {
+            REQUIRE(tree_reduce<double>(communicator, 9, length, block_partial, add) == tree_reduce<double>(9, block_partial, add));
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace stg::utility;
+
+SCENARIO("Pinned pool places the blocks on their workers") {
+    ThreadPool pool{3, Affinity::pinned};
+    const auto cpus = available_cpus();
+
+    THEN("Every worker is pinned to an available CPU") {
+        for (std::size_t worker = 0; worker < pool.size(); ++worker) {
+            REQUIRE(pool.worker_cpu(worker).has_value());
+            REQUIRE(std::ranges::find(cpus, *pool.worker_cpu(worker)) != cpus.end());
+        }
+    }
+
+    GIVEN("Per worker partition of a range") {
+        std::vector<std::size_t> owners(1000, pool.size());
+        parallel_for(pool, 0, owners.size(), 1, [&](std::size_t begin, std::size_t end) {
+            std::fill(owners.begin() + begin, owners.begin() + end, pool.current_worker().value());
+        }, Partition::per_worker);
+
+        THEN("Block w is run by the worker w, the same split every time") {
+            for (std::size_t worker = 0; worker < pool.size(); ++worker) {
+                const auto block = detail::worker_block({0, owners.size()}, worker, pool.size());
+                REQUIRE(std::all_of(owners.begin() + block.begin, owners.begin() + block.end,
+                                    [worker](std::size_t owner) { return owner == worker; }));
+            }
+        }
+    }
+
+    GIVEN("Per worker loop started from a worker") {
+        std::atomic<std::size_t> blocks = 0;
+        auto task = spawn([&] {
+            parallel_for(pool, 0, 300, 1, [&](std::size_t, std::size_t) { ++blocks; }, Partition::per_worker);
+        }, pool);
+        THEN("The own block runs inline and the loop finishes") {
+            task.get();
+            REQUIRE(blocks.load() == pool.size());
+        }
+    }
+
+    GIVEN("Per worker loop run by a task another worker joins") {
+        std::atomic<std::size_t> blocks = 0;
+        std::promise<void> joined;
+        // Posted and waited for with a future, so that a worker and not this thread joins
+        pool.post([&] {
+            // Stolen while the joining worker sleeps, it posts to that worker once it is blocked in get
+            auto inner = spawn([&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds{100});
+                parallel_for(pool, 0, 300, 1, [&](std::size_t, std::size_t) { ++blocks; }, Partition::per_worker);
+            }, pool);
+            std::this_thread::sleep_for(std::chrono::milliseconds{50});
+            inner.get();
+            joined.set_value();
+        });
+        THEN("The joining worker runs the block posted to it") {
+            REQUIRE(joined.get_future().wait_for(std::chrono::seconds{30}) == std::future_status::ready);
+            REQUIRE(blocks.load() == pool.size());
+        }
+    }
+
+    GIVEN("A buffer of a vector first touched by the workers") {
+        std::vector<double> buffer(1 << 20);
+        first_touch(pool, std::span<double>{buffer});
+        THEN("It's still a buffer of zeros") {
+            REQUIRE(std::ranges::all_of(buffer, [](double value) { return value == 0.; }));
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace stg::utility;
+
+struct ParallelForTestsFixture {
+    static constexpr std::size_t amount = 100'003;
+    ThreadPool pool{4};
+    std::vector<std::size_t> visits = std::vector<std::size_t>(amount, 0);
+};
+
+SCENARIO_METHOD(ParallelForTestsFixture, "Parallel for visits every index once") {
+    for (const auto partition: {Partition::static_chunks, Partition::guided}) {
+        DYNAMIC_SECTION("Partition " << static_cast<int>(partition)) {
+            std::atomic<std::size_t> chunks = 0;
+            std::atomic<std::size_t> short_chunks = 0;
+            parallel_for(pool, 0, amount, 1000, [&](std::size_t begin, std::size_t end) {
+                ++chunks;
+                if (end - begin < 1000) { ++short_chunks; }
+                for (std::size_t index = begin; index < end; ++index) {
+                    ++visits[index];
+                }
+            }, partition);
+
+            THEN("Chunks cover the range without overlaps and only the last one is shorter than the grain") {
+                REQUIRE(std::ranges::all_of(visits, [](std::size_t count) { return count == 1; }));
+                REQUIRE(chunks.load() > 1);
+                REQUIRE(short_chunks.load() <= 1);
+            }
+        }
+    }
+}
+
+SCENARIO_METHOD(ParallelForTestsFixture, "Nested parallel for runs on the same pool") {
+    parallel_for(pool, IndexRange{0, 16}, 1, [&](std::size_t outer_begin, std::size_t outer_end) {
+        for (std::size_t outer = outer_begin; outer < outer_end; ++outer) {
+            parallel_for(pool, outer * (amount / 16), (outer + 1) * (amount / 16), 64, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t index = begin; index < end; ++index) {
+                    visits[index] = index;
+                }
+            });
+        }
+    });
+
+    std::vector<std::size_t> expected(16 * (amount / 16));
+    std::iota(expected.begin(), expected.end(), 0ul);
+    REQUIRE(std::equal(expected.cbegin(), expected.cend(), visits.cbegin()));
+}
+
+SCENARIO_METHOD(ParallelForTestsFixture, "Exception of a chunk is rethrown by parallel for") {
+    REQUIRE_THROWS_AS(parallel_for(pool, 0, amount, 100, [](std::size_t begin, std::size_t end) {
+                          if (begin <= amount / 2 && amount / 2 < end) {
+                              throw std::runtime_error("Chunk failed");
+                          }
+                      }),
+                      std::runtime_error);
+
+    THEN("Pool is still usable") {
+        parallel_for(pool, 0, amount, 100, [&](std::size_t begin, std::size_t end) {
+            std::fill(visits.begin() + begin, visits.begin() + end, 1);
+        });
+        REQUIRE(std::ranges::all_of(visits, [](std::size_t count) { return count == 1; }));
+    }
+}
@@ -69,6 +69,40 @@ std::future<unsigned long long> third_test(as_coroutine) {
     co_return second_result;
 }
 
+// Resumes when input is ready and releases the next relay of the chain
+std::future<int> relay(as_coroutine, std::future<int> input, std::promise<int>& output) {
+    const int value = co_await std::move(input);
+    output.set_value(value + 1);
+    co_return value + 1;
+}
+
+SCENARIO("Awaiting a future holds no pool worker") {
+    GIVEN("More relays than pool workers suspended from a worker, the last suspended is released first") {
+        auto& pool = stg::utility::ThreadPool::global();
+        const std::size_t relays = 4 * pool.size() + 1;
+        std::vector<std::promise<int>> promises(relays + 1);
+        std::vector<std::future<int>> results(relays);
+        stg::utility::spawn([&] {
+            for (std::size_t index = relays; index-- > 0;) {
+                results[index] = relay({}, promises[index].get_future(), promises[index + 1]);
+            }
+        }).get();
+        auto last = promises[relays].get_future();
+
+        WHEN("The first relay is released") {
+            promises[0].set_value(0);
+
+            THEN("The whole chain resumes in order") {
+                REQUIRE(last.wait_for(30s) == std::future_status::ready);
+                REQUIRE(last.get() == static_cast<int>(relays));
+                for (std::size_t index = 0; index < relays; ++index) {
+                    REQUIRE(results[index].get() == static_cast<int>(index + 1));
+                }
+            }
+        }
+    }
+}
+
 SCENARIO("Coroitunes utilites tests") {
     auto exact_result = 2 * ranges::accumulate(ranges::views::iota(0ull, 10'000'000ull), 0);
 
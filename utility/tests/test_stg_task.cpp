@@ -0,0 +1,92 @@
+#include "common.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace stg::utility;
+
+namespace {
+    task<std::size_t> count_down(std::size_t n) {
+        if (n == 0) { co_return 0; }
+        co_return 1 + co_await count_down(n - 1);
+    }
+
+    task<std::size_t> square_on(ThreadPool& pool, std::size_t value) {
+        co_await schedule_on(pool);
+        co_return value * value;
+    }
+
+    task<void> fail_on(ThreadPool& pool) {
+        co_await schedule_on(pool);
+        throw std::runtime_error("Task failed");
+    }
+
+    task<std::thread::id> thread_of(ThreadPool& pool) {
+        co_await schedule_on(pool);
+        co_return std::this_thread::get_id();
+    }
+
+    task<std::size_t> pipeline(ThreadPool& pool) {
+        auto [first, second, nothing] = co_await when_all(square_on(pool, 3), square_on(pool, 4),
+                                                          async([] {}, pool));
+        std::vector<task<std::size_t>> squares;
+        for (std::size_t index = 0; index < 16; ++index) {
+            squares.push_back(square_on(pool, index));
+        }
+        std::size_t sum = first + second;
+        for (const std::size_t square: co_await when_all(std::move(squares))) {
+            sum += square;
+        }
+        co_return sum;
+    }
+
+    std::future<int> from_future(as_coroutine) {
+        const int first = co_await std::async(std::launch::async, [] { return 20; });
+        const int second = co_await std::async(std::launch::async, [] { return 22; });
+        co_return first + second;
+    }
+}// namespace
+
+SCENARIO("Coroutine tasks on the thread pool") {
+    ThreadPool pool{2};
+
+    GIVEN("A deep chain of synchronously finishing tasks") {
+        THEN("The results are handed back along the chain") {
+            REQUIRE(sync_wait(count_down(10'000)) == 10'000);
+        }
+    }
+
+    GIVEN("A pipeline fanning out with when_all") {
+        THEN("The results are gathered") {
+            REQUIRE(sync_wait(pipeline(pool)) == 3 * 3 + 4 * 4 + 1240);
+        }
+    }
+
+    GIVEN("A task scheduled on the pool") {
+        THEN("It is resumed on a pool thread") {
+            REQUIRE(sync_wait(thread_of(pool)) != std::this_thread::get_id());
+        }
+    }
+
+    GIVEN("Failing tasks") {
+        THEN("The exception reaches the awaiter") {
+            REQUIRE_THROWS_AS(sync_wait(fail_on(pool)), std::runtime_error);
+            REQUIRE_THROWS_AS(sync_wait(when_all(square_on(pool, 2), fail_on(pool))), std::runtime_error);
+
+            std::vector<task<void>> failing;
+            failing.push_back(fail_on(pool));
+            failing.push_back(async([] {}, pool));
+            REQUIRE_THROWS_AS(sync_wait(when_all(std::move(failing))), std::runtime_error);
+        }
+    }
+
+    GIVEN("A std::future based coroutine") {
+        THEN("The futures are awaited on the global pool") {
+            REQUIRE(from_future({}).get() == 42);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace stg::utility;
+
+SCENARIO("Stages run in the order of their data") {
+    ThreadPool pool{4};
+
+    GIVEN("A chain of writers and readers of the same data") {
+        TaskGraph graph{pool};
+        std::mutex mutex;
+        std::vector<std::string> order;
+        const auto stage = [&](std::string name) {
+            return [&, name] { std::lock_guard lock{mutex}; order.push_back(name); };
+        };
+        graph.add("spectra", {.outputs = {"spectra"}}, stage("spectra"));
+        graph.add("amplitudes", {.outputs = {"amplitudes"}}, stage("amplitudes"));
+        graph.add("generators", {.inputs = {"spectra", "amplitudes"}, .outputs = {"generators"}}, stage("generators"));
+        graph.add("field", {.inputs = {"generators"}, .outputs = {"field"}}, stage("field"));
+        graph.add("save", {.inputs = {"field"}}, stage("save"));
+        graph.add("field again", {.inputs = {"generators"}, .outputs = {"field"}}, stage("field again"));
+        graph.run();
+
+        THEN("Every stage follows the stages it depends on") {
+            const auto position = [&](const std::string& name) { return std::ranges::find(order, name) - order.begin(); };
+            REQUIRE(order.size() == graph.size());
+            REQUIRE(position("generators") > position("spectra"));
+            REQUIRE(position("generators") > position("amplitudes"));
+            REQUIRE(position("field") > position("generators"));
+            REQUIRE(position("save") > position("field"));
+            REQUIRE(position("field again") > position("save"));
+        }
+
+        THEN("Every stage has its timing") {
+            const auto timings = graph.timings();
+            REQUIRE(timings.size() == graph.size());
+            REQUIRE(timings[4].name == "save");
+            REQUIRE(timings[4].start >= timings[3].start + timings[3].duration);
+        }
+    }
+
+    GIVEN("Writing a buffer while the other one is filled") {
+        TaskGraph graph{pool};
+        std::atomic<std::size_t> running = 0, overlapped = 0;
+        const auto stage = [&] {
+            if (++running > 1) { ++overlapped; }
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            --running;
+        };
+        for (std::size_t sample = 0; sample < 4; ++sample) {
+            const std::string buffer = "field " + std::to_string(sample % 2);
+            graph.add("generate", {.inputs = {"generator"}, .outputs = {buffer}}, stage);
+            graph.add("save", {.inputs = {buffer}, .outputs = {"file"}}, stage);
+        }
+        graph.run();
+
+        THEN("The save of a sample overlaps the generation of the next one") {
+            REQUIRE(overlapped.load() > 0);
+        }
+    }
+
+    GIVEN("A failing stage") {
+        TaskGraph graph{pool};
+        bool after_failure = false;
+        graph.add("fail", {.outputs = {"data"}}, [] { throw std::runtime_error("Stage failed"); });
+        graph.add("after", {.inputs = {"data"}}, [&] { after_failure = true; });
+
+        THEN("The run rethrows and the dependent stages are skipped") {
+            REQUIRE_THROWS_AS(graph.run(), std::runtime_error);
+            REQUIRE_FALSE(after_failure);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace stg::utility;
+
+namespace {
+    // Naive recursive fibonacci forking both halves, a stress for nested fork/join
+    std::size_t fibonacci(ThreadPool& pool, std::size_t n) {
+        if (n < 2) { return n; }
+        if (n < 12) { return fibonacci(pool, n - 1) + fibonacci(pool, n - 2); }
+        std::size_t first = 0;
+        TaskGroup group{pool};
+        group.spawn([&] { first = fibonacci(pool, n - 1); });
+        const std::size_t second = fibonacci(pool, n - 2);
+        group.sync();
+        return first + second;
+    }
+}// namespace
+
+SCENARIO("Nested fork/join on a small work stealing pool") {
+    ThreadPool pool{2};
+    REQUIRE(fibonacci(pool, 25) == 75025);
+
+    THEN("Nested work doesn't create threads beyond the pool") {
+        std::atomic<std::size_t> tasks = 0;
+        std::vector<std::thread::id> threads(64);
+        TaskGroup outer{pool};
+        for (std::size_t index = 0; index < 8; ++index) {
+            outer.spawn([&, index] {
+                TaskGroup inner{pool};
+                for (std::size_t nested = 0; nested < 8; ++nested) {
+                    inner.spawn([&, index, nested] {
+                        threads[index * 8 + nested] = std::this_thread::get_id();
+                        ++tasks;
+                    });
+                }
+                inner.sync();
+            });
+        }
+        outer.sync();
+        REQUIRE(tasks.load() == 64);
+
+        std::ranges::sort(threads);
+        const auto distinct = std::distance(threads.begin(), std::unique(threads.begin(), threads.end()));
+        REQUIRE(distinct <= 3);
+    }
+}
+
+SCENARIO("Task group and spawned tasks propagate exceptions") {
+    ThreadPool pool{3};
+
+    GIVEN("Group with one failing task") {
+        std::atomic<std::size_t> finished = 0;
+        TaskGroup group{pool};
+        for (std::size_t index = 0; index < 16; ++index) {
+            group.spawn([&, index] {
+                if (index == 7) { throw std::runtime_error("Task failed"); }
+                ++finished;
+            });
+        }
+        THEN("Sync waits for the other tasks and rethrows") {
+            REQUIRE_THROWS_AS(group.sync(), std::runtime_error);
+            REQUIRE(finished.load() == 15);
+            REQUIRE_NOTHROW(group.sync());
+        }
+    }
+
+    GIVEN("Spawned tasks") {
+        auto value = spawn([] { return 42; }, pool);
+        auto failed = spawn([]() -> int { throw std::logic_error("Spawned task failed"); }, pool);
+        THEN("Get returns the value or rethrows") {
+            REQUIRE(value.get() == 42);
+            REQUIRE_THROWS_AS(failed.get(), std::logic_error);
+        }
+    }
+}
@@ -4,6 +4,7 @@
 #include "velocity_field/ivelocity_field.hpp"
 #include "velocity_field/velocity_field.hpp"
 #include "velocity_field/velocity_samples.hpp"
+#include "velocity_field/vertex_major_samples.hpp"
 #include "velocity_field/concepts.hpp"
 
 #endif //STG_VELOCITY_FIELD_HPP
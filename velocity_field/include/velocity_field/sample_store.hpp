@@ -0,0 +1,302 @@
+#ifndef STG_SAMPLE_STORE_HPP
+#define STG_SAMPLE_STORE_HPP
+
+#include "velocity_field.hpp"
+#include "velocity_samples.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fmt/format.h>
+#include <memory>
+#include <mesh_builders/mesh_builders.hpp>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <vtk_parser/mapped_file.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*
+ * Ensemble of velocity samples in one binary file:
+ *
+ * [ header: 64 bytes ]
+ * [ sample 0: vx[vertices] vy[vertices] vz[vertices] ]
+ * [ sample 1: ... ]
+ *
+ * The values are float32 or float64 in the byte order of the machine that wrote them,
+ * the header names the cube mesh (vertices per edge and edge length) and the number of
+ * complete samples. So the samples are appended while they are generated and a vertex
+ * range of a sample is three contiguous ranges of the file, read from the memory map
+ * with no parsing
+ */
+
+namespace stg::field {
+
+    enum class SamplePrecision {
+        float32,
+        float64
+    };
+
+    namespace detail {
+        inline constexpr std::array<char, 8> sample_store_magic{'S', 'T', 'G', 'S', 'M', 'P', 'L', '1'};
+        inline constexpr std::uint32_t sample_store_byte_order = 0x01020304;
+
+        struct SampleStoreHeader {
+            std::array<char, 8> magic = sample_store_magic;
+            std::uint32_t byte_order = sample_store_byte_order;
+            std::uint32_t value_size = sizeof(double);
+            std::uint64_t n = 0;// vertices per edge
+            double length = 0.;
+            std::uint64_t vertices = 0;
+            std::uint64_t samples = 0;
+            std::array<std::uint64_t, 2> reserved{};
+        };
+        static_assert(sizeof(SampleStoreHeader) == 64);
+
+        inline std::size_t sample_bytes(const SampleStoreHeader& header) noexcept {
+            return 3 * header.vertices * header.value_size;
+        }
+
+        inline void check_header(const SampleStoreHeader& header, std::string_view filename) {
+            if (header.magic != sample_store_magic) {
+                throw std::runtime_error(fmt::format("{} isn't a sample store", filename));
+            }
+            if (header.byte_order != sample_store_byte_order) {
+                throw std::runtime_error(fmt::format("{} is written with another byte order", filename));
+            }
+            if (header.value_size != sizeof(float) && header.value_size != sizeof(double)) {
+                throw std::runtime_error(fmt::format("{} has values of {} bytes", filename, header.value_size));
+            }
+        }
+    }// namespace detail
+
+    /*
+     * Appends the samples to a store: the values are written first, then the number of
+     * samples in the header, so a reader never sees a partial sample. The appends are
+     * serialized, they may come from several workers
+     */
+    template<std::floating_point T>
+    class SampleStoreWriter final {
+    public:
+        using value_type = T;
+
+        // Creates the store of the cube mesh, an existing file is truncated
+        SampleStoreWriter(const std::filesystem::path& path, std::size_t n, double length,
+                          SamplePrecision precision = SamplePrecision::float64)
+            : filename_{path.string()}, descriptor_{open(path, O_RDWR | O_CREAT | O_TRUNC)} {
+            header_.n = n;
+            header_.length = length;
+            header_.vertices = n * n * n;
+            header_.value_size = precision == SamplePrecision::float32 ? sizeof(float) : sizeof(double);
+            write_at(&header_, sizeof(header_), 0);
+        }
+
+        // Opens an existing store to append to
+        explicit SampleStoreWriter(const std::filesystem::path& path)
+            : filename_{path.string()}, descriptor_{open(path, O_RDWR)} {
+            try {
+                read_at(&header_, sizeof(header_), 0);
+                detail::check_header(header_, filename_);
+            } catch (...) {
+                ::close(descriptor_);
+                throw;
+            }
+        }
+
+        SampleStoreWriter(const SampleStoreWriter&) = delete;
+        SampleStoreWriter& operator=(const SampleStoreWriter&) = delete;
+
+        ~SampleStoreWriter() { ::close(descriptor_); }
+
+        // Index of the sample appended
+        std::size_t append(std::span<const value_type> vx, std::span<const value_type> vy, std::span<const value_type> vz) {
+            if (vx.size() != header_.vertices || vy.size() != header_.vertices || vz.size() != header_.vertices) {
+                throw std::invalid_argument(fmt::format("Sample must have {} vertices", header_.vertices));
+            }
+            std::lock_guard lock{mutex_};
+            const std::size_t sample = header_.samples;
+            std::size_t offset = sizeof(header_) + sample * detail::sample_bytes(header_);
+            for (const auto component: {vx, vy, vz}) {
+                offset += header_.value_size == sizeof(float) ? write_values<float>(component, offset)
+                                                              : write_values<double>(component, offset);
+            }
+            ++header_.samples;
+            write_at(&header_.samples, sizeof(header_.samples), offsetof(detail::SampleStoreHeader, samples));
+            return sample;
+        }
+
+        std::size_t append(const VelocityField<value_type>& field) {
+            return append(field.component(0), field.component(1), field.component(2));
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            std::lock_guard lock{mutex_};
+            return header_.samples;
+        }
+
+        [[nodiscard]] std::size_t vertices() const noexcept { return header_.vertices; }
+
+    private:
+        static constexpr std::size_t block_values = std::size_t{1} << 16;
+
+        std::string filename_;
+        int descriptor_;
+        detail::SampleStoreHeader header_;
+        mutable std::mutex mutex_;
+
+        static int open(const std::filesystem::path& path, int flags) {
+            const int descriptor = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+            if (descriptor < 0) {
+                throw std::system_error(errno, std::generic_category(), "Can't open " + path.string());
+            }
+            return descriptor;
+        }
+
+        void write_at(const void* data, std::size_t size, std::size_t offset) const {
+            const auto* bytes = static_cast<const char*>(data);
+            while (size != 0) {
+                const auto written = ::pwrite(descriptor_, bytes, size, static_cast<off_t>(offset));
+                if (written < 0) {
+                    if (errno == EINTR) { continue; }
+                    throw std::system_error(errno, std::generic_category(), "Can't write " + filename_);
+                }
+                bytes += written;
+                offset += static_cast<std::size_t>(written);
+                size -= static_cast<std::size_t>(written);
+            }
+        }
+
+        void read_at(void* data, std::size_t size, std::size_t offset) const {
+            const auto read = ::pread(descriptor_, data, size, static_cast<off_t>(offset));
+            if (read != static_cast<ssize_t>(size)) {
+                throw std::runtime_error(fmt::format("{} has no sample store header", filename_));
+            }
+        }
+
+        // Bytes written, the values are converted in blocks if the precision differs
+        template<typename Stored>
+        std::size_t write_values(std::span<const value_type> values, std::size_t offset) const {
+            if constexpr (std::same_as<Stored, value_type>) {
+                write_at(values.data(), values.size_bytes(), offset);
+            } else {
+                std::vector<Stored> block(std::min(block_values, values.size()));
+                for (std::size_t begin = 0; begin < values.size(); begin += block.size()) {
+                    const std::size_t count = std::min(block.size(), values.size() - begin);
+                    std::transform(values.begin() + begin, values.begin() + begin + count, block.begin(),
+                                   [](value_type value) { return static_cast<Stored>(value); });
+                    write_at(block.data(), count * sizeof(Stored), offset + begin * sizeof(Stored));
+                }
+            }
+            return values.size() * sizeof(Stored);
+        }
+    };
+
+    /*
+     * Read access to a store through a memory map: only the pages of the vertex ranges
+     * read are loaded. The samples appended after the open are seen after refresh
+     */
+    template<std::floating_point T>
+    class SampleStore final {
+    public:
+        using value_type = T;
+
+        explicit SampleStore(const std::filesystem::path& path)
+            : path_{path} {
+            refresh();
+        }
+
+        // Maps the file again with the samples appended since
+        void refresh() {
+            file_ = mesh::MappedFile{path_, MADV_RANDOM};
+            const auto bytes = file_.view();
+            if (bytes.size() < sizeof(header_)) {
+                throw std::runtime_error(fmt::format("{} has no sample store header", path_.string()));
+            }
+            std::memcpy(&header_, bytes.data(), sizeof(header_));
+            detail::check_header(header_, path_.string());
+            const std::size_t sample_bytes = detail::sample_bytes(header_);
+            const std::size_t complete = sample_bytes == 0 ? 0 : (bytes.size() - sizeof(header_)) / sample_bytes;
+            samples_ = std::min<std::size_t>(header_.samples, complete);
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return samples_; }
+
+        [[nodiscard]] std::size_t vertices() const noexcept { return header_.vertices; }
+
+        [[nodiscard]] SamplePrecision precision() const noexcept {
+            return header_.value_size == sizeof(float) ? SamplePrecision::float32 : SamplePrecision::float64;
+        }
+
+        std::shared_ptr<mesh::CubeFiniteElementsMesh<value_type>> mesh() const {
+            mesh::CubeMeshBuilder<value_type> builder{static_cast<value_type>(header_.length), header_.n};
+            return builder.build();
+        }
+
+        // Vertices [begin, begin + vx.size()) of the sample isample
+        void read(std::size_t isample, std::size_t begin,
+                  std::span<value_type> vx, std::span<value_type> vy, std::span<value_type> vz) const {
+            const std::size_t count = vx.size();
+            if (isample >= samples_ || begin + count > header_.vertices || vy.size() != count || vz.size() != count) {
+                throw std::out_of_range(fmt::format("Sample {} vertices [{}, {}) are out of the store", isample, begin, begin + count));
+            }
+            const std::array<std::span<value_type>, 3> components{vx, vy, vz};
+            for (std::size_t axis = 0; axis < components.size(); ++axis) {
+                const std::size_t first = (isample * 3 + axis) * header_.vertices + begin;
+                if (header_.value_size == sizeof(float)) {
+                    copy_values<float>(first, components[axis]);
+                } else {
+                    copy_values<double>(first, components[axis]);
+                }
+            }
+        }
+
+        VelocityField<value_type> sample(std::size_t isample) const {
+            std::vector<value_type> vx(header_.vertices), vy(header_.vertices), vz(header_.vertices);
+            read(isample, 0, vx, vy, vz);
+            return VelocityField<value_type>{std::move(vx), std::move(vy), std::move(vz)};
+        }
+
+        // The samples [first, first + count)
+        VelocitySamples<value_type> samples(std::size_t first, std::size_t count) const {
+            std::vector<VelocityField<value_type>> fields;
+            fields.reserve(count);
+            for (std::size_t isample = first; isample < first + count; ++isample) {
+                fields.push_back(sample(isample));
+            }
+            return VelocitySamples<value_type>{std::move(fields)};
+        }
+
+        VelocitySamples<value_type> samples() const { return samples(0, samples_); }
+
+    private:
+        std::filesystem::path path_;
+        mesh::MappedFile file_;
+        detail::SampleStoreHeader header_;
+        std::size_t samples_ = 0;
+
+        template<typename Stored>
+        void copy_values(std::size_t first, std::span<value_type> values) const {
+            const char* const data = file_.view().data() + sizeof(header_) + first * sizeof(Stored);
+            if constexpr (std::same_as<Stored, value_type>) {
+                std::memcpy(values.data(), data, values.size_bytes());
+            } else {
+                for (std::size_t index = 0; index < values.size(); ++index) {
+                    Stored value;
+                    std::memcpy(&value, data + index * sizeof(Stored), sizeof(Stored));
+                    values[index] = static_cast<value_type>(value);
+                }
+            }
+        }
+    };
+}// namespace stg::field
+
+#endif//STG_SAMPLE_STORE_HPP
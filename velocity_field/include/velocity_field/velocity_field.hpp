@@ -4,20 +4,71 @@
 #include "concepts.hpp"
 #include "ivelocity_field.hpp"
 #include <geometry/geometry.hpp>
-#include <mutex>
 #include <range/v3/all.hpp>
 #include <range/v3/range/conversion.hpp>
 #include <range/v3/view/transform.hpp>
+#include <cassert>
+#include <span>
+#include <stdexcept>
 #include <vector>
 
 namespace stg::field {
     namespace rv = ranges::views;
 
+    /*
+     * Velocity components stored as separate arrays. The size is fixed between resizes,
+     * so the writes to distinct indices never race and need no locking
+     */
     template<std::floating_point T>
     class VelocityField final : IVelocityField<T> {
     public:
         using value_type = T;
 
+        /*
+         * Handle writing the vertices [begin, end) of a field. Handles of disjoint ranges
+         * can be used from different threads at once, the indices are the field indices
+         * and are asserted to lie in the range
+         */
+        class Writer final {
+        public:
+            [[nodiscard]] std::size_t begin() const noexcept { return begin_; }
+
+            [[nodiscard]] std::size_t end() const noexcept { return end_; }
+
+            [[nodiscard]] std::size_t size() const noexcept { return end_ - begin_; }
+
+            void set_value(Vector<value_type> value, std::size_t index) noexcept {
+                set_value(value.template get<0>(), value.template get<1>(), value.template get<2>(), index);
+            }
+
+            void set_value(value_type vx, value_type vy, value_type vz, std::size_t index) noexcept {
+                assert(begin_ <= index && index < end_);
+                vx_[index] = vx;
+                vy_[index] = vy;
+                vz_[index] = vz;
+            }
+
+            // Writes values to [first, first + values.size())
+            void set_values(std::size_t first, std::span<const Vector<value_type>> values) noexcept {
+                assert(begin_ <= first && first <= end_ && values.size() <= end_ - first);
+                for (std::size_t index = 0; index < values.size(); ++index) {
+                    set_value(values[index], first + index);
+                }
+            }
+
+        private:
+            friend class VelocityField;
+
+            Writer(VelocityField& field, std::size_t begin, std::size_t end) noexcept
+                : vx_{field.vx_.data()}, vy_{field.vy_.data()}, vz_{field.vz_.data()}, begin_{begin}, end_{end} {}
+
+            value_type* vx_;
+            value_type* vy_;
+            value_type* vz_;
+            std::size_t begin_;
+            std::size_t end_;
+        };
+
         VelocityField() = default;
 
         explicit VelocityField(std::size_t nvert)
@@ -69,12 +120,21 @@ namespace stg::field {
 
         auto values_view() const { return ranges::views::zip(vx_, vy_, vz_); }
 
+        // Component array, 0 is vx, 1 is vy and 2 is vz
+        std::span<const value_type> component(std::size_t axis) const {
+            switch (axis) {
+                case 0: return vx_;
+                case 1: return vy_;
+                case 2: return vz_;
+                default: throw std::out_of_range("Velocity has 3 components");
+            }
+        }
+
         Vector<value_type> value(std::size_t index) const {
             return {vx_[index], vy_[index], vz_[index]};
         }
 
         void set_value(Vector<value_type> value, std::size_t index) {
-            std::lock_guard lg{mutex_};
             const value_type x = value.template get<0>();
             const value_type y = value.template get<1>();
             const value_type z = value.template get<2>();
@@ -85,13 +145,41 @@ namespace stg::field {
         }
 
         void set_value(value_type vx, value_type vy, value_type vz, std::size_t index) {
-            std::lock_guard lg{mutex_};
-
             vx_[index] = vx;
             vy_[index] = vy;
             vz_[index] = vz;
         }
 
+        /*
+         * Writes values to [first, first + values.size()) without locking, concurrent
+         * calls are safe as long as their index ranges don't overlap
+         */
+        void set_values(std::size_t first, std::span<const Vector<value_type>> values) noexcept {
+            assert(first <= size() && values.size() <= size() - first);
+            Writer{*this, first, first + values.size()}.set_values(first, values);
+        }
+
+        // Writer of [begin, end), invalidated by resize
+        Writer writer(std::size_t begin, std::size_t end) {
+            if (begin > end || end > size()) {
+                throw std::out_of_range("Writer range is out of the velocity field");
+            }
+            return Writer{*this, begin, end};
+        }
+
+        Writer writer() { return Writer{*this, 0, size()}; }
+
+        /*
+         * Calls function with the span of every component array, a hook for the
+         * memory placement (e.g. utility::first_touch)
+         */
+        template<std::invocable<std::span<value_type>> Function>
+        void for_each_buffer(Function&& function) {
+            function(std::span<value_type>{vx_});
+            function(std::span<value_type>{vy_});
+            function(std::span<value_type>{vz_});
+        }
+
         [[nodiscard]] bool empty() const {
             return vx_.empty() && vy_.empty() && vz_.empty();
         }
@@ -106,8 +194,6 @@ namespace stg::field {
         std::vector<value_type> vx_;
         std::vector<value_type> vy_;
         std::vector<value_type> vz_;
-
-        std::mutex mutex_;
     };
 }// namespace stg::field
 
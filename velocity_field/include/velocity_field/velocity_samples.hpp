@@ -18,6 +18,9 @@
  * ]
  *
  * Can take views on { Field_1{vx[ivert], Field_2{vx[ivert], ... }
+ *
+ * All the samples are allocated up front by the sized constructor, the generating
+ * workers fill them in place through the writers of disjoint (sample, vertices) blocks
  */
 
 namespace stg::field {
@@ -34,6 +37,8 @@ namespace stg::field {
             }
         }
 
+        using Writer = typename VelocityField<value_type>::Writer;
+
         VelocitySamples(std::vector<VelocityField<T>> samples)
             : velocity_samples_{std::move(samples)} {}
 
@@ -77,6 +82,26 @@ namespace stg::field {
             return velocity_samples_[isample];
         }
 
+        /*
+         * Writer of the vertices [begin, end) of the sample isample, the writers of
+         * disjoint blocks need no synchronization
+         */
+        Writer writer(std::size_t isample, std::size_t begin, std::size_t end) {
+            return velocity_samples_.at(isample).writer(begin, end);
+        }
+
+        Writer writer(std::size_t isample) {
+            return velocity_samples_.at(isample).writer();
+        }
+
+        // VelocityField::for_each_buffer of every sample
+        template<std::invocable<std::span<value_type>> Function>
+        void for_each_buffer(Function&& function) {
+            for (auto& field: velocity_samples_) {
+                field.for_each_buffer(function);
+            }
+        }
+
         void set_sample(VelocityField<value_type> sample, std::size_t isample) {
             velocity_samples_[isample] = std::move(sample);
         }
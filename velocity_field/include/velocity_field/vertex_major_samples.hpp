@@ -0,0 +1,110 @@
+#ifndef STG_VERTEX_MAJOR_SAMPLES_HPP
+#define STG_VERTEX_MAJOR_SAMPLES_HPP
+
+#include "velocity_samples.hpp"
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <stg_thread_pool/parallel_for.hpp>
+#include <vector>
+
+/*
+ * Transposed layout of VelocitySamples:
+ *
+ * vx [ vertex 0: sample 0, sample 1, ... | vertex 1: sample 0, sample 1, ... | ... ]
+ * vy [ ... ]
+ * vz [ ... ]
+ *
+ * The ensemble of a vertex is contiguous, so the statistics of a vertex stream it with
+ * unit stride instead of gathering one value from every sample field
+ */
+
+namespace stg::field {
+
+    template<std::floating_point T>
+    class VertexMajorSamples final {
+    public:
+        using value_type = T;
+
+        // Side of the square tiles of the transpose, a tile of every component stays in L1
+        static constexpr std::size_t tile = 64;
+
+        VertexMajorSamples(std::size_t samples_amount, std::size_t vertices_amount)
+            : samples_{samples_amount}, vertices_{vertices_amount} {
+            for (auto& component: components_) {
+                component.resize(samples_amount * vertices_amount);
+            }
+        }
+
+        /*
+         * Blocked transpose of the samples: the vertex tiles are spread over the global pool,
+         * a tile reads tile-long runs of every sample and writes tile-long runs of every vertex
+         */
+        explicit VertexMajorSamples(const VelocitySamples<value_type>& samples)
+            : VertexMajorSamples(samples.size(), samples.size() == 0 ? 0 : samples.sample(0).size()) {
+            for (std::size_t isample = 0; isample < samples_; ++isample) {
+                if (samples.sample(isample).size() != vertices_) {
+                    throw std::invalid_argument("Samples must have the same number of vertices");
+                }
+            }
+            const std::size_t tiles = (vertices_ + tile - 1) / tile;
+            utility::parallel_for(utility::ThreadPool::global(), 0, tiles, 1, [this, &samples](std::size_t tiles_begin, std::size_t tiles_end) {
+                for (std::size_t itile = tiles_begin; itile < tiles_end; ++itile) {
+                    const std::size_t vertices_begin = itile * tile;
+                    const std::size_t vertices_end = std::min(vertices_, vertices_begin + tile);
+                    for (std::size_t samples_begin = 0; samples_begin < samples_; samples_begin += tile) {
+                        const std::size_t samples_end = std::min(samples_, samples_begin + tile);
+                        for (std::size_t axis = 0; axis < components_.size(); ++axis) {
+                            value_type* const destination = components_[axis].data();
+                            for (std::size_t isample = samples_begin; isample < samples_end; ++isample) {
+                                const auto source = samples.sample(isample).component(axis);
+                                for (std::size_t ivert = vertices_begin; ivert < vertices_end; ++ivert) {
+                                    destination[ivert * samples_ + isample] = source[ivert];
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        std::span<const value_type> vx_component_for_vertex(std::size_t ivert) const { return component_for_vertex(0, ivert); }
+
+        std::span<const value_type> vy_component_for_vertex(std::size_t ivert) const { return component_for_vertex(1, ivert); }
+
+        std::span<const value_type> vz_component_for_vertex(std::size_t ivert) const { return component_for_vertex(2, ivert); }
+
+        // Ensemble of the component axis (0 is vx) at the vertex ivert
+        std::span<const value_type> component_for_vertex(std::size_t axis, std::size_t ivert) const {
+            return std::span<const value_type>{components_[axis]}.subspan(ivert * samples_, samples_);
+        }
+
+        std::span<value_type> component_for_vertex(std::size_t axis, std::size_t ivert) {
+            return std::span<value_type>{components_[axis]}.subspan(ivert * samples_, samples_);
+        }
+
+        void set_value(std::size_t isample, std::size_t ivert, value_type vx, value_type vy, value_type vz) {
+            const std::size_t index = ivert * samples_ + isample;
+            components_[0][index] = vx;
+            components_[1][index] = vy;
+            components_[2][index] = vz;
+        }
+
+        Vector<value_type> value(std::size_t isample, std::size_t ivert) const {
+            const std::size_t index = ivert * samples_ + isample;
+            return {components_[0][index], components_[1][index], components_[2][index]};
+        }
+
+        std::size_t size() const noexcept { return samples_; }
+
+        std::size_t vertices() const noexcept { return vertices_; }
+
+    private:
+        std::size_t samples_;
+        std::size_t vertices_;
+        std::array<std::vector<value_type>, 3> components_;
+    };
+}// namespace stg::field
+
+#endif//STG_VERTEX_MAJOR_SAMPLES_HPP
@@ -9,7 +9,10 @@
 #include <catch2/matchers/catch_matchers_container_properties.hpp>
 #include <fem.hpp>
 #include <geometry/geometry.hpp>
+#include <thread>
 #include <velocity_field/velocity_field.hpp>
+#include <velocity_field/velocity_samples.hpp>
+#include <velocity_field/vertex_major_samples.hpp>
 
 using namespace stg;
 using namespace stg::mesh;
@@ -35,4 +35,74 @@ TEST_CASE("Create velocity field and check public methods", "[VelocityField]") {
   CHECK_THAT(third_value.get<0>(), WithinRel(3, eps));
   CHECK_THAT(third_value.get<1>(), WithinRel(3, eps));
   CHECK_THAT(third_value.get<2>(), WithinRel(3, eps));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Write a slice of velocity field", "[VelocityField]") {
+  VelocityField<double> test_field{5};
+  const std::vector<Vector<double>> slice{{1, 2, 3}, {4, 5, 6}};
+
+  test_field.set_values(2, slice);
+
+  CHECK_THAT(test_field.value(1).get<0>(), WithinAbs(0, eps));
+  CHECK_THAT(test_field.value(2).get<1>(), WithinRel(2, eps));
+  CHECK_THAT(test_field.value(3).get<0>(), WithinRel(4, eps));
+  CHECK_THAT(test_field.value(3).get<2>(), WithinRel(6, eps));
+  CHECK_THAT(test_field.value(4).get<2>(), WithinAbs(0, eps));
+}
+
+TEST_CASE("Fill preallocated samples through writers", "[VelocitySamples]") {
+  constexpr std::size_t samples = 8;
+  constexpr std::size_t vertices = 1000;
+  constexpr std::size_t block = 250;
+  VelocitySamples<double> test_samples{samples, vertices};
+
+  REQUIRE_THROWS_AS(test_samples.writer(0, 900, 1001), std::out_of_range);
+
+  {
+    std::vector<std::jthread> workers;
+    for (std::size_t isample = 0; isample < samples; ++isample) {
+      for (std::size_t begin = 0; begin < vertices; begin += block) {
+        workers.emplace_back([writer = test_samples.writer(isample, begin, begin + block), isample]() mutable {
+          for (std::size_t ivert = writer.begin(); ivert < writer.end(); ++ivert) {
+            writer.set_value(isample, ivert, 1., ivert);
+          }
+        });
+      }
+    }
+  }
+
+  for (std::size_t isample = 0; isample < samples; ++isample) {
+    for (std::size_t ivert = 0; ivert < vertices; ivert += 97) {
+      const auto value = test_samples.sample(isample).value(ivert);
+      CHECK_THAT(value.get<0>(), WithinAbs(isample, eps));
+      CHECK_THAT(value.get<1>(), WithinAbs(ivert, eps));
+    }
+  }
+}
+
+TEST_CASE("Transpose samples to the vertex-major layout", "[VertexMajorSamples]") {
+  constexpr std::size_t samples = 70;
+  constexpr std::size_t vertices = 130;
+  VelocitySamples<double> test_samples{samples, vertices};
+  for (std::size_t isample = 0; isample < samples; ++isample) {
+    for (std::size_t ivert = 0; ivert < vertices; ++ivert) {
+      test_samples.sample(isample).set_value(isample, ivert, -1. * isample * ivert, ivert);
+    }
+  }
+
+  const VertexMajorSamples<double> transposed{test_samples};
+  REQUIRE(transposed.size() == samples);
+  REQUIRE(transposed.vertices() == vertices);
+
+  for (const std::size_t ivert: {0ull, 63ull, 64ull, 129ull}) {
+    const auto vx = transposed.vx_component_for_vertex(ivert);
+    const auto vy = transposed.vy_component_for_vertex(ivert);
+    const auto vz = transposed.vz_component_for_vertex(ivert);
+    REQUIRE(vx.size() == samples);
+    for (std::size_t isample = 0; isample < samples; ++isample) {
+      CHECK(vx[isample] == isample);
+      CHECK(vy[isample] == ivert);
+      CHECK(vz[isample] == -1. * isample * ivert);
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#include "common.hpp"
+#include <filesystem>
+#include <fstream>
+#include <velocity_field/sample_store.hpp>
+
+namespace {
+  VelocityField<double> make_sample(std::size_t isample, std::size_t vertices) {
+    std::vector<double> vx(vertices), vy(vertices), vz(vertices);
+    for (std::size_t ivert = 0; ivert < vertices; ++ivert) {
+      vx[ivert] = static_cast<double>(isample) + 0.5;
+      vy[ivert] = static_cast<double>(ivert);
+      vz[ivert] = -static_cast<double>(isample * vertices + ivert);
+    }
+    return VelocityField<double>{std::move(vx), std::move(vy), std::move(vz)};
+  }
+}
+
+TEST_CASE("Append samples to a store and read vertex ranges", "[SampleStore]") {
+  constexpr std::size_t n = 6;
+  constexpr std::size_t vertices = n * n * n;
+  const std::filesystem::path filename = "tests_samples.stgs";
+
+  SampleStoreWriter<double> writer{filename, n, 2.};
+  writer.append(make_sample(0, vertices));
+  writer.append(make_sample(1, vertices));
+
+  SampleStore<double> store{filename};
+  REQUIRE(store.size() == 2);
+  REQUIRE(store.vertices() == vertices);
+  CHECK(store.mesh()->n_vertices() == vertices);
+  REQUIRE_THROWS_AS(store.sample(2), std::out_of_range);
+
+  std::vector<double> vx(10), vy(10), vz(10);
+  store.read(1, 100, vx, vy, vz);
+  CHECK(vx.front() == 1.5);
+  CHECK(vy.back() == 109.);
+  CHECK(vz.front() == -static_cast<double>(vertices + 100));
+
+  writer.append(make_sample(2, vertices));
+  CHECK(store.size() == 2);
+  store.refresh();
+  REQUIRE(store.size() == 3);
+
+  const auto samples = SampleStore<double>{filename}.samples();
+  REQUIRE(samples.size() == 3);
+  CHECK(samples.sample(2).value(vertices - 1).get<2>() == -static_cast<double>(3 * vertices - 1));
+}
+
+TEST_CASE("Store samples in single precision and append later", "[SampleStore]") {
+  constexpr std::size_t n = 4;
+  constexpr std::size_t vertices = n * n * n;
+  const std::filesystem::path filename = "tests_samples_float.stgs";
+  {
+    SampleStoreWriter<double> writer{filename, n, 1., SamplePrecision::float32};
+    writer.append(make_sample(0, vertices));
+  }
+  SampleStoreWriter<double>{filename}.append(make_sample(1, vertices));
+
+  REQUIRE(std::filesystem::file_size(filename) == 64 + 2 * 3 * vertices * sizeof(float));
+  SampleStore<float> store{filename};
+  REQUIRE(store.precision() == SamplePrecision::float32);
+  REQUIRE(store.size() == 2);
+  CHECK(store.sample(1).value(3).get<0>() == 1.5f);
+
+  {
+    std::ofstream file{"tests_not_a_store.stgs"};
+    file << std::string(100, 'x');
+  }
+  REQUIRE_THROWS_AS(SampleStore<double>{"tests_not_a_store.stgs"}, std::runtime_error);
+}